@@ -0,0 +1,840 @@
+// Microbenchmarks for hot paths that are too small to show up in whole-frame
+// timings.
+//
+//   workouttracker_bench [--iterations N] [BENCHMARK...]
+//
+//   --iterations N  passes over each benchmark's input (default 2000)
+//   BENCHMARK       run only the named benchmarks; all of them by default
+//
+// Benchmarks:
+//   glyphs   code point -> glyph lookup: the old ASCII if/else chain against
+//            the page table, on ASCII and on UTF-8 Cyrillic text
+//   layout   relayout of a column of exercise cards: everything, one card
+//            changing inside, one card changing height
+//   search   typing and deleting queries over a synthetic 10k exercise catalog:
+//            rescanning every name per keystroke against the incremental index;
+//            "worst" is the single slowest call, preemption included, "slowest
+//            key" the keystroke with the highest median over all passes
+//   catalog  startup and name lookup for the same catalog: parsing a text list
+//            into strings against mapping the baked catalog
+//   journal  five years of synthetic workouts appended to the workout journal,
+//            then recovery with and without checkpoints
+//   history  over 100k archived sets: opening and querying them as nested
+//            vectors against the memory-mapped columnar file
+//   stats    what every exercise card reads per frame: rescanning the sets
+//            against the incrementally kept workout statistics
+
+#include "ExerciseCatalog.h"
+#include "ExerciseSearch.h"
+#include "HistoryFile.h"
+#include "LayoutTree.h"
+#include "TextRenderer.h"
+#include "Utf8.h"
+#include "WorkoutJournal.h"
+#include "WorkoutTracker.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Keeps results alive so the measured loops are not optimized away
+static volatile long s_sink;
+// Set when a benchmark's results are wrong; reported in the exit status
+static bool s_failed;
+
+static double elapsedSeconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void printRate(const char* name, const char* label, long items, double seconds) {
+    std::printf("%-8s %-30s %8.2f ns/glyph %9.1f Mglyph/s\n",
+                name, label, seconds * 1e9 / (double)items, (double)items / seconds / 1e6);
+}
+
+// TextRenderer's lookup before the page table, kept as the baseline.
+// Not inlined, like the real lookup that lives in another translation unit.
+__attribute__((noinline)) static int legacyGlyphIndex(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'A' && c <= 'Z') {
+        return 10 + (c - 'A');
+    } else if (c >= 'a' && c <= 'z') {
+        return 10 + (c - 'a');
+    } else if (c == ' ') {
+        return 36;
+    } else if (c == ':') {
+        return 37;
+    } else if (c == '+') {
+        return 38;
+    } else if (c == '-') {
+        return 39;
+    } else if (c == '/') {
+        return 40;
+    }
+    return -1;
+}
+
+static std::string repeatText(const char* const* lines, int lineCount, size_t minimumBytes) {
+    std::string text;
+    while (text.size() < minimumBytes) {
+        for (int i = 0; i < lineCount; ++i) {
+            text += lines[i];
+            text += ' ';
+        }
+    }
+    return text;
+}
+
+static void benchGlyphs(int iterations) {
+    static const char* const asciiLines[] = {
+        "Push-ups", "Squats", "Bench Press", "Reps: 12", "3/4 sets", "60kg", "00:45",
+        "Draws: 14 Verts: 2236", "CHOOSE EXERCISE", "End Workout", "P50 812 P95 1604 US",
+    };
+    static const char* const cyrillicLines[] = {
+        "Отжимания", "Приседания", "Жим лёжа", "Повторы: 12", "3/4 подхода", "60 кг",
+        "ВЫБОР УПРАЖНЕНИЯ", "Закончить тренировку", "«Щ» и «Ъ»",
+    };
+    const std::string ascii = repeatText(asciiLines, sizeof(asciiLines) / sizeof(asciiLines[0]), 4096);
+    const std::string cyrillic = repeatText(cyrillicLines, sizeof(cyrillicLines) / sizeof(cyrillicLines[0]), 4096);
+    
+    long sum = 0;
+    long glyphs = 0;
+    Clock::time_point start = Clock::now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        for (size_t i = 0; i < ascii.size(); ++i) {
+            sum += legacyGlyphIndex(ascii[i]);
+        }
+        glyphs += (long)ascii.size();
+    }
+    printRate("glyphs", "if/else chain, ASCII", glyphs, elapsedSeconds(start));
+    
+    glyphs = 0;
+    start = Clock::now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        for (size_t i = 0; i < ascii.size(); ++i) {
+            sum += TextRenderer::getGlyphIndex((uint8_t)ascii[i]);
+        }
+        glyphs += (long)ascii.size();
+    }
+    printRate("glyphs", "page table, ASCII", glyphs, elapsedSeconds(start));
+    
+    glyphs = 0;
+    start = Clock::now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        size_t offset = 0;
+        while (offset < ascii.size()) {
+            sum += TextRenderer::getGlyphIndex(decodeUtf8(ascii.data(), ascii.size(), offset));
+            glyphs++;
+        }
+    }
+    printRate("glyphs", "UTF-8 + page table, ASCII", glyphs, elapsedSeconds(start));
+    
+    glyphs = 0;
+    long missing = 0;
+    start = Clock::now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        size_t offset = 0;
+        while (offset < cyrillic.size()) {
+            int glyph = TextRenderer::getGlyphIndex(decodeUtf8(cyrillic.data(), cyrillic.size(), offset));
+            sum += glyph;
+            missing += glyph < 0;
+            glyphs++;
+        }
+    }
+    printRate("glyphs", "UTF-8 + page table, Cyrillic", glyphs, elapsedSeconds(start));
+    
+    s_sink = sum;
+    if (missing > 0) {
+        std::printf("glyphs   %ld Cyrillic sample code points have no glyph\n", missing);
+    }
+}
+
+// Same shape as WorkoutTracker's exercise card layout
+static LayoutNode* addBenchCard(LayoutNode* list) {
+    LayoutNode* card = list->addChild();
+    card->setHeight(LAYOUT_SIZE_FIXED, 200.0f);
+    card->setPadding(16.0f, 8.0f, 16.0f, 8.0f);
+    
+    LayoutNode* addSet = card->addChild();
+    addSet->setWidth(LAYOUT_SIZE_FIXED, 280.0f);
+    addSet->setHeight(LAYOUT_SIZE_FIXED, 100.0f);
+    addSet->setMargin(500.0f, 15.0f, 0.0f, 0.0f);
+    
+    LayoutNode* repsButtons = card->addChild();
+    repsButtons->setDirection(LAYOUT_ROW);
+    repsButtons->setWidth(LAYOUT_SIZE_CONTENT);
+    repsButtons->setHeight(LAYOUT_SIZE_CONTENT);
+    repsButtons->setSpacing(10.0f);
+    repsButtons->setMargin(250.0f, 60.0f, 0.0f, 0.0f);
+    for (int i = 0; i < 2; ++i) {
+        LayoutNode* button = repsButtons->addChild();
+        button->setWidth(LAYOUT_SIZE_FIXED, 100.0f);
+        button->setHeight(LAYOUT_SIZE_FIXED, 100.0f);
+    }
+    
+    LayoutNode* progress = card->addChild();
+    progress->setHeight(LAYOUT_SIZE_FIXED, 8.0f);
+    progress->setAlign(LAYOUT_ALIGN_START, LAYOUT_ALIGN_END);
+    return card;
+}
+
+static void printLayoutRate(const char* label, int passes, long nodesArranged, double seconds) {
+    std::printf("%-8s %-30s %8.2f us/pass %9ld nodes/pass\n",
+                "layout", label, seconds * 1e6 / (double)passes, nodesArranged / passes);
+}
+
+static void benchLayout(int iterations) {
+    const int cardCount = 500;
+    LayoutTree tree;
+    LayoutNode* list = tree.getRoot()->addChild();
+    list->setDirection(LAYOUT_COLUMN);
+    list->setPadding(10.0f, 8.0f, 10.0f, 8.0f);
+    list->setSpacing(10.0f);
+    std::vector<LayoutNode*> cards;
+    for (int i = 0; i < cardCount; ++i) {
+        cards.push_back(addBenchCard(list));
+    }
+    tree.update(1080.0f, 2400.0f);
+    
+    long arranged = 0;
+    Clock::time_point start = Clock::now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        tree.invalidateAll();
+        tree.update(1080.0f, 2400.0f);
+        arranged += tree.getStats().nodesArranged;
+    }
+    printLayoutRate("full relayout", iterations, arranged, elapsedSeconds(start));
+    
+    // A card's content moves but its size stays: only that card is visited
+    arranged = 0;
+    start = Clock::now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        // Alternates per round over the cards so every pass is a real change
+        bool odd = (pass / cardCount) & 1;
+        LayoutNode* addSet = cards[pass % cardCount]->getChild(0);
+        addSet->setMargin(odd ? 500.0f : 510.0f, 15.0f, 0.0f, 0.0f);
+        tree.update(1080.0f, 2400.0f);
+        arranged += tree.getStats().nodesArranged;
+    }
+    printLayoutRate("one card, same size", iterations, arranged, elapsedSeconds(start));
+    
+    // A card grows or shrinks: the cards below it move, their insides do not
+    arranged = 0;
+    start = Clock::now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        bool odd = (pass / cardCount) & 1;
+        cards[pass % cardCount]->setHeight(LAYOUT_SIZE_FIXED, odd ? 200.0f : 260.0f);
+        tree.update(1080.0f, 2400.0f);
+        arranged += tree.getStats().nodesArranged;
+    }
+    printLayoutRate("one card, new height", iterations, arranged, elapsedSeconds(start));
+    
+    s_sink = (long)cards.back()->getRect().y;
+}
+
+// Modifier x equipment x movement x variant names, over 10k of them
+static std::vector<std::string> makeSearchCatalog() {
+    static const char* const modifiers[] = {
+        "Incline", "Decline", "Seated", "Standing", "Single-Arm", "Close-Grip", "Wide-Grip", "Paused",
+        "Tempo", "Deficit",
+    };
+    static const char* const equipment[] = {
+        "Barbell", "Dumbbell", "Kettlebell", "Cable", "Machine", "Smith Machine", "Resistance Band", "Landmine",
+    };
+    static const char* const movements[] = {
+        "Bench Press", "Squat", "Deadlift", "Row", "Curl", "Overhead Press", "Lunge", "Fly", "Shrug",
+        "Pullover", "Lateral Raise", "Front Raise", "Rear Delt Fly", "Triceps Extension", "Skull Crusher",
+        "Hip Thrust", "Good Morning", "Romanian Deadlift", "Split Squat", "Step-Up", "Calf Raise",
+        "Hammer Curl", "Preacher Curl", "Upright Row", "Face Pull", "Chest Press", "Leg Press",
+        "Leg Extension", "Leg Curl", "Glute Bridge", "Swing", "Clean", "Snatch", "Thruster",
+        "Floor Press", "Pulldown", "Pushdown", "Kickback", "Woodchopper", "Russian Twist",
+        "Farmer Carry", "Reverse Curl",
+    };
+    static const char* const variants[] = { "", " Negative", " Iso Hold" };
+    
+    std::vector<std::string> names;
+    for (const char* variant : variants) {
+        for (const char* movement : movements) {
+            for (const char* tool : equipment) {
+                for (const char* modifier : modifiers) {
+                    names.push_back(std::string(modifier) + " " + tool + " " + movement + variant);
+                }
+            }
+        }
+    }
+    return names;
+}
+
+// Lowercase words of a name or query, as the index sees them
+static std::vector<std::string> splitSearchWords(const std::string& text) {
+    std::vector<std::string> words(1);
+    for (char c : text) {
+        if (std::isalnum((unsigned char)c)) {
+            words.back() += (char)std::tolower((unsigned char)c);
+        } else if (!words.back().empty()) {
+            words.push_back(std::string());
+        }
+    }
+    if (words.back().empty()) {
+        words.pop_back();
+    }
+    return words;
+}
+
+// Highest per-keystroke median; times are stored pass by pass
+static double slowestKeystroke(const std::vector<double>& times, size_t keystrokes) {
+    size_t passes = times.size() / keystrokes;
+    std::vector<double> samples(passes);
+    double slowest = 0.0;
+    for (size_t key = 0; key < keystrokes; ++key) {
+        for (size_t pass = 0; pass < passes; ++pass) {
+            samples[pass] = times[pass * keystrokes + key];
+        }
+        std::nth_element(samples.begin(), samples.begin() + passes / 2, samples.end());
+        slowest = std::max(slowest, samples[passes / 2]);
+    }
+    return slowest;
+}
+
+static void printSearchRate(const char* label, const std::vector<double>& times, size_t keystrokes,
+                            double seconds, size_t results) {
+    std::printf("%-8s %-30s %8.2f us/key %9.2f us worst %8.2f us slowest key %7zu results\n",
+                "search", label, seconds * 1e6 / (double)times.size(),
+                *std::max_element(times.begin(), times.end()) * 1e6,
+                slowestKeystroke(times, keystrokes) * 1e6, results);
+}
+
+static void benchSearch(int iterations) {
+    std::vector<std::string> catalog = makeSearchCatalog();
+    // One of them misspelled, matched through trigrams
+    static const char* const queries[] = {
+        "dumbbell bench press", "incline cable fly", "kettlebel swing", "sq", "landmine row negative",
+    };
+    
+    // Every keystroke: the query grows one character at a time, then shrinks back
+    std::vector<std::string> keystrokes;
+    for (const char* query : queries) {
+        std::string text(query);
+        for (size_t length = 1; length <= text.size(); ++length) {
+            keystrokes.push_back(text.substr(0, length));
+        }
+        for (size_t length = text.size(); length-- > 0;) {
+            keystrokes.push_back(text.substr(0, length));
+        }
+    }
+    // Searches are interactive: a fraction of the passes is plenty
+    int passes = iterations / 20 > 0 ? iterations / 20 : 1;
+    
+    Clock::time_point start = Clock::now();
+    ExerciseSearch search;
+    search.setCatalog(catalog);
+    std::printf("%-8s %-30s %8.2f ms for %zu names\n", "search", "index build",
+                elapsedSeconds(start) * 1e3, catalog.size());
+    
+    // Baseline: every keystroke tests every name's words against the query's
+    std::vector<std::vector<std::string> > nameWords;
+    for (const std::string& name : catalog) {
+        nameWords.push_back(splitSearchWords(name));
+    }
+    std::vector<int> matches;
+    std::vector<double> times;
+    times.reserve((size_t)passes * keystrokes.size());
+    size_t results = 0;
+    start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const std::string& keystroke : keystrokes) {
+            Clock::time_point keyStart = Clock::now();
+            std::vector<std::string> queryWords = splitSearchWords(keystroke);
+            matches.clear();
+            for (size_t entry = 0; entry < nameWords.size(); ++entry) {
+                bool all = true;
+                for (const std::string& queryWord : queryWords) {
+                    bool found = false;
+                    for (const std::string& word : nameWords[entry]) {
+                        if (word.compare(0, queryWord.size(), queryWord) == 0) {
+                            found = true;
+                            break;
+                        }
+                    }
+                    if (!found) {
+                        all = false;
+                        break;
+                    }
+                }
+                if (all) {
+                    matches.push_back((int)entry);
+                }
+            }
+            times.push_back(elapsedSeconds(keyStart));
+            results += matches.size();
+        }
+    }
+    printSearchRate("rescan per keystroke", times, keystrokes.size(), elapsedSeconds(start),
+                    results / (size_t)passes);
+    
+    times.clear();
+    results = 0;
+    start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const std::string& keystroke : keystrokes) {
+            Clock::time_point keyStart = Clock::now();
+            search.setQuery(keystroke);
+            times.push_back(elapsedSeconds(keyStart));
+            results += search.getPrefixMatchCount();
+        }
+    }
+    printSearchRate("incremental index", times, keystrokes.size(), elapsedSeconds(start),
+                    results / (size_t)passes);
+    
+    search.setQuery("ketlebell swing");
+    std::printf("%-8s %-30s %zu prefix + %zu typo-tolerant, first: %s\n", "search", "\"ketlebell swing\"",
+                search.getPrefixMatchCount(), search.getResultCount() - search.getPrefixMatchCount(),
+                search.getResultCount() > 0 ? search.getName(search.getResult(0)).c_str() : "-");
+    
+    // Trigram counts that return to zero on a deletion must not list an entry twice
+    search.setQuery("aettlebel swng");
+    search.setQuery("kettlebel swng");
+    std::vector<int> listed;
+    for (size_t i = 0; i < search.getResultCount(); ++i) {
+        listed.push_back(search.getResult(i));
+    }
+    std::sort(listed.begin(), listed.end());
+    if (std::adjacent_find(listed.begin(), listed.end()) != listed.end()) {
+        std::fprintf(stderr, "search   \"kettlebel swng\" lists an entry twice\n");
+        s_failed = true;
+    }
+    s_sink = (long)search.getResultCount();
+}
+
+static void printCatalogRate(const char* label, long operations, double seconds, const char* unit) {
+    std::printf("%-8s %-30s %8.2f us/%s\n", "catalog", label, seconds * 1e6 / (double)operations, unit);
+}
+
+static void benchCatalog(int iterations) {
+    std::vector<std::string> names = makeSearchCatalog();
+    std::string text;
+    std::vector<ExerciseDefaults> exercises;
+    for (const std::string& name : names) {
+        text += name;
+        text += '\n';
+        ExerciseDefaults defaults = { name.c_str(), 3, 10, 0.0f, 60 };
+        exercises.push_back(defaults);
+    }
+    std::vector<uint8_t> image;
+    char path[] = "/tmp/workouttracker_catalogXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || !ExerciseCatalog::buildImage(exercises.data(), exercises.size(), image) ||
+        write(fd, image.data(), image.size()) != (ssize_t)image.size()) {
+        std::fprintf(stderr, "catalog  cannot write %s\n", path);
+        if (fd >= 0) {
+            close(fd);
+            unlink(path);
+        }
+        return;
+    }
+    close(fd);
+    int opens = iterations / 20 > 0 ? iterations / 20 : 1;
+    
+    // Baseline: the text list split into one string per name, like the old loader
+    long sum = 0;
+    Clock::time_point start = Clock::now();
+    for (int pass = 0; pass < opens; ++pass) {
+        std::vector<std::string> parsed;
+        size_t lineStart = 0;
+        while (lineStart < text.size()) {
+            size_t end = text.find('\n', lineStart);
+            parsed.push_back(text.substr(lineStart, end - lineStart));
+            lineStart = end + 1;
+        }
+        sum += (long)parsed.size();
+    }
+    printCatalogRate("parse text list", opens, elapsedSeconds(start), "open");
+    
+    start = Clock::now();
+    for (int pass = 0; pass < opens; ++pass) {
+        ExerciseCatalog catalog;
+        catalog.openFile(path);
+        sum += catalog.getStoredCount();
+    }
+    printCatalogRate("map baked catalog", opens, elapsedSeconds(start), "open");
+    
+    // Name to exercise: comparing against every name, then the hash table
+    const int lookups = 2000;
+    start = Clock::now();
+    for (int i = 0; i < lookups; ++i) {
+        const std::string& wanted = names[(size_t)i * 7919 % names.size()];
+        for (size_t entry = 0; entry < names.size(); ++entry) {
+            if (names[entry] == wanted) {
+                sum += (long)entry;
+                break;
+            }
+        }
+    }
+    printCatalogRate("find by string compares", lookups, elapsedSeconds(start), "name");
+    
+    ExerciseCatalog catalog;
+    catalog.openFile(path);
+    start = Clock::now();
+    for (int i = 0; i < lookups; ++i) {
+        sum += (long)catalog.find(names[(size_t)i * 7919 % names.size()]);
+    }
+    printCatalogRate("find in mapped hash table", lookups, elapsedSeconds(start), "name");
+    
+    std::printf("%-8s %-30s %zu bytes for %u exercises\n", "catalog", "baked size", image.size(),
+                catalog.getStoredCount());
+    unlink(path);
+    s_sink = sum;
+}
+
+// Four workouts a week for five years: six exercises of four sets, each set
+// adjusted once and completed
+static const int JOURNAL_WORKOUTS = 5 * 52 * 4;
+// Over 100k sets: twelve and a half years of eight exercises of five sets
+static const int HISTORY_WORKOUTS = 2600;
+static const int64_t SYNTHETIC_START_MS = 1600000000000LL;
+static const int64_t SYNTHETIC_SPACING_MS = 42 * 3600 * 1000LL;
+
+// flushEach commits each workout like the app does when it goes to the
+// background
+static long appendSyntheticWorkouts(WorkoutJournal& journal, int workouts, int exerciseCount, int setCount,
+                                    bool flushEach) {
+    static const char* const exercises[] = {
+        "Squats", "Bench Press", "Deadlift", "Overhead Press", "Barbell Row", "Pull-ups", "Lunges", "Dips",
+    };
+    long records = 0;
+    int64_t startMs = SYNTHETIC_START_MS;
+    for (int w = 0; w < workouts; ++w) {
+        journal.startWorkout("Workout " + std::to_string(w + 1), startMs);
+        for (int e = 0; e < exerciseCount; ++e) {
+            journal.addExercise(exercises[(w + e) % 8], setCount, 8 + w % 5, 20.0f + (float)(w % 40) * 2.5f, 90);
+            for (int s = 0; s < setCount; ++s) {
+                journal.setReps(e, s, 9 + (w + s) % 4);
+                // Now and then a set is skipped
+                if ((w + e + s) % 11 != 0) {
+                    journal.completeSet(e, s);
+                }
+            }
+        }
+        journal.endWorkout(startMs + 3600 * 1000);
+        if (flushEach) {
+            journal.flush();
+        }
+        startMs += SYNTHETIC_SPACING_MS;
+        records += 2 + exerciseCount * (1 + 2 * setCount);
+    }
+    return records;
+}
+
+static void removeJournal(const std::string& directory) {
+    static const char* const files[] = { "journal.log", "journal.chk", "history.dat", "history.wth" };
+    for (const char* file : files) {
+        unlink((directory + "/" + file).c_str());
+    }
+    rmdir(directory.c_str());
+}
+
+static void benchJournal(int iterations) {
+    (void)iterations;
+    // Without checkpoints the whole history stays in the log
+    const size_t compactions[] = { 256 * 1024, 0 };
+    const char* const labels[] = { "checkpointed", "log only" };
+    for (int variant = 0; variant < 2; ++variant) {
+        char pattern[] = "/tmp/workouttracker_journalXXXXXX";
+        if (!mkdtemp(pattern)) {
+            std::fprintf(stderr, "journal  cannot create a directory\n");
+            return;
+        }
+        std::string directory(pattern);
+        
+        JournalRecovery recovery;
+        WorkoutJournal journal;
+        journal.setCompactionBytes(compactions[variant]);
+        journal.open(directory, recovery);
+        Clock::time_point start = Clock::now();
+        long records = appendSyntheticWorkouts(journal, JOURNAL_WORKOUTS, 6, 4, true);
+        double appendSeconds = elapsedSeconds(start);
+        journal.flush();
+        double durableSeconds = elapsedSeconds(start);
+        JournalStats stats = journal.getStats();
+        journal.close();
+        
+        std::printf("%-8s %-30s %8.2f us/record %7.0f krecords/s durable, %llu fsyncs, %llu checkpoints, "
+                    "%.1f ms worst commit\n", "journal", labels[variant], appendSeconds * 1e6 / (double)records,
+                    (double)records / durableSeconds / 1e3, (unsigned long long)stats.commits,
+                    (unsigned long long)stats.compactions, stats.maxCommitMs);
+        
+        // Cold start: a fresh journal object recovers from the files alone
+        WorkoutJournal reopened;
+        start = Clock::now();
+        reopened.open(directory, recovery);
+        double recoverySeconds = elapsedSeconds(start);
+        reopened.close();
+        
+        size_t archived = 0;
+        WorkoutJournal::readArchive(directory, [&archived](const JournalWorkout&) { archived++; });
+        std::printf("%-8s %-30s %8.2f ms recovery, %zu records replayed, %u + %zu workouts (%zu archived)\n",
+                    "journal", labels[variant], recoverySeconds * 1e3, recovery.recordsReplayed,
+                    recovery.archivedWorkouts, recovery.finished.size(), archived);
+        removeJournal(directory);
+    }
+}
+
+// Heap bytes behind the vectors, strings beyond the inline buffer included
+static size_t getHeapBytes(const std::vector<JournalWorkout>& workouts) {
+    size_t bytes = workouts.capacity() * sizeof(JournalWorkout);
+    for (const JournalWorkout& workout : workouts) {
+        bytes += workout.name.capacity() > 15 ? workout.name.capacity() + 1 : 0;
+        bytes += workout.exercises.capacity() * sizeof(JournalExercise);
+        for (const JournalExercise& exercise : workout.exercises) {
+            bytes += exercise.name.capacity() > 15 ? exercise.name.capacity() + 1 : 0;
+            bytes += exercise.sets.capacity() * sizeof(JournalSet);
+        }
+    }
+    return bytes;
+}
+
+static void printHistoryRate(const char* label, int passes, double seconds, const char* detail) {
+    std::printf("%-8s %-30s %10.1f us/pass  %s\n", "history", label, seconds * 1e6 / passes, detail);
+}
+
+static void benchHistory(int iterations) {
+    char pattern[] = "/tmp/workouttracker_historyXXXXXX";
+    if (!mkdtemp(pattern)) {
+        std::fprintf(stderr, "history  cannot create a directory\n");
+        return;
+    }
+    std::string directory(pattern);
+    
+    // The journal archives the workouts and writes the columnar copy
+    {
+        JournalRecovery recovery;
+        WorkoutJournal journal;
+        journal.open(directory, recovery);
+        appendSyntheticWorkouts(journal, HISTORY_WORKOUTS, 8, 5, false);
+        journal.close();
+    }
+    std::string historyPath = WorkoutJournal::getHistoryPath(directory);
+    int passes = iterations / 200 > 0 ? iterations / 200 : 1;
+    char detail[128];
+    
+    // Baseline: everything decoded into nested vectors up front
+    std::vector<JournalWorkout> workouts;
+    Clock::time_point start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        workouts.clear();
+        workouts.shrink_to_fit();
+        WorkoutJournal::readArchive(directory, [&workouts](const JournalWorkout& workout) {
+            workouts.push_back(workout);
+        });
+    }
+    size_t sets = 0;
+    for (const JournalWorkout& workout : workouts) {
+        for (const JournalExercise& exercise : workout.exercises) {
+            sets += exercise.sets.size();
+        }
+    }
+    std::snprintf(detail, sizeof(detail), "%zu workouts, %zu sets, %zu KB of heap", workouts.size(), sets,
+                  getHeapBytes(workouts) / 1024);
+    printHistoryRate("load archive into vectors", passes, elapsedSeconds(start), detail);
+    
+    HistoryFile history;
+    start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        history.openFile(historyPath.c_str());
+    }
+    std::snprintf(detail, sizeof(detail), "%u workouts, %u sets, %zu KB mapped, %u blocks", history.getWorkoutCount(),
+                  history.getSetCount(), history.getSize() / 1024, history.getBlockCount());
+    printHistoryRate("map columnar file", passes, elapsedSeconds(start), detail);
+    
+    // The last year's volume: every workout against the blocks in range
+    int64_t toMs = SYNTHETIC_START_MS + HISTORY_WORKOUTS * SYNTHETIC_SPACING_MS;
+    int64_t fromMs = toMs - 365LL * 24 * 3600 * 1000;
+    double volume = 0.0;
+    start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        volume = 0.0;
+        for (const JournalWorkout& workout : workouts) {
+            if (workout.startMs < fromMs || workout.startMs >= toMs) {
+                continue;
+            }
+            for (const JournalExercise& exercise : workout.exercises) {
+                for (const JournalSet& set : exercise.sets) {
+                    volume += set.completed ? (double)set.reps * set.weight : 0.0;
+                }
+            }
+        }
+    }
+    std::snprintf(detail, sizeof(detail), "%.0f kg", volume);
+    printHistoryRate("last year's volume, vectors", passes, elapsedSeconds(start), detail);
+    
+    start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        volume = history.getVolume(fromMs, toMs);
+    }
+    std::snprintf(detail, sizeof(detail), "%.0f kg", volume);
+    printHistoryRate("last year's volume, columnar", passes, elapsedSeconds(start), detail);
+    
+    // Best squat: every set against the blocks whose maximum can still win
+    float best = 0.0f;
+    start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        best = 0.0f;
+        for (const JournalWorkout& workout : workouts) {
+            for (const JournalExercise& exercise : workout.exercises) {
+                if (exercise.name != "Squats") {
+                    continue;
+                }
+                for (const JournalSet& set : exercise.sets) {
+                    best = set.completed && set.weight > best ? set.weight : best;
+                }
+            }
+        }
+    }
+    std::snprintf(detail, sizeof(detail), "%.2f kg", best);
+    printHistoryRate("best squat, vectors", passes, elapsedSeconds(start), detail);
+    
+    uint32_t squats = history.findExercise("Squats");
+    start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        best = history.getBestWeight(squats);
+    }
+    std::snprintf(detail, sizeof(detail), "%.2f kg", best);
+    printHistoryRate("best squat, columnar", passes, elapsedSeconds(start), detail);
+    
+    history.close();
+    removeJournal(directory);
+    s_sink = (long)volume;
+}
+
+// The card's reads before the statistics were kept: the completed count for
+// the counter and again for the progress bar, then the first incomplete set
+__attribute__((noinline)) static int legacyCompletedSets(const Exercise& exercise) {
+    int completed = 0;
+    for (const Set& set : exercise.getSets()) {
+        completed += set.completed ? 1 : 0;
+    }
+    return completed;
+}
+
+__attribute__((noinline)) static int legacyCurrentReps(const Exercise& exercise) {
+    const std::vector<Set>& sets = exercise.getSets();
+    for (const Set& set : sets) {
+        if (!set.completed) {
+            return set.reps;
+        }
+    }
+    return sets.empty() ? exercise.defaultReps : sets[0].reps;
+}
+
+static void printStatsRate(const char* label, long cards, double seconds) {
+    std::printf("%-8s %-30s %8.2f ns/card\n", "stats", label, seconds * 1e9 / (double)cards);
+}
+
+static void benchStats(int iterations) {
+    // A long session: twelve exercises of eight sets, half of them done
+    Workout workout;
+    for (int e = 0; e < 12; ++e) {
+        Exercise exercise;
+        exercise.defaultReps = 10;
+        for (int s = 0; s < 8; ++s) {
+            exercise.addSet(Set(10, 40.0f));
+        }
+        workout.addExercise(exercise);
+        for (int s = 0; s < 4; ++s) {
+            workout.completeSet(e, s);
+        }
+    }
+    int frames = iterations * 10;
+    long cards = (long)frames * workout.getExerciseCount();
+    
+    long sum = 0;
+    Clock::time_point start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (const Exercise& exercise : workout.getExercises()) {
+            int total = (int)exercise.getSets().size();
+            sum += legacyCompletedSets(exercise) + total + legacyCurrentReps(exercise);
+            float progress = total > 0 ? (float)legacyCompletedSets(exercise) / (float)total : 0.0f;
+            sum += (long)(progress * 100.0f);
+        }
+    }
+    printStatsRate("rescan sets per card", cards, elapsedSeconds(start));
+    
+    start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (const Exercise& exercise : workout.getExercises()) {
+            int current = exercise.getCurrentSet();
+            sum += exercise.getCompletedSets() + exercise.getSetCount();
+            sum += current >= 0 ? exercise.getSets()[current].reps : exercise.defaultReps;
+            sum += (long)(exercise.getProgress() * 100.0f);
+        }
+    }
+    printStatsRate("incremental statistics", cards, elapsedSeconds(start));
+    s_sink = sum;
+}
+
+struct Benchmark {
+    const char* name;
+    void (*run)(int iterations);
+};
+
+static const Benchmark s_benchmarks[] = {
+    { "glyphs", benchGlyphs },
+    { "layout", benchLayout },
+    { "search", benchSearch },
+    { "catalog", benchCatalog },
+    { "journal", benchJournal },
+    { "history", benchHistory },
+    { "stats", benchStats },
+};
+
+static void printUsage() {
+    std::fprintf(stderr, "usage: workouttracker_bench [--iterations N] [BENCHMARK...]\nbenchmarks:");
+    for (const Benchmark& benchmark : s_benchmarks) {
+        std::fprintf(stderr, " %s", benchmark.name);
+    }
+    std::fprintf(stderr, "\n");
+}
+
+int main(int argc, char** argv) {
+    int iterations = 2000;
+    bool selected[sizeof(s_benchmarks) / sizeof(s_benchmarks[0])] = {};
+    bool anySelected = false;
+    
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+            if (iterations <= 0) {
+                printUsage();
+                return 2;
+            }
+            continue;
+        }
+        
+        bool known = false;
+        for (size_t b = 0; b < sizeof(s_benchmarks) / sizeof(s_benchmarks[0]); ++b) {
+            if (std::strcmp(argv[i], s_benchmarks[b].name) == 0) {
+                selected[b] = true;
+                anySelected = true;
+                known = true;
+            }
+        }
+        if (!known) {
+            printUsage();
+            return 2;
+        }
+    }
+    
+    for (size_t b = 0; b < sizeof(s_benchmarks) / sizeof(s_benchmarks[0]); ++b) {
+        if (!anySelected || selected[b]) {
+            s_benchmarks[b].run(iterations);
+        }
+    }
+    return s_failed ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+// Bakes a text list of exercises into the catalog asset that the app
+// memory-maps at startup (format in ExerciseCatalog.h).
+//
+//   workouttracker_catalogbake LIST OUT
+//
+// LIST has one exercise per line:
+//
+//   name[;sets[;reps[;weight[;rest]]]]
+//
+// Missing fields default to 3 sets of 10 reps, no weight and 60 seconds of
+// rest. Blank lines and lines starting with '#' are skipped. Names must be
+// unique; their order is the order of the ids and of the picker.
+
+#include "ExerciseCatalog.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static void printUsage() {
+    std::fprintf(stderr, "usage: workouttracker_catalogbake LIST OUT\n");
+}
+
+static std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Splits a line at ';' into at most five fields
+static bool parseLine(const std::string& line, std::string& name, ExerciseDefaults& defaults) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (start <= line.size() && fields.size() < 5) {
+        size_t end = line.find(';', start);
+        if (end == std::string::npos) {
+            end = line.size();
+        }
+        fields.push_back(trim(line.substr(start, end - start)));
+        start = end + 1;
+    }
+    
+    name = fields[0];
+    defaults.sets = fields.size() > 1 && !fields[1].empty() ? std::atoi(fields[1].c_str()) : 3;
+    defaults.reps = fields.size() > 2 && !fields[2].empty() ? std::atoi(fields[2].c_str()) : 10;
+    defaults.weight = fields.size() > 3 && !fields[3].empty() ? (float)std::atof(fields[3].c_str()) : 0.0f;
+    defaults.restTime = fields.size() > 4 && !fields[4].empty() ? std::atoi(fields[4].c_str()) : 60;
+    return !name.empty() && defaults.sets >= 0 && defaults.sets <= 0xFFFF && defaults.reps >= 0 &&
+           defaults.reps <= 0xFFFF && defaults.weight >= 0.0f && defaults.restTime >= 0 && defaults.restTime <= 0xFFFF;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        printUsage();
+        return 2;
+    }
+    const char* listPath = argv[1];
+    const char* outPath = argv[2];
+    
+    FILE* in = std::fopen(listPath, "rb");
+    if (!in) {
+        std::fprintf(stderr, "Cannot open %s\n", listPath);
+        return 1;
+    }
+    
+    // Names first: the defaults point into them once all are read
+    std::vector<std::string> names;
+    std::vector<ExerciseDefaults> exercises;
+    std::string line;
+    int lineNumber = 0;
+    int c;
+    do {
+        c = std::fgetc(in);
+        if (c != '\n' && c != EOF) {
+            line += (char)c;
+            continue;
+        }
+        
+        lineNumber++;
+        std::string trimmed = trim(line);
+        line.clear();
+        if (trimmed.empty() || trimmed[0] == '#') {
+            continue;
+        }
+        
+        std::string name;
+        ExerciseDefaults defaults;
+        if (!parseLine(trimmed, name, defaults)) {
+            std::fprintf(stderr, "%s:%d: invalid exercise\n", listPath, lineNumber);
+            std::fclose(in);
+            return 1;
+        }
+        names.push_back(name);
+        exercises.push_back(defaults);
+    } while (c != EOF);
+    std::fclose(in);
+    
+    for (size_t i = 0; i < exercises.size(); ++i) {
+        exercises[i].name = names[i].c_str();
+    }
+    
+    std::vector<uint8_t> image;
+    if (!ExerciseCatalog::buildImage(exercises.data(), exercises.size(), image)) {
+        std::fprintf(stderr, "%s: exercise names must be unique\n", listPath);
+        return 1;
+    }
+    
+    FILE* out = std::fopen(outPath, "wb");
+    if (!out || std::fwrite(image.data(), 1, image.size(), out) != image.size() || std::fclose(out) != 0) {
+        std::fprintf(stderr, "Cannot write %s\n", outPath);
+        return 1;
+    }
+    
+    // Read it back the way the app will
+    ExerciseCatalog catalog;
+    if (!catalog.openFile(outPath) || catalog.getStoredCount() != exercises.size()) {
+        std::fprintf(stderr, "%s does not open as a catalog\n", outPath);
+        return 1;
+    }
+    
+    std::printf("%s: %zu exercises, %zu bytes\n", outPath, exercises.size(), image.size());
+    return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef HOST_COMPAT_ANDROID_LOG_H
+#define HOST_COMPAT_ANDROID_LOG_H
+
+// Host stand-in for the NDK logger: warnings and errors go to stderr, info
+// messages only when WORKOUTTRACKER_VERBOSE is set
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+enum {
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT
+};
+
+static inline int __android_log_print(int priority, const char* tag, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static inline int __android_log_print(int priority, const char* tag, const char* format, ...) {
+    static const bool verbose = std::getenv("WORKOUTTRACKER_VERBOSE") != nullptr;
+    if (priority < ANDROID_LOG_WARN && !verbose) {
+        return 0;
+    }
+    
+    std::fprintf(stderr, "%s: ", tag);
+    va_list args;
+    va_start(args, format);
+    int written = std::vfprintf(stderr, format, args);
+    va_end(args);
+    std::fputc('\n', stderr);
+    return written;
+}
+
+#endif // HOST_COMPAT_ANDROID_LOG_H
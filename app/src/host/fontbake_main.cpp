@@ -0,0 +1,246 @@
+// Bakes a TrueType/OpenType font into the signed-distance-field asset that
+// TextRenderer memory-maps on the device (format in FontAsset.h), so the app
+// never parses or rasterizes font files itself.
+//
+//   workouttracker_fontbake [--size PX] [--spread PX] [--atlas-width PX] FONT OUT
+//
+//   --size PX         em size glyphs are rasterized at (default 32)
+//   --spread PX       distance range on either side of the outline (default 4)
+//   --atlas-width PX  atlas width; the height grows to fit (default 512)
+//
+// Code points: printable ASCII, Latin-1, Cyrillic U+0400..U+045F and common
+// typographic punctuation and arrows. Those missing from the font are skipped.
+
+#include "FontAsset.h"
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+struct CodepointRange {
+    uint32_t first;
+    uint32_t last;
+};
+
+static const CodepointRange s_codepointRanges[] = {
+    { 0x0020, 0x007E },     // ASCII
+    { 0x00A0, 0x00FF },     // Latin-1
+    { 0x0400, 0x045F },     // Cyrillic
+    { 0x2013, 0x2014 },     // dashes
+    { 0x2018, 0x201E },     // quotes
+    { 0x2022, 0x2022 },     // bullet
+    { 0x2026, 0x2026 },     // ellipsis
+    { 0x2116, 0x2116 },     // numero sign
+    { 0x2190, 0x2193 },     // arrows
+};
+
+struct BakedGlyph {
+    FontAssetGlyph metrics;
+    std::vector<uint8_t> distance;
+};
+
+static uint32_t alignUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool bakeGlyph(FT_Face face, uint32_t codepoint, BakedGlyph& glyph) {
+    FT_UInt index = FT_Get_Char_Index(face, codepoint);
+    if (index == 0 || FT_Load_Glyph(face, index, FT_LOAD_DEFAULT) != 0) {
+        return false;
+    }
+    
+    FT_GlyphSlot slot = face->glyph;
+    std::memset(&glyph.metrics, 0, sizeof(glyph.metrics));
+    glyph.metrics.codepoint = codepoint;
+    glyph.metrics.advance = (float)slot->advance.x / 64.0f;
+    glyph.distance.clear();
+    
+    // Outline-less glyphs (space) only advance
+    if (slot->format != FT_GLYPH_FORMAT_OUTLINE || slot->outline.n_points == 0) {
+        return true;
+    }
+    if (FT_Render_Glyph(slot, FT_RENDER_MODE_SDF) != 0) {
+        return false;
+    }
+    
+    const FT_Bitmap& bitmap = slot->bitmap;
+    glyph.metrics.width = (uint16_t)bitmap.width;
+    glyph.metrics.height = (uint16_t)bitmap.rows;
+    glyph.metrics.bearingX = (float)slot->bitmap_left;
+    glyph.metrics.bearingY = (float)slot->bitmap_top;
+    glyph.distance.resize((size_t)bitmap.width * bitmap.rows);
+    for (unsigned int row = 0; row < bitmap.rows; ++row) {
+        std::memcpy(&glyph.distance[(size_t)row * bitmap.width], bitmap.buffer + (ptrdiff_t)row * bitmap.pitch,
+                    bitmap.width);
+    }
+    return true;
+}
+
+// Shelf packing, tallest glyphs first; returns the atlas height
+static uint32_t packGlyphs(std::vector<BakedGlyph>& glyphs, uint32_t atlasWidth) {
+    std::vector<BakedGlyph*> order;
+    for (BakedGlyph& glyph : glyphs) {
+        order.push_back(&glyph);
+    }
+    std::sort(order.begin(), order.end(), [](const BakedGlyph* a, const BakedGlyph* b) {
+        return a->metrics.height > b->metrics.height;
+    });
+    
+    // One empty texel between boxes keeps linear filtering from bleeding
+    const uint32_t gap = 1;
+    uint32_t x = gap;
+    uint32_t y = gap;
+    uint32_t shelfHeight = 0;
+    for (BakedGlyph* glyph : order) {
+        uint32_t width = glyph->metrics.width;
+        uint32_t height = glyph->metrics.height;
+        if (width == 0) {
+            continue;
+        }
+        if (x + width + gap > atlasWidth) {
+            x = gap;
+            y += shelfHeight + gap;
+            shelfHeight = 0;
+        }
+        glyph->metrics.atlasX = (uint16_t)x;
+        glyph->metrics.atlasY = (uint16_t)y;
+        x += width + gap;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+    return alignUp(y + shelfHeight + gap, 4);
+}
+
+static void printUsage() {
+    std::fprintf(stderr, "usage: workouttracker_fontbake [--size PX] [--spread PX] [--atlas-width PX] FONT OUT\n");
+}
+
+int main(int argc, char** argv) {
+    int pixelSize = 32;
+    int spread = 4;
+    int atlasWidth = 512;
+    const char* fontPath = nullptr;
+    const char* outPath = nullptr;
+    
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--size") == 0 && hasValue) {
+            pixelSize = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--spread") == 0 && hasValue) {
+            spread = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--atlas-width") == 0 && hasValue) {
+            atlasWidth = std::atoi(argv[++i]);
+        } else if (!fontPath) {
+            fontPath = argv[i];
+        } else if (!outPath) {
+            outPath = argv[i];
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    // FreeType accepts spreads of 2..32 pixels
+    if (!fontPath || !outPath || pixelSize <= 0 || spread < 2 || spread > 32 || atlasWidth <= 0 || atlasWidth > 4096) {
+        printUsage();
+        return 2;
+    }
+    
+    FT_Library library;
+    FT_Face face;
+    if (FT_Init_FreeType(&library) != 0) {
+        std::fprintf(stderr, "Cannot initialize FreeType\n");
+        return 1;
+    }
+    FT_Int spreadProperty = spread;
+    if (FT_Property_Set(library, "sdf", "spread", &spreadProperty) != 0 ||
+        FT_New_Face(library, fontPath, 0, &face) != 0 || FT_Set_Pixel_Sizes(face, 0, (FT_UInt)pixelSize) != 0) {
+        std::fprintf(stderr, "Cannot load %s\n", fontPath);
+        return 1;
+    }
+    
+    std::vector<BakedGlyph> glyphs;
+    for (const CodepointRange& range : s_codepointRanges) {
+        for (uint32_t codepoint = range.first; codepoint <= range.last; ++codepoint) {
+            BakedGlyph glyph;
+            if (bakeGlyph(face, codepoint, glyph)) {
+                glyphs.push_back(glyph);
+            }
+        }
+    }
+    
+    // Cap height from the outline of 'H', without the distance padding
+    float capHeight = (float)pixelSize * 0.7f;
+    FT_UInt capIndex = FT_Get_Char_Index(face, 'H');
+    if (capIndex != 0 && FT_Load_Glyph(face, capIndex, FT_LOAD_NO_BITMAP) == 0) {
+        capHeight = (float)face->glyph->metrics.horiBearingY / 64.0f;
+    }
+    float ascender = (float)face->size->metrics.ascender / 64.0f;
+    float descender = (float)face->size->metrics.descender / 64.0f;
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+    
+    uint32_t atlasHeight = packGlyphs(glyphs, (uint32_t)atlasWidth);
+    if (atlasHeight > 4096) {
+        std::fprintf(stderr, "Glyphs do not fit a %d pixel wide atlas\n", atlasWidth);
+        return 1;
+    }
+    
+    // Code point page table; page 0 stays empty for blocks without glyphs
+    std::vector<uint16_t> directory(FONT_ASSET_PAGE_COUNT, 0);
+    std::vector<uint16_t> pages(FONT_ASSET_PAGE_SIZE, FONT_ASSET_NO_GLYPH);
+    for (size_t i = 0; i < glyphs.size(); ++i) {
+        uint32_t block = glyphs[i].metrics.codepoint >> FONT_ASSET_PAGE_BITS;
+        if (directory[block] == 0) {
+            directory[block] = (uint16_t)(pages.size() / FONT_ASSET_PAGE_SIZE);
+            pages.resize(pages.size() + FONT_ASSET_PAGE_SIZE, FONT_ASSET_NO_GLYPH);
+        }
+        pages[directory[block] * FONT_ASSET_PAGE_SIZE + (glyphs[i].metrics.codepoint & (FONT_ASSET_PAGE_SIZE - 1))] =
+            (uint16_t)i;
+    }
+    
+    FontAssetHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = FONT_ASSET_MAGIC;
+    header.version = FONT_ASSET_VERSION;
+    header.glyphCount = (uint32_t)glyphs.size();
+    header.pageCount = (uint32_t)(pages.size() / FONT_ASSET_PAGE_SIZE);
+    header.atlasWidth = (uint32_t)atlasWidth;
+    header.atlasHeight = atlasHeight;
+    header.pixelSize = (float)pixelSize;
+    header.distanceRange = (float)spread;
+    header.ascender = ascender;
+    header.descender = descender;
+    header.capHeight = capHeight;
+    header.pageDirectoryOffset = alignUp(sizeof(FontAssetHeader), 4);
+    header.pagesOffset = alignUp(header.pageDirectoryOffset + (uint32_t)(directory.size() * sizeof(uint16_t)), 4);
+    header.glyphsOffset = alignUp(header.pagesOffset + (uint32_t)(pages.size() * sizeof(uint16_t)), 4);
+    header.atlasOffset = alignUp(header.glyphsOffset + (uint32_t)(glyphs.size() * sizeof(FontAssetGlyph)), 4);
+    header.fileSize = header.atlasOffset + header.atlasWidth * header.atlasHeight;
+    
+    std::vector<uint8_t> file(header.fileSize, 0);
+    std::memcpy(&file[0], &header, sizeof(header));
+    std::memcpy(&file[header.pageDirectoryOffset], directory.data(), directory.size() * sizeof(uint16_t));
+    std::memcpy(&file[header.pagesOffset], pages.data(), pages.size() * sizeof(uint16_t));
+    for (size_t i = 0; i < glyphs.size(); ++i) {
+        std::memcpy(&file[header.glyphsOffset + i * sizeof(FontAssetGlyph)], &glyphs[i].metrics, sizeof(FontAssetGlyph));
+        
+        const FontAssetGlyph& metrics = glyphs[i].metrics;
+        for (uint32_t row = 0; row < metrics.height; ++row) {
+            std::memcpy(&file[header.atlasOffset + (size_t)(metrics.atlasY + row) * header.atlasWidth + metrics.atlasX],
+                        &glyphs[i].distance[(size_t)row * metrics.width], metrics.width);
+        }
+    }
+    
+    FILE* out = std::fopen(outPath, "wb");
+    if (!out || std::fwrite(file.data(), 1, file.size(), out) != file.size() || std::fclose(out) != 0) {
+        std::fprintf(stderr, "Cannot write %s\n", outPath);
+        return 1;
+    }
+    
+    std::printf("%s: %u glyphs, %u x %u atlas, %u bytes\n", outPath, header.glyphCount,
+                header.atlasWidth, header.atlasHeight, header.fileSize);
+    return 0;
+}
@@ -0,0 +1,369 @@
+// Headless driver for the UI: renders the app's screens with the software
+// backend, writes or checks golden images and measures frame rates without
+// a device or GPU.
+//
+//   workouttracker_host [--size WxH] [--out DIR] [--golden DIR] [--bench FRAMES] [--trace DIR]
+//                       [--alloc-check FRAMES] [--font FILE] [--exercises N]
+//
+//   --out DIR       write <screen>.ppm for every screen into DIR
+//   --golden DIR    compare every screen against DIR/<screen>.ppm; exit code 1 on mismatch
+//   --bench FRAMES  per screen, time FRAMES frames that rebuild the whole scene
+//                   and FRAMES frames that replay cached geometry
+//   --trace DIR     capture a draw trace of every screen, including its benchmark
+//                   frames, as DIR/<screen>.trace for workouttracker_replay
+//   --alloc-check FRAMES
+//                   per screen, count heap allocations over FRAMES warmed-up
+//                   frames, with and without the debug overlay; exit code 1
+//                   if any frame allocates
+//   --font FILE     draw text with a font asset baked by workouttracker_fontbake
+//                   instead of the built-in bitmap font
+//   --exercises N   number of exercises in the workout screen's list (at least and by default 3)
+
+#include "Renderer.h"
+#include "FontAsset.h"
+#include "FrameProfiler.h"
+#include "SoftwareRenderBackend.h"
+#include "WorkoutTracker.h"
+#include "Layout.h"
+#include "TextRunCache.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// Channel difference still treated as equal, to absorb float rounding
+// differences between compilers and SIMD paths
+static const int GOLDEN_TOLERANCE = 2;
+
+// Frames rendered before allocations are counted, so that scratch buffers,
+// caches and recorded geometry have reached their steady-state size
+static const int ALLOC_CHECK_WARMUP_FRAMES = 8;
+
+// Global allocation counter for --alloc-check. Every operator new of the
+// process goes through here; counting is only switched on around the
+// measured frames.
+static std::atomic<bool> s_countAllocations(false);
+static std::atomic<long> s_allocationCount(0);
+
+void* operator new(std::size_t size) {
+    if (s_countAllocations.load(std::memory_order_relaxed)) {
+        s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* memory = std::malloc(size > 0 ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+// GCC pairs the free below with the caller's new expression and warns
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+struct HostScreen {
+    const char* name;
+    void (*setup)(WorkoutTracker& tracker, Renderer& renderer);
+};
+
+static void renderFrame(WorkoutTracker& tracker, Renderer& renderer) {
+    tracker.update();
+    renderer.beginFrame();
+    tracker.render(&renderer);
+    renderer.endFrame();
+}
+
+static void setupMainScreen(WorkoutTracker&, Renderer&) {
+}
+
+// Exercises in the workout screen, at least the three of the golden image
+static int s_exerciseCount = 3;
+
+static void setupWorkoutScreen(WorkoutTracker& tracker, Renderer&) {
+    tracker.startWorkout("Workout");
+    tracker.addExercise("Push-ups", 3, 10, 0.0f);
+    tracker.addExercise("Squats", 3, 15, 0.0f);
+    tracker.addExercise("Bench Press", 4, 8, 60.0f);
+    // Longer lists for scrolling and culling measurements
+    for (int i = 3; i < s_exerciseCount; ++i) {
+        tracker.addExercise("Exercise " + std::to_string(i + 1), 3, 10, 20.0f);
+    }
+}
+
+static void setupSelectionScreen(WorkoutTracker& tracker, Renderer& renderer) {
+    tracker.startWorkout("Workout");
+    // Lay the workout screen out once so the choose button has its bounds
+    renderFrame(tracker, renderer);
+    float chooseX = Layout::MARGIN_LARGE + 1.0f;
+    float chooseY = Layout::HEADER_HEIGHT + Layout::SPACING_MEDIUM + 1.0f;
+    tracker.onTouchDown(chooseX, chooseY);
+}
+
+static const HostScreen s_screens[] = {
+    { "main", setupMainScreen },
+    { "workout", setupWorkoutScreen },
+    { "selection", setupSelectionScreen },
+};
+
+static bool writePPM(const std::string& path, const SoftwareRenderBackend& backend) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+        return false;
+    }
+    
+    int width = backend.getWidth();
+    int height = backend.getHeight();
+    std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+    
+    std::vector<uint8_t> row((size_t)width * 3);
+    const uint32_t* pixels = backend.getPixels();
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint32_t pixel = pixels[(size_t)y * width + x];
+            row[x * 3 + 0] = (uint8_t)(pixel & 0xFF);
+            row[x * 3 + 1] = (uint8_t)((pixel >> 8) & 0xFF);
+            row[x * 3 + 2] = (uint8_t)((pixel >> 16) & 0xFF);
+        }
+        std::fwrite(row.data(), 1, row.size(), file);
+    }
+    
+    return std::fclose(file) == 0;
+}
+
+static bool readPPM(const std::string& path, int& width, int& height, std::vector<uint8_t>& rgb) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    
+    int maxValue = 0;
+    bool ok = std::fscanf(file, "P6 %d %d %d", &width, &height, &maxValue) == 3 &&
+              maxValue == 255 && width > 0 && height > 0 && std::fgetc(file) != EOF;
+    if (ok) {
+        rgb.resize((size_t)width * height * 3);
+        ok = std::fread(rgb.data(), 1, rgb.size(), file) == rgb.size();
+    }
+    
+    std::fclose(file);
+    return ok;
+}
+
+// Returns the number of pixels that differ by more than the tolerance
+static long comparePPM(const std::string& path, const SoftwareRenderBackend& backend) {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgb;
+    if (!readPPM(path, width, height, rgb)) {
+        std::fprintf(stderr, "Cannot read golden image %s\n", path.c_str());
+        return -1;
+    }
+    if (width != backend.getWidth() || height != backend.getHeight()) {
+        std::fprintf(stderr, "%s is %d x %d, rendered %d x %d\n",
+                     path.c_str(), width, height, backend.getWidth(), backend.getHeight());
+        return -1;
+    }
+    
+    long mismatches = 0;
+    const uint32_t* pixels = backend.getPixels();
+    for (size_t i = 0; i < (size_t)width * height; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            int rendered = (int)((pixels[i] >> (c * 8)) & 0xFF);
+            if (std::abs(rendered - (int)rgb[i * 3 + c]) > GOLDEN_TOLERANCE) {
+                mismatches++;
+                break;
+            }
+        }
+    }
+    return mismatches;
+}
+
+static void runBenchmark(const HostScreen& screen, WorkoutTracker& tracker, Renderer& renderer, int frames) {
+    typedef std::chrono::steady_clock Clock;
+    
+    for (int pass = 0; pass < 2; ++pass) {
+        bool rebuild = pass == 0;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < frames; ++i) {
+            if (rebuild) {
+                tracker.invalidateScene();
+            } else {
+                tracker.requestRedraw();
+            }
+            renderFrame(tracker, renderer);
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        
+        const RenderStats& stats = renderer.getFrameStats();
+        const TextRunCacheStats& runs = tracker.getTextRunStats();
+        std::printf("%-10s %-8s %8.1f fps %9.1f us/frame  draws %d  quads %d  culled %d/%d verts  "
+                    "text runs %llu hits %llu misses\n",
+                    screen.name, rebuild ? "rebuild" : "replay",
+                    frames / seconds, seconds * 1e6 / frames, stats.drawCalls, stats.quads,
+                    stats.culledDraws, stats.culledVertices,
+                    (unsigned long long)runs.hits, (unsigned long long)runs.misses);
+    }
+}
+
+// Renders warmed-up rebuild and replay frames, first without and then with the
+// debug overlay, and returns the number of heap allocations they made
+static long runAllocCheck(const HostScreen& screen, WorkoutTracker& tracker, Renderer& renderer,
+                          FrameProfiler& profiler, int frames) {
+    long total = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        bool overlay = pass == 1;
+        if (overlay) {
+            tracker.toggleDebugMode();
+        }
+        
+        long before = 0;
+        for (int i = 0; i < ALLOC_CHECK_WARMUP_FRAMES + frames; ++i) {
+            if (i == ALLOC_CHECK_WARMUP_FRAMES) {
+                before = s_allocationCount.load();
+                s_countAllocations.store(true);
+            }
+            // Alternate full rebuilds with replays of the recorded geometry
+            if (i % 2 == 0) {
+                tracker.invalidateScene();
+            } else {
+                tracker.requestRedraw();
+            }
+            renderFrame(tracker, renderer);
+            profiler.endFrame(renderer.getFrameStats());
+        }
+        s_countAllocations.store(false);
+        
+        long allocations = s_allocationCount.load() - before;
+        const FrameArena& arena = renderer.getFrameArena();
+        std::printf("%-10s %-8s %ld allocations in %d frames  arena %zu bytes/frame, peak %zu\n",
+                    screen.name, overlay ? "overlay" : "plain", allocations, frames,
+                    arena.getLastFrameBytes(), arena.getPeakBytes());
+        total += allocations;
+    }
+    
+    tracker.toggleDebugMode();
+    return total;
+}
+
+static void printUsage() {
+    std::fprintf(stderr,
+                 "usage: workouttracker_host [--size WxH] [--out DIR] [--golden DIR] [--bench FRAMES] [--trace DIR]\n"
+                 "                           [--alloc-check FRAMES] [--font FILE] [--exercises N]\n");
+}
+
+int main(int argc, char** argv) {
+    int width = 1080;
+    int height = 2340;
+    std::string outDir;
+    std::string goldenDir;
+    int benchFrames = 0;
+    std::string traceDir;
+    int allocCheckFrames = 0;
+    const char* fontPath = nullptr;
+    
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--size") == 0 && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                printUsage();
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            outDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--golden") == 0 && hasValue) {
+            goldenDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--bench") == 0 && hasValue) {
+            benchFrames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) {
+            traceDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--alloc-check") == 0 && hasValue) {
+            allocCheckFrames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--font") == 0 && hasValue) {
+            fontPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--exercises") == 0 && hasValue) {
+            s_exerciseCount = std::atoi(argv[++i]);
+            if (s_exerciseCount < 3) {
+                printUsage();
+                return 2;
+            }
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    
+    FontAsset font;
+    if (fontPath && !font.openFile(fontPath)) {
+        std::fprintf(stderr, "Cannot load font asset %s\n", fontPath);
+        return 1;
+    }
+    
+    bool passed = true;
+    for (const HostScreen& screen : s_screens) {
+        FrameArena arena;
+        arena.setDebugMode(true);
+        Renderer renderer;
+        renderer.setFrameArena(&arena);
+        SoftwareRenderBackend* backend = new SoftwareRenderBackend();
+        if (!renderer.initialize(backend, width, height)) {
+            std::fprintf(stderr, "Failed to initialize the software renderer\n");
+            return 1;
+        }
+        
+        if (!traceDir.empty() && !renderer.startTrace(traceDir + "/" + screen.name + ".trace")) {
+            passed = false;
+        }
+        
+        WorkoutTracker tracker;
+        tracker.setVerifyStats(true);
+        if (font.isOpen()) {
+            tracker.setFontAsset(&font);
+        }
+        screen.setup(tracker, renderer);
+        renderFrame(tracker, renderer);
+        
+        std::string fileName = std::string(screen.name) + ".ppm";
+        if (!outDir.empty() && !writePPM(outDir + "/" + fileName, *backend)) {
+            passed = false;
+        }
+        
+        if (!goldenDir.empty()) {
+            long mismatches = comparePPM(goldenDir + "/" + fileName, *backend);
+            if (mismatches != 0) {
+                passed = false;
+                if (mismatches > 0) {
+                    std::fprintf(stderr, "%s: %ld pixels differ from the golden image\n", screen.name, mismatches);
+                }
+            } else {
+                std::printf("%s: matches golden image\n", screen.name);
+            }
+        }
+        
+        if (benchFrames > 0) {
+            runBenchmark(screen, tracker, renderer, benchFrames);
+        }
+        
+        if (allocCheckFrames > 0) {
+            FrameProfiler profiler;
+            tracker.setProfiler(&profiler);
+            if (runAllocCheck(screen, tracker, renderer, profiler, allocCheckFrames) != 0) {
+                passed = false;
+            }
+            tracker.setProfiler(nullptr);
+        }
+    }
+    
+    return passed ? 0 : 1;
+}
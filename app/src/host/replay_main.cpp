@@ -0,0 +1,185 @@
+// Replays a draw trace captured with Renderer::startTrace as fast as possible
+// and reports the per-frame cost, so a session recorded on a device can be
+// profiled on the host.
+//
+//   workouttracker_replay [--backend software|null] [--loops N] [--csv FILE] TRACE
+//
+//   --backend  software rasterizes every frame (default); null measures only
+//              the Renderer front-end: batching, geometry replay and bookkeeping
+//   --loops N  replay the whole trace N times (default 1)
+//   --csv FILE write one line per replayed frame: index, device and replay time
+
+#include "DrawTrace.h"
+#include "Renderer.h"
+#include "SoftwareRenderBackend.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Accepts every batch and draws nothing
+class NullRenderBackend : public RenderBackend {
+public:
+    NullRenderBackend() : m_nextTexture(1) {}
+    
+    bool initialize(int, int) override { return true; }
+    void cleanup() override {}
+    void resize(int, int) override {}
+    
+    void beginFrame() override {}
+    void clear(float, float, float, float) override {}
+    void setClipRect(const ClipRect*) override {}
+    void drawQuads(const BatchVertex*, int, TextureHandle) override {}
+    void present() override {}
+    
+    TextureHandle createAlphaTexture(const uint8_t*, int, int) override { return m_nextTexture++; }
+    TextureHandle createDistanceFieldTexture(const uint8_t*, int, int) override { return m_nextTexture++; }
+    void destroyTexture(TextureHandle) override {}
+    
+private:
+    TextureHandle m_nextTexture;
+};
+
+struct ReplayFrame {
+    uint32_t deviceUs;
+    uint32_t replayUs;
+    int drawCalls;
+    int quads;
+};
+
+static uint32_t percentile(std::vector<uint32_t>& values, int p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = (values.size() - 1) * p / 100;
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+static void printSummary(const char* label, std::vector<uint32_t> values) {
+    uint32_t maximum = values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+    // Each call reorders the copy, so take the percentiles in ascending order
+    uint32_t p50 = percentile(values, 50);
+    uint32_t p95 = percentile(values, 95);
+    uint32_t p99 = percentile(values, 99);
+    std::printf("%-8s p50 %7u us  p95 %7u us  p99 %7u us  max %7u us\n", label, p50, p95, p99, maximum);
+}
+
+static bool writeCsv(const std::string& path, const std::vector<ReplayFrame>& frames) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+        return false;
+    }
+    
+    std::fprintf(file, "frame,device_us,replay_us,draw_calls,quads\n");
+    for (size_t i = 0; i < frames.size(); ++i) {
+        std::fprintf(file, "%zu,%u,%u,%d,%d\n", i, frames[i].deviceUs, frames[i].replayUs,
+                     frames[i].drawCalls, frames[i].quads);
+    }
+    return std::fclose(file) == 0;
+}
+
+static void printUsage() {
+    std::fprintf(stderr,
+                 "usage: workouttracker_replay [--backend software|null] [--loops N] [--csv FILE] TRACE\n");
+}
+
+int main(int argc, char** argv) {
+    std::string backendName = "software";
+    std::string csvPath;
+    std::string tracePath;
+    int loops = 1;
+    
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--backend") == 0 && hasValue) {
+            backendName = argv[++i];
+        } else if (std::strcmp(argv[i], "--loops") == 0 && hasValue) {
+            loops = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--csv") == 0 && hasValue) {
+            csvPath = argv[++i];
+        } else if (argv[i][0] != '-' && tracePath.empty()) {
+            tracePath = argv[i];
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    
+    if (tracePath.empty() || loops <= 0 || (backendName != "software" && backendName != "null")) {
+        printUsage();
+        return 2;
+    }
+    
+    DrawTracePlayer player;
+    if (!player.open(tracePath)) {
+        return 1;
+    }
+    
+    RenderBackend* backend;
+    if (backendName == "null") {
+        backend = new NullRenderBackend();
+    } else {
+        backend = new SoftwareRenderBackend();
+    }
+    
+    Renderer renderer;
+    if (!renderer.initialize(backend, player.getWidth(), player.getHeight())) {
+        std::fprintf(stderr, "Failed to initialize the %s renderer\n", backendName.c_str());
+        return 1;
+    }
+    
+    typedef std::chrono::steady_clock Clock;
+    std::vector<ReplayFrame> frames;
+    Clock::time_point start = Clock::now();
+    
+    for (int loop = 0; loop < loops; ++loop) {
+        player.rewind();
+        for (;;) {
+            ReplayFrame frame;
+            Clock::time_point frameStart = Clock::now();
+            if (!player.playFrame(&renderer, frame.deviceUs)) {
+                break;
+            }
+            frame.replayUs = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - frameStart).count();
+            frame.drawCalls = renderer.getFrameStats().drawCalls;
+            frame.quads = renderer.getFrameStats().quads;
+            frames.push_back(frame);
+        }
+        if (player.hasError()) {
+            std::fprintf(stderr, "%s is malformed after %zu frames\n", tracePath.c_str(), frames.size());
+            return 1;
+        }
+    }
+    
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    player.reset(&renderer);
+    
+    if (frames.empty()) {
+        std::fprintf(stderr, "%s contains no complete frames\n", tracePath.c_str());
+        return 1;
+    }
+    
+    std::vector<uint32_t> deviceUs;
+    std::vector<uint32_t> replayUs;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        deviceUs.push_back(frames[i].deviceUs);
+        replayUs.push_back(frames[i].replayUs);
+    }
+    
+    std::printf("%s: %d x %d, %zu frames replayed on the %s backend in %.3f s (%.1f fps)\n",
+                tracePath.c_str(), player.getWidth(), player.getHeight(), frames.size(),
+                backendName.c_str(), seconds, frames.size() / seconds);
+    printSummary("device", deviceUs);
+    printSummary("replay", replayUs);
+    
+    if (!csvPath.empty() && !writeCsv(csvPath, frames)) {
+        return 1;
+    }
+    return 0;
+}
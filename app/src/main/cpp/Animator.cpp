@@ -0,0 +1,234 @@
+#include "Animator.h"
+#include <algorithm>
+
+static const uint32_t ANIMATION_SLOT_MASK = 0xFFFF;
+
+float applyEasing(Easing easing, float t) {
+    if (t <= 0.0f) return 0.0f;
+    if (t >= 1.0f) return 1.0f;
+    
+    switch (easing) {
+        case EASE_IN_QUAD:
+            return t * t;
+        case EASE_OUT_QUAD:
+            return t * (2.0f - t);
+        case EASE_IN_OUT_QUAD:
+            return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+        case EASE_OUT_CUBIC: {
+            float u = 1.0f - t;
+            return 1.0f - u * u * u;
+        }
+        case EASE_LINEAR:
+        default:
+            return t;
+    }
+}
+
+AnimationTimeline::AnimationTimeline(int componentCount, const float* from)
+    : m_componentCount(componentCount < MAX_COMPONENTS ? componentCount : MAX_COMPONENTS)
+    , m_stepCount(0)
+    , m_keys()
+    , m_durationsMs()
+    , m_easings()
+    , m_holds()
+{
+    for (int i = 0; i < m_componentCount && from; ++i) {
+        m_keys[0][i] = from[i];
+    }
+}
+
+AnimationTimeline& AnimationTimeline::to(const float* values, int durationMs, Easing easing) {
+    if (m_stepCount < MAX_STEPS) {
+        for (int i = 0; i < m_componentCount; ++i) {
+            m_keys[m_stepCount + 1][i] = values[i];
+        }
+        m_durationsMs[m_stepCount] = durationMs;
+        m_easings[m_stepCount] = easing;
+        m_holds[m_stepCount] = false;
+        m_stepCount++;
+    }
+    return *this;
+}
+
+AnimationTimeline& AnimationTimeline::hold(int durationMs) {
+    if (m_stepCount < MAX_STEPS) {
+        for (int i = 0; i < m_componentCount; ++i) {
+            m_keys[m_stepCount + 1][i] = m_keys[m_stepCount][i];
+        }
+        m_durationsMs[m_stepCount] = durationMs;
+        m_easings[m_stepCount] = EASE_LINEAR;
+        m_holds[m_stepCount] = true;
+        m_stepCount++;
+    }
+    return *this;
+}
+
+Animator::Animator()
+    : m_runningCount(0)
+{
+}
+
+int Animator::findSlot(AnimationKey key) const {
+    for (size_t i = 0; i < m_animations.size(); ++i) {
+        if (m_animations[i].live && m_animations[i].key == key) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void Animator::release(int slot) {
+    Animation& animation = m_animations[slot];
+    animation.live = false;
+    // Generation 0 never occurs, like widget handles
+    animation.generation = animation.generation == 0xFFFF ? 1 : animation.generation + 1;
+    m_freeSlots.push_back(slot);
+    m_runningCount--;
+}
+
+bool Animator::isCurrent(const Deadline& deadline) const {
+    const Animation& animation = m_animations[deadline.id & ANIMATION_SLOT_MASK];
+    return animation.live && animation.generation == deadline.id >> 16;
+}
+
+void Animator::schedule(int slot, Clock::time_point time) {
+    Deadline deadline;
+    deadline.time = time;
+    deadline.id = (uint32_t)m_animations[slot].generation << 16 | (uint32_t)slot;
+    m_queue.push_back(deadline);
+    std::push_heap(m_queue.begin(), m_queue.end(), isLater);
+}
+
+void Animator::pruneQueue() {
+    // Entries of replaced or cancelled animations must not decide the next wakeup
+    while (!m_queue.empty() && !isCurrent(m_queue.front())) {
+        std::pop_heap(m_queue.begin(), m_queue.end(), isLater);
+        m_queue.pop_back();
+    }
+}
+
+void Animator::start(AnimationKey key, const AnimationTimeline& timeline, const ApplyFunc& apply,
+                     Clock::time_point now) {
+    int slot = findSlot(key);
+    if (slot >= 0) {
+        release(slot);
+    }
+    
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = (int)m_animations.size();
+        m_animations.push_back(Animation());
+    }
+    
+    Animation& animation = m_animations[slot];
+    animation.key = key;
+    animation.timeline = timeline;
+    animation.apply = apply;
+    animation.start = now;
+    animation.live = true;
+    m_runningCount++;
+    
+    // The first value shows right away
+    Clock::time_point next;
+    if (step(slot, now, &next)) {
+        schedule(slot, next);
+    } else {
+        release(slot);
+    }
+    pruneQueue();
+}
+
+void Animator::tween(AnimationKey key, int componentCount, const float* from, const float* to,
+                     int durationMs, Easing easing, const ApplyFunc& apply, Clock::time_point now) {
+    AnimationTimeline timeline(componentCount, from);
+    timeline.to(to, durationMs, easing);
+    start(key, timeline, apply, now);
+}
+
+void Animator::cancel(AnimationKey key) {
+    int slot = findSlot(key);
+    if (slot >= 0) {
+        release(slot);
+        pruneQueue();
+    }
+}
+
+bool Animator::isRunning(AnimationKey key) const {
+    return findSlot(key) >= 0;
+}
+
+bool Animator::step(int slot, Clock::time_point now, Clock::time_point* next) {
+    Animation& animation = m_animations[slot];
+    const AnimationTimeline& timeline = animation.timeline;
+    float elapsedMs = std::chrono::duration<float, std::milli>(now - animation.start).count();
+    
+    float values[AnimationTimeline::MAX_COMPONENTS];
+    int stepStartMs = 0;
+    for (int i = 0; i < timeline.m_stepCount; ++i) {
+        int stepEndMs = stepStartMs + timeline.m_durationsMs[i];
+        if (elapsedMs < (float)stepEndMs) {
+            float t = applyEasing(timeline.m_easings[i], (elapsedMs - stepStartMs) / timeline.m_durationsMs[i]);
+            for (int c = 0; c < timeline.m_componentCount; ++c) {
+                float from = timeline.m_keys[i][c];
+                values[c] = from + (timeline.m_keys[i + 1][c] - from) * t;
+            }
+            animation.apply(values);
+            
+            // A hold needs no frames until it ends; a move needs every frame
+            *next = timeline.m_holds[i] ? animation.start + std::chrono::milliseconds(stepEndMs) : now;
+            return true;
+        }
+        stepStartMs = stepEndMs;
+    }
+    
+    // Over: land exactly on the last value
+    animation.apply(timeline.m_keys[timeline.m_stepCount]);
+    return false;
+}
+
+bool Animator::update(Clock::time_point now) {
+    // Take everything due first: moving steps are due again at now
+    m_due.clear();
+    while (!m_queue.empty() && m_queue.front().time <= now) {
+        std::pop_heap(m_queue.begin(), m_queue.end(), isLater);
+        m_due.push_back(m_queue.back());
+        m_queue.pop_back();
+    }
+    
+    bool applied = false;
+    for (size_t i = 0; i < m_due.size(); ++i) {
+        if (!isCurrent(m_due[i])) {
+            continue;
+        }
+        
+        int slot = (int)(m_due[i].id & ANIMATION_SLOT_MASK);
+        Clock::time_point next;
+        if (step(slot, now, &next)) {
+            schedule(slot, next);
+        } else {
+            release(slot);
+        }
+        applied = true;
+    }
+    pruneQueue();
+    return applied;
+}
+
+int Animator::getMillisUntilNextFrame(Clock::time_point now) const {
+    if (m_queue.empty()) {
+        return -1;
+    }
+    
+    Clock::duration remaining = m_queue.front().time - now;
+    if (remaining <= Clock::duration::zero()) {
+        return 0;
+    }
+    // Round up so the wakeup does not come just before the deadline
+    std::chrono::milliseconds remainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(remaining);
+    if (remainingMs < remaining) {
+        remainingMs += std::chrono::milliseconds(1);
+    }
+    return (int)remainingMs.count();
+}
@@ -0,0 +1,115 @@
+#ifndef ANIMATOR_H
+#define ANIMATOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+enum Easing {
+    EASE_LINEAR,
+    EASE_IN_QUAD,
+    EASE_OUT_QUAD,
+    EASE_IN_OUT_QUAD,
+    EASE_OUT_CUBIC
+};
+
+// Value at t in [0, 1] of the easing curve, 0 at the start and 1 at the end
+float applyEasing(Easing easing, float t);
+
+// Chosen by the caller; starting an animation replaces the running one with
+// the same key
+typedef uint64_t AnimationKey;
+
+// A value of up to MAX_COMPONENTS floats (alpha or scroll offset, position,
+// color) moving through a chain of steps: eased moves to a new value and
+// holds that keep the current one
+class AnimationTimeline {
+public:
+    static const int MAX_COMPONENTS = 4;
+    static const int MAX_STEPS = 4;
+    
+    AnimationTimeline(int componentCount, const float* from);
+    
+    // Steps beyond MAX_STEPS are ignored
+    AnimationTimeline& to(const float* values, int durationMs, Easing easing);
+    AnimationTimeline& hold(int durationMs);
+    
+private:
+    friend class Animator;
+    
+    int m_componentCount;
+    int m_stepCount;
+    // Value before each step and after the last one
+    float m_keys[MAX_STEPS + 1][MAX_COMPONENTS];
+    int m_durationsMs[MAX_STEPS];
+    Easing m_easings[MAX_STEPS];
+    bool m_holds[MAX_STEPS];
+};
+
+// Runs tweens and timelines on steady_clock, driven by one queue ordered by
+// the time each animation next needs a frame. Holds sleep until they end;
+// moving steps are due on every frame. One update() steps every due animation
+// once, however many are running.
+class Animator {
+public:
+    typedef std::chrono::steady_clock Clock;
+    // Receives the current values on every step, the final values last; it
+    // must not start or cancel animations
+    typedef std::function<void(const float* values)> ApplyFunc;
+    
+    Animator();
+    
+    void start(AnimationKey key, const AnimationTimeline& timeline, const ApplyFunc& apply,
+               Clock::time_point now);
+    // Single eased move from one value to another
+    void tween(AnimationKey key, int componentCount, const float* from, const float* to,
+               int durationMs, Easing easing, const ApplyFunc& apply, Clock::time_point now);
+    // Stops without applying anything further; the value stays where it is
+    void cancel(AnimationKey key);
+    bool isRunning(AnimationKey key) const;
+    size_t getRunningCount() const { return m_runningCount; }
+    
+    // Steps the due animations; returns true when any of them applied values
+    bool update(Clock::time_point now);
+    
+    // 0 while a value is moving, the time to the end of the earliest hold
+    // otherwise, -1 with nothing running
+    int getMillisUntilNextFrame(Clock::time_point now) const;
+    
+private:
+    struct Animation {
+        AnimationKey key;
+        AnimationTimeline timeline;
+        ApplyFunc apply;
+        Clock::time_point start;
+        uint16_t generation;
+        bool live;
+        
+        Animation() : key(0), timeline(0, nullptr), generation(1), live(false) {}
+    };
+    
+    // Min-heap entry; stale once the animation's generation moved on
+    struct Deadline {
+        Clock::time_point time;
+        uint32_t id;
+    };
+    
+    std::vector<Animation> m_animations;
+    std::vector<int> m_freeSlots;
+    std::vector<Deadline> m_queue;
+    std::vector<Deadline> m_due;
+    size_t m_runningCount;
+    
+    // Heap order: earliest deadline on top
+    static bool isLater(const Deadline& a, const Deadline& b) { return a.time > b.time; }
+    int findSlot(AnimationKey key) const;
+    void release(int slot);
+    bool isCurrent(const Deadline& deadline) const;
+    void schedule(int slot, Clock::time_point time);
+    void pruneQueue();
+    // Applies the value at now; returns false once the timeline is over
+    bool step(int slot, Clock::time_point now, Clock::time_point* next);
+};
+
+#endif // ANIMATOR_H
@@ -1,6 +1,9 @@
 #include "App.h"
+#include "GLRenderBackend.h"
+#include <android/asset_manager.h>
 #include <android/log.h>
 #include <android/native_window.h>
+#include <unistd.h>
 #include <jni.h>
 
 #define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "WorkoutTracker", __VA_ARGS__))
@@ -16,8 +19,14 @@ App::App()
     , m_width(0)
     , m_height(0)
     , m_bottomInset(0)
+    , m_softInputShown(false)
+    , m_traceToggleRequested(false)
     , m_javaVM(nullptr)
 {
+#ifndef NDEBUG
+    // Poison reset arena memory and log new usage peaks in debug builds
+    m_frameArena.setDebugMode(true);
+#endif
 }
 
 App::~App() {
@@ -31,6 +40,11 @@ bool App::initialize(android_app* app) {
     
     m_app = app;
     
+    if (app && app->activity && app->activity->internalDataPath) {
+        m_profiler.setOutputDirectory(app->activity->internalDataPath);
+        m_traceDirectory = app->activity->internalDataPath;
+    }
+    
     // JavaVM will be retrieved lazily when needed (not during initialization)
     // This avoids crashes if activity->env is null at this point
     
@@ -40,6 +54,15 @@ bool App::initialize(android_app* app) {
         LOGE("Failed to create WorkoutTracker");
         return false;
     }
+    m_workoutTracker->setProfiler(&m_profiler);
+#ifndef NDEBUG
+    m_workoutTracker->setVerifyStats(true);
+#endif
+    if (loadFontAsset()) {
+        m_workoutTracker->setFontAsset(&m_fontAsset);
+    }
+    loadExerciseCatalog();
+    openJournal();
     
     // Create input handler
     m_inputHandler = new InputHandler();
@@ -71,20 +94,105 @@ void App::cleanup() {
         delete m_workoutTracker;
         m_workoutTracker = nullptr;
     }
+    m_journal.close();
+    m_fontAsset.close();
+    m_exerciseCatalog.close();
     
     m_initialized = false;
     m_windowReady = false;
     LOGI("App cleaned up");
 }
 
+// The asset is stored uncompressed (noCompress in build.gradle), so it can be
+// mapped straight out of the APK: startup cost is independent of glyph count
+bool App::loadFontAsset() {
+    if (!m_app || !m_app->activity || !m_app->activity->assetManager) {
+        return false;
+    }
+    
+    AAsset* asset = AAssetManager_open(m_app->activity->assetManager, "fonts/ui.sdf", AASSET_MODE_UNKNOWN);
+    if (!asset) {
+        LOGI("No font asset, using the bitmap font");
+        return false;
+    }
+    
+    off64_t offset = 0;
+    off64_t length = 0;
+    int fd = AAsset_openFileDescriptor64(asset, &offset, &length);
+    bool loaded = fd >= 0 && m_fontAsset.openDescriptor(fd, (off_t)offset, (size_t)length);
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    AAsset_close(asset);
+    
+    if (!loaded) {
+        LOGE("Failed to map font asset, using the bitmap font");
+    }
+    return loaded;
+}
+
+// Stored uncompressed and mapped like the font; without it the tracker keeps
+// its built-in catalog
+void App::loadExerciseCatalog() {
+    if (!m_app || !m_app->activity || !m_app->activity->assetManager) {
+        return;
+    }
+    
+    AAsset* asset = AAssetManager_open(m_app->activity->assetManager, "exercises.cat", AASSET_MODE_UNKNOWN);
+    if (!asset) {
+        LOGI("No exercise catalog, using the built-in list");
+        return;
+    }
+    
+    off64_t offset = 0;
+    off64_t length = 0;
+    int fd = AAsset_openFileDescriptor64(asset, &offset, &length);
+    bool loaded = fd >= 0 && m_exerciseCatalog.openDescriptor(fd, (off_t)offset, (size_t)length);
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    AAsset_close(asset);
+    
+    if (loaded) {
+        m_workoutTracker->setExerciseCatalog(&m_exerciseCatalog);
+    } else {
+        LOGE("Failed to map exercise catalog, using the built-in list");
+    }
+}
+
+// Recovers the last session, including a workout still in progress
+void App::openJournal() {
+    if (!m_app || !m_app->activity || !m_app->activity->internalDataPath) {
+        return;
+    }
+    
+    JournalRecovery recovery;
+    if (!m_journal.open(std::string(m_app->activity->internalDataPath) + "/workouts", recovery)) {
+        LOGE("Workout journal unavailable, workouts will not be saved");
+        return;
+    }
+    if (recovery.tornBytes > 0) {
+        LOGI("Workout journal lost %zu bytes of an interrupted write", recovery.tornBytes);
+    }
+    m_workoutTracker->restoreWorkouts(recovery);
+    m_workoutTracker->setJournal(&m_journal);
+}
+
 void App::update() {
+    m_scheduler.onWakeup();
+    
     if (!m_initialized || !m_windowReady) {
         return;
     }
     
     // Update workout tracker
     if (m_workoutTracker) {
-        m_workoutTracker->update();
+        {
+            ProfileScope updateScope(&m_profiler, FrameProfiler::PHASE_UPDATE);
+            m_workoutTracker->update();
+        }
+        // Clock ticks and pending button releases need a frame even without input
+        m_scheduler.requestFrameIn(m_workoutTracker->getMillisUntilNextUpdate());
     }
 }
 
@@ -93,6 +201,22 @@ void App::render() {
         return;
     }
     
+    // Nothing changed since the last frame; keep the previous one on screen
+    if (!m_scheduler.isFrameDue()) {
+        return;
+    }
+    
+    // A deadline passed but the scene is clean: skip geometry and the buffer swap
+    if (m_workoutTracker && !m_workoutTracker->needsRedraw()) {
+        m_scheduler.onFrameSkipped();
+        return;
+    }
+    
+    if (m_traceToggleRequested) {
+        applyTraceToggle();
+    }
+    
+    m_profiler.beginPhase(FrameProfiler::PHASE_RENDER);
     m_renderer->beginFrame();
     
     // Render workout tracker UI
@@ -100,7 +224,16 @@ void App::render() {
         m_workoutTracker->render(m_renderer);
     }
     
+    // Submit the batch here so the swap phase measures only the swap
+    m_renderer->flush();
+    m_profiler.endPhase(FrameProfiler::PHASE_RENDER);
+    
+    m_profiler.beginPhase(FrameProfiler::PHASE_SWAP);
     m_renderer->endFrame();
+    m_profiler.endPhase(FrameProfiler::PHASE_SWAP);
+    
+    m_profiler.endFrame(m_renderer->getFrameStats());
+    m_scheduler.onFrameRendered();
 }
 
 void App::handleCommand(int32_t cmd) {
@@ -109,12 +242,12 @@ void App::handleCommand(int32_t cmd) {
             LOGI("APP_CMD_INIT_WINDOW");
             processWindowCommand(cmd);
             break;
-            
+        
         case APP_CMD_TERM_WINDOW:
             LOGI("APP_CMD_TERM_WINDOW");
             processWindowCommand(cmd);
             break;
-            
+        
         case APP_CMD_WINDOW_RESIZED:
             LOGI("APP_CMD_WINDOW_RESIZED");
             if (m_app && m_app->window) {
@@ -126,43 +259,63 @@ void App::handleCommand(int32_t cmd) {
             }
             processWindowCommand(cmd);
             break;
-            
+        
+        case APP_CMD_WINDOW_REDRAW_NEEDED:
+            LOGI("APP_CMD_WINDOW_REDRAW_NEEDED");
+            if (m_workoutTracker) {
+                m_workoutTracker->requestRedraw();
+            }
+            break;
+        
         case APP_CMD_GAINED_FOCUS:
             LOGI("APP_CMD_GAINED_FOCUS");
             break;
-            
+        
         case APP_CMD_LOST_FOCUS:
             LOGI("APP_CMD_LOST_FOCUS");
             break;
-            
+        
         case APP_CMD_PAUSE:
             LOGI("APP_CMD_PAUSE");
+            // The process may be killed without further notice from here on
+            if (!m_journal.flush()) {
+                LOGE("Workout journal not saved, retrying in the background");
+            }
             break;
-            
+        
         case APP_CMD_RESUME:
             LOGI("APP_CMD_RESUME");
             break;
-            
+        
         case APP_CMD_START:
             LOGI("APP_CMD_START");
             break;
-            
+        
         case APP_CMD_STOP:
             LOGI("APP_CMD_STOP");
+            if (!m_journal.flush()) {
+                LOGE("Workout journal not saved, retrying in the background");
+            }
             break;
-            
+        
         case APP_CMD_DESTROY:
             LOGI("APP_CMD_DESTROY");
             cleanup();
             break;
-            
+        
         case APP_CMD_CONFIG_CHANGED:
             LOGI("APP_CMD_CONFIG_CHANGED");
             break;
-            
+        
         default:
             break;
     }
+    
+    // Window, focus and lifecycle changes are rare; redraw after any of them
+    // that leaves a window to draw into, including APP_CMD_INIT_WINDOW
+    if (m_windowReady) {
+        m_scheduler.invalidate();
+    }
 }
 
 int32_t App::handleInput(AInputEvent* event) {
@@ -170,7 +323,49 @@ int32_t App::handleInput(AInputEvent* event) {
         return 0;
     }
     
-    return m_inputHandler->handleEvent(event, m_workoutTracker);
+    // Trace capture belongs to the renderer, not the UI (adb shell input keyevent KEYCODE_MEDIA_RECORD)
+    if (AInputEvent_getType(event) == AINPUT_EVENT_TYPE_KEY &&
+        AKeyEvent_getKeyCode(event) == AKEYCODE_MEDIA_RECORD) {
+        if (AKeyEvent_getAction(event) == AKEY_EVENT_ACTION_DOWN) {
+            m_traceToggleRequested = true;
+            // The first traced frame also starts with a full redraw
+            m_workoutTracker->requestRedraw();
+            m_scheduler.invalidate();
+        }
+        return 1;
+    }
+    
+    ProfileScope inputScope(&m_profiler, FrameProfiler::PHASE_INPUT);
+    int32_t handled = m_inputHandler->handleEvent(event, m_workoutTracker);
+    if (handled) {
+        m_scheduler.invalidate();
+    }
+    
+    // The keyboard follows the picker: up while it is open, down once it closes
+    bool textInput = m_workoutTracker->isTextInputActive();
+    if (textInput != m_softInputShown && m_app && m_app->activity) {
+        if (textInput) {
+            ANativeActivity_showSoftInput(m_app->activity, ANATIVEACTIVITY_SHOW_SOFT_INPUT_IMPLICIT);
+        } else {
+            ANativeActivity_hideSoftInput(m_app->activity, 0);
+        }
+        m_softInputShown = textInput;
+    }
+    return handled;
+}
+
+void App::applyTraceToggle() {
+    m_traceToggleRequested = false;
+    if (m_renderer->isTracing()) {
+        m_renderer->stopTrace();
+        return;
+    }
+    
+    if (m_traceDirectory.empty()) {
+        LOGE("No output directory for draw trace");
+        return;
+    }
+    m_renderer->startTrace(m_traceDirectory + "/draw_trace.bin");
 }
 
 JNIEnv* App::getJNIEnv() {
@@ -381,6 +576,11 @@ void App::updateBottomInset() {
 }
 
 void App::processWindowCommand(int32_t cmd) {
+    // A new or resized surface has no valid contents yet
+    if (m_workoutTracker) {
+        m_workoutTracker->requestRedraw();
+    }
+    
     if (cmd == APP_CMD_INIT_WINDOW) {
         if (m_app && m_app->window && !m_windowReady) {
             m_width = ANativeWindow_getWidth(m_app->window);
@@ -394,7 +594,8 @@ void App::processWindowCommand(int32_t cmd) {
             // Create renderer
             if (!m_renderer) {
                 m_renderer = new Renderer();
-                if (m_renderer && m_renderer->initialize(m_app->window, m_width, m_height)) {
+                m_renderer->setFrameArena(&m_frameArena);
+                if (m_renderer && m_renderer->initialize(new GLRenderBackend(m_app->window), m_width, m_height)) {
                     m_windowReady = true;
                     LOGI("Renderer initialized successfully");
                     
@@ -5,6 +5,11 @@
 #include "Renderer.h"
 #include "InputHandler.h"
 #include "WorkoutTracker.h"
+#include "FrameScheduler.h"
+#include "FrameProfiler.h"
+#include "FontAsset.h"
+#include "ExerciseCatalog.h"
+#include "WorkoutJournal.h"
 #include <jni.h>
 
 class App {
@@ -19,20 +24,44 @@ public:
     void handleCommand(int32_t cmd);
     int32_t handleInput(AInputEvent* event);
     
+    // How long the main loop may sleep in the looper before the next frame is
+    // needed; without a window nothing can be drawn, so until the next event
+    int getPollTimeoutMs() const { return m_windowReady && m_renderer ? m_scheduler.getPollTimeoutMs() : -1; }
+    
 private:
     android_app* m_app;
     Renderer* m_renderer;
     InputHandler* m_inputHandler;
     WorkoutTracker* m_workoutTracker;
+    FrameScheduler m_scheduler;
+    FrameProfiler m_profiler;
+    // Frame-transient scratch for the renderer and UI, reset every beginFrame
+    FrameArena m_frameArena;
+    // Mapped from the APK for the app's lifetime; the bitmap font is used without it
+    FontAsset m_fontAsset;
+    // Mapped the same way; the tracker's built-in catalog is used without it
+    ExerciseCatalog m_exerciseCatalog;
+    // Every workout change, committed to internal storage
+    WorkoutJournal m_journal;
     
     bool m_initialized;
     bool m_windowReady;
     int m_width;
     int m_height;
     int m_bottomInset;
+    // Soft keyboard shown for the exercise search
+    bool m_softInputShown;
     
     void processWindowCommand(int32_t cmd);
     void updateBottomInset();
+    bool loadFontAsset();
+    void loadExerciseCatalog();
+    void openJournal();
+    
+    // Draw trace capture, toggled by KEYCODE_MEDIA_RECORD and applied between frames
+    bool m_traceToggleRequested;
+    std::string m_traceDirectory;
+    void applyTraceToggle();
     int getBottomInset() const { return m_bottomInset; }
     
     // JNI helper methods
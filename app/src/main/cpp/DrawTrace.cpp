@@ -0,0 +1,416 @@
+#include "DrawTrace.h"
+#include "Renderer.h"
+#include <android/log.h>
+#include <cstring>
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "DrawTrace", __VA_ARGS__))
+#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "DrawTrace", __VA_ARGS__))
+
+// Typical frame of cached geometry is a few hundred bytes; a full rebuild a few KB
+static const size_t TRACE_FRAME_RESERVE = 16 * 1024;
+
+DrawTraceWriter::DrawTraceWriter()
+    : m_file(nullptr)
+    , m_nextCacheId(1)
+    , m_stopping(false)
+{
+}
+
+DrawTraceWriter::~DrawTraceWriter() {
+    close();
+}
+
+bool DrawTraceWriter::open(const std::string& path, int width, int height) {
+    close();
+    
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        LOGE("Cannot open draw trace %s", path.c_str());
+        return false;
+    }
+    
+    DrawTraceHeader header;
+    header.magic = DRAW_TRACE_MAGIC;
+    header.version = DRAW_TRACE_VERSION;
+    header.vertexSize = sizeof(BatchVertex);
+    header.width = width;
+    header.height = height;
+    
+    m_buffer.clear();
+    m_buffer.reserve(TRACE_FRAME_RESERVE);
+    writeBytes(&header, sizeof(header));
+    
+    m_caches.clear();
+    m_nextCacheId = 1;
+    m_start = Clock::now();
+    m_stopping = false;
+    m_thread = std::thread(&DrawTraceWriter::run, this);
+    
+    LOGI("Draw trace started: %s", path.c_str());
+    return true;
+}
+
+void DrawTraceWriter::close() {
+    if (!m_file) {
+        return;
+    }
+    
+    submit();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    
+    std::fclose(m_file);
+    m_file = nullptr;
+    m_pending.clear();
+    m_spare.clear();
+    LOGI("Draw trace closed");
+}
+
+void DrawTraceWriter::writeBytes(const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}
+
+uint32_t DrawTraceWriter::getCacheId(const GeometryCache* cache, bool& defined) {
+    std::unordered_map<const GeometryCache*, CacheEntry>::iterator it = m_caches.find(cache);
+    if (it == m_caches.end()) {
+        CacheEntry entry;
+        entry.id = m_nextCacheId++;
+        entry.defined = false;
+        it = m_caches.insert(std::make_pair(cache, entry)).first;
+    }
+    defined = it->second.defined;
+    return it->second.id;
+}
+
+void DrawTraceWriter::setCacheDefined(const GeometryCache* cache) {
+    bool defined;
+    getCacheId(cache, defined);
+    m_caches[cache].defined = true;
+}
+
+uint64_t DrawTraceWriter::getElapsedUs() const {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_start).count();
+}
+
+void DrawTraceWriter::submit() {
+    if (!m_file || m_buffer.empty()) {
+        return;
+    }
+    
+    // Swap in a recycled buffer so the next frame starts with its capacity
+    std::vector<uint8_t> next;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(std::vector<uint8_t>());
+        m_pending.back().swap(m_buffer);
+        if (!m_spare.empty()) {
+            next.swap(m_spare.back());
+            m_spare.pop_back();
+        }
+    }
+    m_wake.notify_one();
+    
+    m_buffer.swap(next);
+    m_buffer.clear();
+    if (m_buffer.capacity() < TRACE_FRAME_RESERVE) {
+        m_buffer.reserve(TRACE_FRAME_RESERVE);
+    }
+}
+
+void DrawTraceWriter::run() {
+    std::vector<std::vector<uint8_t>> batch;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+        if (m_pending.empty() && m_stopping) {
+            break;
+        }
+        
+        batch.swap(m_pending);
+        lock.unlock();
+        
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (std::fwrite(batch[i].data(), 1, batch[i].size(), m_file) != batch[i].size()) {
+                LOGE("Draw trace write failed");
+            }
+            batch[i].clear();
+        }
+        
+        lock.lock();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            m_spare.push_back(std::vector<uint8_t>());
+            m_spare.back().swap(batch[i]);
+        }
+        batch.clear();
+    }
+}
+
+DrawTracePlayer::DrawTracePlayer()
+    : m_offset(0)
+    , m_error(false)
+{
+    std::memset(&m_header, 0, sizeof(m_header));
+}
+
+DrawTracePlayer::~DrawTracePlayer() {
+    for (std::unordered_map<uint32_t, GeometryCache*>::iterator it = m_caches.begin(); it != m_caches.end(); ++it) {
+        delete it->second;
+    }
+}
+
+bool DrawTracePlayer::open(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        LOGE("Cannot open draw trace %s", path.c_str());
+        return false;
+    }
+    
+    m_data.clear();
+    uint8_t chunk[64 * 1024];
+    size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        m_data.insert(m_data.end(), chunk, chunk + count);
+    }
+    std::fclose(file);
+    
+    if (m_data.size() < sizeof(DrawTraceHeader)) {
+        LOGE("Draw trace %s is truncated", path.c_str());
+        return false;
+    }
+    
+    std::memcpy(&m_header, m_data.data(), sizeof(m_header));
+    if (m_header.magic != DRAW_TRACE_MAGIC || m_header.version != DRAW_TRACE_VERSION ||
+        m_header.vertexSize != sizeof(BatchVertex)) {
+        LOGE("Draw trace %s has an unsupported format", path.c_str());
+        return false;
+    }
+    
+    rewind();
+    return true;
+}
+
+void DrawTracePlayer::rewind() {
+    m_offset = sizeof(DrawTraceHeader);
+    m_error = false;
+}
+
+void DrawTracePlayer::reset(Renderer* renderer) {
+    for (std::unordered_map<uint32_t, TextureHandle>::iterator it = m_textures.begin(); it != m_textures.end(); ++it) {
+        renderer->destroyTexture(it->second);
+    }
+    m_textures.clear();
+    
+    for (std::unordered_map<uint32_t, GeometryCache*>::iterator it = m_caches.begin(); it != m_caches.end(); ++it) {
+        it->second->clear();
+    }
+}
+
+bool DrawTracePlayer::read(void* out, size_t size) {
+    if (m_data.size() - m_offset < size) {
+        m_error = true;
+        return false;
+    }
+    std::memcpy(out, m_data.data() + m_offset, size);
+    m_offset += size;
+    return true;
+}
+
+GeometryCache* DrawTracePlayer::getCache(uint32_t id) {
+    GeometryCache*& cache = m_caches[id];
+    if (!cache) {
+        cache = new GeometryCache();
+    }
+    return cache;
+}
+
+TextureHandle DrawTracePlayer::mapTexture(uint32_t traced) const {
+    std::unordered_map<uint32_t, TextureHandle>::const_iterator it = m_textures.find(traced);
+    return it != m_textures.end() ? it->second : 0;
+}
+
+bool DrawTracePlayer::playFrame(Renderer* renderer, uint32_t& deviceUs) {
+    bool frameEnded = false;
+    while (!frameEnded) {
+        uint8_t op;
+        if (m_offset >= m_data.size() || !read(&op, 1)) {
+            return false;
+        }
+        if (!playRecord(renderer, op, frameEnded, deviceUs)) {
+            if (!m_error) {
+                LOGE("Unknown draw trace record %d at offset %zu", op, m_offset - 1);
+            }
+            m_error = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DrawTracePlayer::playRecord(Renderer* renderer, uint8_t op, bool& frameEnded, uint32_t& deviceUs) {
+    float v[13];
+    uint32_t id;
+    
+    switch (op) {
+        case TRACE_FRAME_BEGIN: {
+            uint64_t timestampUs;
+            if (!read(&timestampUs, sizeof(timestampUs))) return false;
+            renderer->beginFrame();
+            return true;
+        }
+        case TRACE_FRAME_END:
+            if (!read(&deviceUs, sizeof(deviceUs))) return false;
+            renderer->endFrame();
+            frameEnded = true;
+            return true;
+        case TRACE_RESIZE: {
+            int32_t size[2];
+            if (!read(size, sizeof(size))) return false;
+            renderer->onWindowResized(size[0], size[1]);
+            return true;
+        }
+        case TRACE_CLEAR:
+            if (!readFloats(v, 4)) return false;
+            renderer->clear(v[0], v[1], v[2], v[3]);
+            return true;
+        case TRACE_FLUSH:
+            renderer->flush();
+            return true;
+        case TRACE_RECT:
+            if (!readFloats(v, 8)) return false;
+            renderer->drawRect(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+            return true;
+        case TRACE_ROUNDED_RECT:
+            if (!readFloats(v, 9)) return false;
+            renderer->drawRoundedRect(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8]);
+            return true;
+        case TRACE_STROKE_ROUNDED_RECT:
+            if (!readFloats(v, 10)) return false;
+            renderer->strokeRoundedRect(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9]);
+            return true;
+        case TRACE_CIRCLE:
+            if (!readFloats(v, 7)) return false;
+            renderer->drawCircle(v[0], v[1], v[2], v[3], v[4], v[5], v[6]);
+            return true;
+        case TRACE_RING:
+            if (!readFloats(v, 8)) return false;
+            renderer->drawRing(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+            return true;
+        case TRACE_TEXTURED_RECT:
+            if (!readFloats(v, 8) || !read(&id, sizeof(id)) || !readFloats(v + 8, 4)) return false;
+            renderer->drawTexturedRect(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], mapTexture(id),
+                                       v[8], v[9], v[10], v[11]);
+            return true;
+        case TRACE_CREATE_TEXTURE:
+        case TRACE_CREATE_DISTANCE_FIELD_TEXTURE: {
+            int32_t size[2];
+            if (!read(&id, sizeof(id)) || !read(size, sizeof(size)) || size[0] <= 0 || size[1] <= 0) return false;
+            size_t bytes = (size_t)size[0] * size[1];
+            if (m_data.size() - m_offset < bytes) {
+                m_error = true;
+                return false;
+            }
+            // Replaying the trace again recreates its textures
+            TextureHandle previous = mapTexture(id);
+            if (previous != 0) {
+                renderer->destroyTexture(previous);
+            }
+            if (op == TRACE_CREATE_DISTANCE_FIELD_TEXTURE) {
+                m_textures[id] = renderer->createDistanceFieldTexture(m_data.data() + m_offset, size[0], size[1]);
+            } else {
+                m_textures[id] = renderer->createAlphaTexture(m_data.data() + m_offset, size[0], size[1]);
+            }
+            m_offset += bytes;
+            return true;
+        }
+        case TRACE_DESTROY_TEXTURE:
+            if (!read(&id, sizeof(id))) return false;
+            renderer->destroyTexture(mapTexture(id));
+            m_textures.erase(id);
+            return true;
+        case TRACE_BEGIN_RECORDING: {
+            if (!read(&id, sizeof(id))) return false;
+            GeometryCache* cache = getCache(id);
+            cache->clear();
+            renderer->beginRecording(cache);
+            return true;
+        }
+        case TRACE_END_RECORDING:
+            renderer->endRecording();
+            return true;
+        case TRACE_DRAW_GEOMETRY:
+            if (!read(&id, sizeof(id))) return false;
+            renderer->drawGeometry(*getCache(id));
+            return true;
+        case TRACE_DEFINE_GEOMETRY: {
+            uint32_t runCount;
+            if (!read(&id, sizeof(id)) || !read(&runCount, sizeof(runCount))) return false;
+            GeometryCache* cache = getCache(id);
+            cache->clear();
+            uint64_t runVertices = 0;
+            for (uint32_t i = 0; i < runCount; ++i) {
+                uint32_t texture;
+                GeometryCache::Run run;
+                if (!read(&texture, sizeof(texture)) || !read(&run.vertexCount, sizeof(run.vertexCount))) return false;
+                if (run.vertexCount < 0) {
+                    cache->clear();
+                    m_error = true;
+                    return false;
+                }
+                run.texture = mapTexture(texture);
+                cache->runs.push_back(run);
+                runVertices += (uint64_t)run.vertexCount;
+            }
+            uint32_t vertexCount;
+            if (!read(&vertexCount, sizeof(vertexCount))) return false;
+            // Sized from the payload only once it is known to hold the vertices,
+            // and the runs must cover exactly those
+            size_t bytes = (size_t)vertexCount * sizeof(BatchVertex);
+            if (runVertices != vertexCount || m_data.size() - m_offset < bytes) {
+                cache->clear();
+                m_error = true;
+                return false;
+            }
+            cache->vertices.resize(vertexCount);
+            if (!read(cache->vertices.data(), bytes)) return false;
+            cache->updateBounds();
+            return true;
+        }
+        case TRACE_QUADS:
+        case TRACE_QUAD_RUN: {
+            uint32_t quadCount;
+            if (!read(&id, sizeof(id))) return false;
+            if (op == TRACE_QUAD_RUN && !readFloats(v, 6)) return false;
+            if (!read(&quadCount, sizeof(quadCount))) return false;
+            size_t bytes = (size_t)quadCount * 4 * sizeof(BatchVertex);
+            if (m_data.size() - m_offset < bytes) {
+                m_error = true;
+                return false;
+            }
+            // Trace payloads carry no alignment guarantee
+            m_quadScratch.resize((size_t)quadCount * 4);
+            std::memcpy(m_quadScratch.data(), m_data.data() + m_offset, bytes);
+            m_offset += bytes;
+            if (op == TRACE_QUAD_RUN) {
+                renderer->drawQuadRun(m_quadScratch.data(), (int)quadCount, mapTexture(id),
+                                      v[0], v[1], v[2], v[3], v[4], v[5]);
+            } else {
+                renderer->drawQuads(m_quadScratch.data(), (int)quadCount, mapTexture(id));
+            }
+            return true;
+        }
+        case TRACE_PUSH_CLIP:
+            if (!readFloats(v, 4)) return false;
+            renderer->pushClipRect(v[0], v[1], v[2], v[3]);
+            return true;
+        case TRACE_POP_CLIP:
+            renderer->popClipRect();
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,152 @@
+#ifndef DRAW_TRACE_H
+#define DRAW_TRACE_H
+
+#include "RenderBackend.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Renderer;
+struct GeometryCache;
+
+// Binary trace of Renderer calls: a header followed by records, each a one-byte
+// opcode and its payload. Values are stored in native little-endian order.
+// Texture handles and geometry cache ids refer to earlier records of the
+// same trace, never to the capturing device.
+enum DrawTraceOp {
+    TRACE_FRAME_BEGIN = 1,      // u64 microseconds since capture start
+    TRACE_FRAME_END,            // u32 microseconds from beginFrame to present on the capturing device
+    TRACE_RESIZE,               // i32 width, i32 height
+    TRACE_CLEAR,                // f32 color[4]
+    TRACE_FLUSH,
+    TRACE_RECT,                 // f32 rect[4], f32 color[4]
+    TRACE_ROUNDED_RECT,         // f32 rect[4], f32 radius, f32 color[4]
+    TRACE_STROKE_ROUNDED_RECT,  // f32 rect[4], f32 radius, f32 strokeWidth, f32 color[4]
+    TRACE_CIRCLE,               // f32 center[2], f32 radius, f32 color[4]
+    TRACE_RING,                 // f32 center[2], f32 radius, f32 thickness, f32 color[4]
+    TRACE_TEXTURED_RECT,        // f32 rect[4], f32 uv[4], u32 texture, f32 color[4]
+    TRACE_CREATE_TEXTURE,       // u32 texture, i32 width, i32 height, u8 alpha[width * height]
+    TRACE_DESTROY_TEXTURE,      // u32 texture
+    TRACE_BEGIN_RECORDING,      // u32 cache
+    TRACE_END_RECORDING,
+    TRACE_DRAW_GEOMETRY,        // u32 cache
+    TRACE_DEFINE_GEOMETRY,      // u32 cache, u32 runCount, {u32 texture, i32 vertexCount}[runCount],
+                                // u32 vertexCount, BatchVertex[vertexCount]
+    TRACE_QUADS,                // u32 texture, u32 quadCount, BatchVertex[quadCount * 4]
+    TRACE_QUAD_RUN,             // u32 texture, f32 offset[2], f32 color[4], u32 quadCount,
+                                // BatchVertex[quadCount * 4]
+    TRACE_CREATE_DISTANCE_FIELD_TEXTURE, // same payload as TRACE_CREATE_TEXTURE
+    TRACE_PUSH_CLIP,            // f32 rect[4]
+    TRACE_POP_CLIP
+};
+
+struct DrawTraceHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexSize;    // sizeof(BatchVertex) of the capturing build
+    int32_t width;
+    int32_t height;
+};
+
+static const uint32_t DRAW_TRACE_MAGIC = 0x43525457; // "WTRC"
+static const uint32_t DRAW_TRACE_VERSION = 1;
+
+// Encodes records into an in-memory frame buffer; submit() hands the buffer to
+// a background thread that appends it to the file, so capture never waits on I/O.
+class DrawTraceWriter {
+public:
+    DrawTraceWriter();
+    ~DrawTraceWriter();
+    
+    bool open(const std::string& path, int width, int height);
+    // Writes everything still queued and stops the writer thread
+    void close();
+    bool isOpen() const { return m_file != nullptr; }
+    
+    void writeOp(DrawTraceOp op) { m_buffer.push_back((uint8_t)op); }
+    void writeU32(uint32_t value) { writeBytes(&value, sizeof(value)); }
+    void writeI32(int32_t value) { writeBytes(&value, sizeof(value)); }
+    void writeU64(uint64_t value) { writeBytes(&value, sizeof(value)); }
+    void writeFloats(const float* values, int count) { writeBytes(values, sizeof(float) * count); }
+    void writeBytes(const void* data, size_t size);
+    
+    // Ids are assigned on first use. A cache counts as defined once the trace
+    // holds its contents (recorded or snapshotted); ids of caches that were
+    // never defined in this trace must be followed by TRACE_DEFINE_GEOMETRY.
+    uint32_t getCacheId(const GeometryCache* cache, bool& defined);
+    void setCacheDefined(const GeometryCache* cache);
+    
+    uint64_t getElapsedUs() const;
+    
+    // Queues the records written so far for the writer thread
+    void submit();
+    
+private:
+    typedef std::chrono::steady_clock Clock;
+    
+    struct CacheEntry {
+        uint32_t id;
+        bool defined;
+    };
+    
+    FILE* m_file;
+    Clock::time_point m_start;
+    std::vector<uint8_t> m_buffer;
+    std::unordered_map<const GeometryCache*, CacheEntry> m_caches;
+    uint32_t m_nextCacheId;
+    
+    // Shared with the writer thread
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<std::vector<uint8_t>> m_pending;
+    std::vector<std::vector<uint8_t>> m_spare;
+    bool m_stopping;
+    std::thread m_thread;
+    
+    void run();
+};
+
+// Feeds a captured trace back into a Renderer, one frame at a time
+class DrawTracePlayer {
+public:
+    DrawTracePlayer();
+    ~DrawTracePlayer();
+    
+    // Loads the whole trace into memory
+    bool open(const std::string& path);
+    int getWidth() const { return m_header.width; }
+    int getHeight() const { return m_header.height; }
+    
+    // Replays records up to and including the next frame end. Returns false
+    // once the trace is exhausted or malformed.
+    bool playFrame(Renderer* renderer, uint32_t& deviceUs);
+    // Starts over from the first record; textures are recreated as replayed
+    void rewind();
+    // Releases textures and caches created on the renderer
+    void reset(Renderer* renderer);
+    
+    bool hasError() const { return m_error; }
+    
+private:
+    DrawTraceHeader m_header;
+    std::vector<uint8_t> m_data;
+    size_t m_offset;
+    bool m_error;
+    std::unordered_map<uint32_t, TextureHandle> m_textures;
+    std::unordered_map<uint32_t, GeometryCache*> m_caches;
+    std::vector<BatchVertex> m_quadScratch;
+    
+    bool read(void* out, size_t size);
+    bool readFloats(float* out, int count) { return read(out, sizeof(float) * count); }
+    GeometryCache* getCache(uint32_t id);
+    TextureHandle mapTexture(uint32_t traced) const;
+    bool playRecord(Renderer* renderer, uint8_t op, bool& frameEnded, uint32_t& deviceUs);
+};
+
+#endif // DRAW_TRACE_H
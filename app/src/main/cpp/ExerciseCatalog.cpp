@@ -0,0 +1,233 @@
+#include "ExerciseCatalog.h"
+#include <android/log.h>
+#include <cstring>
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "ExerciseCatalog", __VA_ARGS__))
+#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "ExerciseCatalog", __VA_ARGS__))
+
+static uint32_t alignUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+ExerciseCatalog::ExerciseCatalog()
+    : m_header(nullptr)
+    , m_entries(nullptr)
+    , m_hashSlots(nullptr)
+    , m_names(nullptr)
+{
+}
+
+ExerciseCatalog::~ExerciseCatalog() {
+    close();
+}
+
+uint32_t ExerciseCatalog::hashName(const char* name, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool ExerciseCatalog::openFile(const char* path) {
+    close();
+    return m_file.openFile(path) && useMapping();
+}
+
+bool ExerciseCatalog::openDescriptor(int fd, off_t offset, size_t length) {
+    close();
+    return m_file.openDescriptor(fd, offset, length) && useMapping();
+}
+
+bool ExerciseCatalog::useMapping() {
+    if (!validate(m_file.getData(), m_file.getLength())) {
+        LOGE("Invalid exercise catalog");
+        close();
+        return false;
+    }
+    
+    LOGI("Exercise catalog mapped: %u exercises", m_header->entryCount);
+    return true;
+}
+
+bool ExerciseCatalog::openDefaults(const ExerciseDefaults* exercises, size_t count) {
+    close();
+    if (!buildImage(exercises, count, m_image) || !validate(m_image.data(), m_image.size())) {
+        LOGE("Invalid built-in exercise catalog");
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool ExerciseCatalog::buildImage(const ExerciseDefaults* exercises, size_t count, std::vector<uint8_t>& image) {
+    image.clear();
+    
+    // At most half full, so probes stay short
+    uint32_t slotCount = 4;
+    while (slotCount < count * 2) {
+        slotCount *= 2;
+    }
+    std::vector<uint32_t> slots(slotCount, 0);
+    std::vector<ExerciseCatalogEntry> entries(count);
+    std::string names;
+    for (size_t i = 0; i < count; ++i) {
+        const char* name = exercises[i].name;
+        size_t length = name ? std::strlen(name) : 0;
+        if (length == 0) {
+            return false;
+        }
+        
+        ExerciseCatalogEntry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.nameOffset = (uint32_t)names.size();
+        entry.nameHash = hashName(name, length);
+        entry.defaultSets = (uint16_t)exercises[i].sets;
+        entry.defaultReps = (uint16_t)exercises[i].reps;
+        entry.defaultWeight = exercises[i].weight;
+        entry.restTime = (uint16_t)exercises[i].restTime;
+        names.append(name, length + 1);
+        
+        uint32_t slot = entry.nameHash & (slotCount - 1);
+        while (slots[slot] != 0) {
+            const ExerciseCatalogEntry& other = entries[slots[slot] - 1];
+            if (other.nameHash == entry.nameHash && std::strcmp(names.c_str() + other.nameOffset, name) == 0) {
+                return false;
+            }
+            slot = (slot + 1) & (slotCount - 1);
+        }
+        slots[slot] = (uint32_t)i + 1;
+    }
+    
+    ExerciseCatalogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = EXERCISE_CATALOG_MAGIC;
+    header.version = EXERCISE_CATALOG_VERSION;
+    header.entryCount = (uint32_t)count;
+    header.hashSlotCount = slotCount;
+    header.entriesOffset = alignUp(sizeof(ExerciseCatalogHeader), 4);
+    header.hashOffset = alignUp(header.entriesOffset + (uint32_t)(count * sizeof(ExerciseCatalogEntry)), 4);
+    header.namesOffset = alignUp(header.hashOffset + slotCount * (uint32_t)sizeof(uint32_t), 4);
+    header.namesSize = (uint32_t)names.size();
+    header.fileSize = alignUp(header.namesOffset + header.namesSize, 4);
+    
+    image.assign(header.fileSize, 0);
+    std::memcpy(&image[0], &header, sizeof(header));
+    if (count > 0) {
+        std::memcpy(&image[header.entriesOffset], entries.data(), count * sizeof(ExerciseCatalogEntry));
+        std::memcpy(&image[header.namesOffset], names.data(), names.size());
+    }
+    std::memcpy(&image[header.hashOffset], slots.data(), slotCount * sizeof(uint32_t));
+    return true;
+}
+
+bool ExerciseCatalog::validate(const uint8_t* data, size_t length) {
+    if (length < sizeof(ExerciseCatalogHeader)) {
+        return false;
+    }
+    
+    const ExerciseCatalogHeader* header = reinterpret_cast<const ExerciseCatalogHeader*>(data);
+    if (header->magic != EXERCISE_CATALOG_MAGIC || header->version != EXERCISE_CATALOG_VERSION ||
+        header->fileSize != length || header->hashSlotCount <= header->entryCount ||
+        (header->hashSlotCount & (header->hashSlotCount - 1)) != 0) {
+        return false;
+    }
+    
+    // Every section must lie inside the file, and the last name must end in it
+    uint64_t entriesEnd = (uint64_t)header->entriesOffset + (uint64_t)header->entryCount * sizeof(ExerciseCatalogEntry);
+    uint64_t hashEnd = (uint64_t)header->hashOffset + (uint64_t)header->hashSlotCount * sizeof(uint32_t);
+    uint64_t namesEnd = (uint64_t)header->namesOffset + header->namesSize;
+    if (entriesEnd > length || hashEnd > length || namesEnd > length ||
+        header->entriesOffset % 4 != 0 || header->hashOffset % 4 != 0 ||
+        (header->namesSize > 0 && data[namesEnd - 1] != 0)) {
+        return false;
+    }
+    
+    // The tables are not scanned: name offsets and slot ids are range-checked
+    // where they are read
+    m_header = header;
+    m_entries = reinterpret_cast<const ExerciseCatalogEntry*>(data + header->entriesOffset);
+    m_hashSlots = reinterpret_cast<const uint32_t*>(data + header->hashOffset);
+    m_names = reinterpret_cast<const char*>(data + header->namesOffset);
+    return true;
+}
+
+void ExerciseCatalog::close() {
+    m_file.close();
+    m_image.clear();
+    m_header = nullptr;
+    m_entries = nullptr;
+    m_hashSlots = nullptr;
+    m_names = nullptr;
+    m_internedEntries.clear();
+    m_internedNames.clear();
+}
+
+const char* ExerciseCatalog::getName(ExerciseId id) const {
+    uint32_t storedCount = getStoredCount();
+    if (id < storedCount) {
+        uint32_t offset = m_entries[id].nameOffset;
+        return offset < m_header->namesSize ? m_names + offset : "";
+    }
+    if (id - storedCount < m_internedNames.size()) {
+        return m_internedNames[id - storedCount].c_str();
+    }
+    return "";
+}
+
+const ExerciseCatalogEntry* ExerciseCatalog::getEntry(ExerciseId id) const {
+    uint32_t storedCount = getStoredCount();
+    if (id < storedCount) {
+        return &m_entries[id];
+    }
+    if (id - storedCount < m_internedEntries.size()) {
+        return &m_internedEntries[id - storedCount];
+    }
+    return nullptr;
+}
+
+ExerciseId ExerciseCatalog::find(const char* name, size_t length) const {
+    uint32_t hash = hashName(name, length);
+    if (m_header) {
+        // Probe until an empty slot; slotCount > entryCount guarantees one
+        uint32_t mask = m_header->hashSlotCount - 1;
+        for (uint32_t slot = hash & mask, probes = 0; probes <= mask; slot = (slot + 1) & mask, ++probes) {
+            uint32_t id = m_hashSlots[slot];
+            if (id == 0 || id > m_header->entryCount) {
+                break;
+            }
+            const ExerciseCatalogEntry& entry = m_entries[id - 1];
+            if (entry.nameHash == hash && (uint64_t)entry.nameOffset + length < m_header->namesSize &&
+                std::strncmp(m_names + entry.nameOffset, name, length) == 0 &&
+                m_names[entry.nameOffset + length] == 0) {
+                return id - 1;
+            }
+        }
+    }
+    
+    // Interned names are few: whatever workouts added outside the catalog
+    for (size_t i = 0; i < m_internedEntries.size(); ++i) {
+        if (m_internedEntries[i].nameHash == hash && m_internedNames[i].compare(0, std::string::npos, name, length) == 0) {
+            return getStoredCount() + (ExerciseId)i;
+        }
+    }
+    return NO_EXERCISE;
+}
+
+ExerciseId ExerciseCatalog::intern(const std::string& name, int sets, int reps, float weight, int restTime) {
+    ExerciseId id = find(name);
+    if (id != NO_EXERCISE) {
+        return id;
+    }
+    
+    ExerciseCatalogEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.nameHash = hashName(name.data(), name.size());
+    entry.defaultSets = (uint16_t)sets;
+    entry.defaultReps = (uint16_t)reps;
+    entry.defaultWeight = weight;
+    entry.restTime = (uint16_t)restTime;
+    m_internedEntries.push_back(entry);
+    m_internedNames.push_back(name);
+    return getCount() - 1;
+}
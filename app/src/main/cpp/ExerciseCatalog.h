@@ -0,0 +1,117 @@
+#ifndef EXERCISE_CATALOG_H
+#define EXERCISE_CATALOG_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+// Exercise catalog: every exercise the app knows, its name and the sets,
+// reps, weight and rest a new entry starts with. Produced on the host by
+// workouttracker_catalogbake and used on the device exactly as stored:
+//
+//   ExerciseCatalogHeader
+//   ExerciseCatalogEntry entries[entryCount]   in id order
+//   uint32_t hashSlots[hashSlotCount]           id + 1 of a name hashing there, 0 = empty
+//   char names[namesSize]                       NUL-terminated UTF-8, one per entry
+//
+// All sections are 4-byte aligned and little-endian. The hash table is open
+// addressing with linear probing over FNV-1a of the exact name bytes.
+static const uint32_t EXERCISE_CATALOG_MAGIC = 0x58455457; // "WTEX"
+static const uint32_t EXERCISE_CATALOG_VERSION = 1;
+
+// Index of an exercise in the catalog; what workouts store instead of names
+typedef uint32_t ExerciseId;
+static const ExerciseId NO_EXERCISE = 0xFFFFFFFF;
+
+struct ExerciseCatalogHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t entryCount;
+    uint32_t hashSlotCount;     // power of two, more than entryCount
+    uint32_t entriesOffset;
+    uint32_t hashOffset;
+    uint32_t namesOffset;
+    uint32_t namesSize;
+};
+
+struct ExerciseCatalogEntry {
+    uint32_t nameOffset;        // into the name pool
+    uint32_t nameHash;
+    uint16_t defaultSets;
+    uint16_t defaultReps;       // seconds for timed holds such as Plank
+    float defaultWeight;        // kg, 0 for bodyweight
+    uint16_t restTime;          // seconds
+    uint16_t reserved;
+};
+
+// One exercise as given to the baker or to the built-in catalog
+struct ExerciseDefaults {
+    const char* name;
+    int sets;
+    int reps;
+    float weight;
+    int restTime;
+};
+
+// Read-only memory mapping of a catalog, or the same image built in memory
+// for the built-in list. Opening checks the header and the section bounds
+// only; entries, names and the hash table are read in place. Names missing
+// from the catalog can be interned at runtime: they get the ids after the
+// stored entries and live only in memory.
+class ExerciseCatalog {
+public:
+    ExerciseCatalog();
+    ~ExerciseCatalog();
+    
+    ExerciseCatalog(const ExerciseCatalog&) = delete;
+    ExerciseCatalog& operator=(const ExerciseCatalog&) = delete;
+    
+    bool openFile(const char* path);
+    // Maps length bytes at offset of an open file, e.g. an uncompressed APK
+    // asset; the descriptor can be closed afterwards
+    bool openDescriptor(int fd, off_t offset, size_t length);
+    // Builds the stored image of the given exercises and opens it
+    bool openDefaults(const ExerciseDefaults* exercises, size_t count);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    
+    // The stored format; false when a name is empty or appears twice
+    static bool buildImage(const ExerciseDefaults* exercises, size_t count, std::vector<uint8_t>& image);
+    
+    // Stored entries, the ones the picker offers
+    uint32_t getStoredCount() const { return m_header ? m_header->entryCount : 0; }
+    // Stored entries followed by the interned ones
+    uint32_t getCount() const { return getStoredCount() + (uint32_t)m_internedEntries.size(); }
+    
+    // Empty for an unknown id
+    const char* getName(ExerciseId id) const;
+    const ExerciseCatalogEntry* getEntry(ExerciseId id) const;
+    // Exact, case-sensitive name; NO_EXERCISE when missing
+    ExerciseId find(const char* name, size_t length) const;
+    ExerciseId find(const std::string& name) const { return find(name.data(), name.size()); }
+    // The name's id, adding it with the given defaults when it is not known
+    ExerciseId intern(const std::string& name, int sets, int reps, float weight, int restTime);
+    
+    static uint32_t hashName(const char* name, size_t length);
+    
+private:
+    MappedFile m_file;
+    std::vector<uint8_t> m_image;       // built-in catalog, instead of a mapping
+    const ExerciseCatalogHeader* m_header;
+    const ExerciseCatalogEntry* m_entries;
+    const uint32_t* m_hashSlots;
+    const char* m_names;
+    
+    // Runtime additions, ids from getStoredCount() on
+    std::vector<ExerciseCatalogEntry> m_internedEntries;
+    std::vector<std::string> m_internedNames;
+    
+    bool useMapping();
+    bool validate(const uint8_t* data, size_t length);
+};
+
+#endif // EXERCISE_CATALOG_H
@@ -0,0 +1,336 @@
+#include "ExerciseSearch.h"
+#include <algorithm>
+
+// Shorter queries match too much by trigrams to be worth it
+static const size_t FUZZY_MIN_LENGTH = 4;
+
+// Lowercase words separated by single spaces. Letters and digits form words,
+// as do UTF-8 sequences; everything else separates them. A trailing separator
+// is kept as one space: the next character starts a new word.
+static void normalizeText(const std::string& text, std::string& out) {
+    out.clear();
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = (unsigned char)text[i];
+        if (c >= 'A' && c <= 'Z') {
+            out += (char)(c - 'A' + 'a');
+        } else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80) {
+            out += (char)c;
+        } else if (!out.empty() && out.back() != ' ') {
+            out += ' ';
+        }
+    }
+}
+
+static uint32_t makeTrigram(unsigned char a, unsigned char b, unsigned char c) {
+    return (uint32_t)a << 16 | (uint32_t)b << 8 | (uint32_t)c;
+}
+
+ExerciseSearch::ExerciseSearch()
+    : m_queryTrigrams(0)
+{
+    setCatalog(std::vector<std::string>());
+}
+
+void ExerciseSearch::setCatalog(const std::vector<std::string>& names) {
+    m_names = names;
+    m_nodes.clear();
+    m_edges.clear();
+    m_postings.clear();
+    
+    // Every word of every name with its entry, sorted so each trie node's
+    // words are one contiguous range
+    std::vector<std::pair<std::string, int> > words;
+    std::vector<std::pair<uint32_t, int> > trigrams;
+    std::string normalized;
+    for (size_t entry = 0; entry < m_names.size(); ++entry) {
+        normalizeText(m_names[entry], normalized);
+        if (!normalized.empty() && normalized.back() == ' ') {
+            normalized.pop_back();
+        }
+        
+        size_t start = 0;
+        while (start < normalized.size()) {
+            size_t end = normalized.find(' ', start);
+            if (end == std::string::npos) {
+                end = normalized.size();
+            }
+            words.push_back(std::make_pair(normalized.substr(start, end - start), (int)entry));
+            start = end + 1;
+        }
+        
+        // Over the name with a leading space, so word starts count too
+        std::string padded = " " + normalized;
+        for (size_t i = 0; i + 2 < padded.size(); ++i) {
+            uint32_t key = makeTrigram((unsigned char)padded[i], (unsigned char)padded[i + 1],
+                                       (unsigned char)padded[i + 2]);
+            trigrams.push_back(std::make_pair(key, (int)entry));
+        }
+    }
+    std::sort(words.begin(), words.end());
+    
+    std::vector<int> scratch;
+    m_nodes.push_back(TrieNode());
+    buildNode(words, 0, words.size(), 0, scratch);
+    
+    // Postings in entry order, each entry once per trigram
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    m_trigramKeys.clear();
+    m_trigramFirst.clear();
+    m_trigramPostings.clear();
+    for (size_t i = 0; i < trigrams.size(); ++i) {
+        if (m_trigramKeys.empty() || m_trigramKeys.back() != trigrams[i].first) {
+            m_trigramKeys.push_back(trigrams[i].first);
+            m_trigramFirst.push_back((int)i);
+        }
+        m_trigramPostings.push_back(trigrams[i].second);
+    }
+    m_trigramFirst.push_back((int)m_trigramPostings.size());
+    
+    m_trigramCounts.assign(m_names.size(), 0);
+    m_isTouched.assign(m_names.size(), 0);
+    m_touched.clear();
+    m_fuzzy.clear();
+    m_queryTrigrams = 0;
+    m_query.clear();
+    m_normalized.clear();
+    m_levelResults.clear();
+    
+    Level root;
+    root.node = 0;
+    root.all = true;
+    root.inPostings = false;
+    root.resultBegin = 0;
+    root.resultCount = 0;
+    root.scratchMark = 0;
+    root.trigram = -1;
+    m_levels.assign(1, root);
+}
+
+int ExerciseSearch::buildNode(const std::vector<std::pair<std::string, int> >& words, size_t begin, size_t end,
+                              size_t depth, std::vector<int>& scratch) {
+    int index = (int)m_nodes.size() - 1;
+    
+    // Every entry with a word below this node, once, in entry order
+    scratch.clear();
+    for (size_t i = begin; i < end; ++i) {
+        scratch.push_back(words[i].second);
+    }
+    std::sort(scratch.begin(), scratch.end());
+    scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+    m_nodes[index].firstPosting = (int)m_postings.size();
+    m_nodes[index].postingCount = (int)scratch.size();
+    m_postings.insert(m_postings.end(), scratch.begin(), scratch.end());
+    
+    // Words ending here sort first; the rest split by their next character
+    size_t i = begin;
+    while (i < end && words[i].first.size() <= depth) {
+        ++i;
+    }
+    std::vector<std::pair<size_t, size_t> > ranges;
+    while (i < end) {
+        unsigned char c = (unsigned char)words[i].first[depth];
+        size_t rangeEnd = i;
+        while (rangeEnd < end && (unsigned char)words[rangeEnd].first[depth] == c) {
+            ++rangeEnd;
+        }
+        ranges.push_back(std::make_pair(i, rangeEnd));
+        i = rangeEnd;
+    }
+    
+    // Edges of a node are contiguous: reserve them before building below
+    int firstEdge = (int)m_edges.size();
+    m_nodes[index].firstEdge = firstEdge;
+    m_nodes[index].edgeCount = (int)ranges.size();
+    m_edges.resize(m_edges.size() + ranges.size());
+    for (size_t r = 0; r < ranges.size(); ++r) {
+        m_nodes.push_back(TrieNode());
+        m_edges[firstEdge + r].c = (unsigned char)words[ranges[r].first].first[depth];
+        m_edges[firstEdge + r].node = buildNode(words, ranges[r].first, ranges[r].second, depth + 1, scratch);
+    }
+    return index;
+}
+
+int ExerciseSearch::findChild(int node, unsigned char c) const {
+    const TrieNode& parent = m_nodes[node];
+    for (int i = 0; i < parent.edgeCount; ++i) {
+        const TrieEdge& edge = m_edges[parent.firstEdge + i];
+        if (edge.c == c) {
+            return edge.node;
+        }
+    }
+    return -1;
+}
+
+int ExerciseSearch::findTrigram(uint32_t key) const {
+    std::vector<uint32_t>::const_iterator it = std::lower_bound(m_trigramKeys.begin(), m_trigramKeys.end(), key);
+    if (it == m_trigramKeys.end() || *it != key) {
+        return -1;
+    }
+    return (int)(it - m_trigramKeys.begin());
+}
+
+const int* ExerciseSearch::getLevelResults(const Level& level) const {
+    const std::vector<int>& source = level.inPostings ? m_postings : m_levelResults;
+    return source.data() + level.resultBegin;
+}
+
+void ExerciseSearch::setQuery(const std::string& query) {
+    m_query = query;
+    std::string normalized;
+    normalizeText(query, normalized);
+    
+    // Back to the longest shared prefix, then forward over the new characters
+    size_t shared = 0;
+    while (shared < normalized.size() && shared < m_normalized.size() && normalized[shared] == m_normalized[shared]) {
+        ++shared;
+    }
+    while (m_normalized.size() > shared) {
+        popCharacter();
+    }
+    for (size_t i = shared; i < normalized.size(); ++i) {
+        pushCharacter(normalized[i]);
+    }
+    
+    collectFuzzyMatches();
+}
+
+void ExerciseSearch::pushCharacter(char c) {
+    const Level previous = m_levels.back();
+    Level level = previous;
+    level.scratchMark = m_levelResults.size();
+    level.trigram = -1;
+    
+    if (c == ' ') {
+        // The next word starts at the root; the results stay
+        if (previous.node >= 0) {
+            level.node = 0;
+        }
+    } else {
+        level.node = previous.node >= 0 ? findChild(previous.node, (unsigned char)c) : -1;
+        level.all = false;
+        if (level.node < 0) {
+            level.inPostings = false;
+            level.resultBegin = (int)m_levelResults.size();
+            level.resultCount = 0;
+        } else if (previous.all) {
+            // First word: exactly the node's postings
+            level.inPostings = true;
+            level.resultBegin = m_nodes[level.node].firstPosting;
+            level.resultCount = m_nodes[level.node].postingCount;
+        } else {
+            // Later characters only narrow the previous results
+            const TrieNode& node = m_nodes[level.node];
+            size_t begin = m_levelResults.size();
+            m_levelResults.resize(begin + (size_t)std::min(previous.resultCount, node.postingCount));
+            const int* from = getLevelResults(previous);
+            const int* postings = m_postings.data() + node.firstPosting;
+            int* out = std::set_intersection(from, from + previous.resultCount,
+                                             postings, postings + node.postingCount,
+                                             m_levelResults.data() + begin);
+            m_levelResults.resize((size_t)(out - m_levelResults.data()));
+            level.inPostings = false;
+            level.resultBegin = (int)begin;
+            level.resultCount = (int)(m_levelResults.size() - begin);
+        }
+    }
+    
+    // The trigram ending with this character, the query padded like the names
+    m_normalized += c;
+    size_t length = m_normalized.size();
+    if (length >= 2) {
+        unsigned char a = length >= 3 ? (unsigned char)m_normalized[length - 3] : ' ';
+        uint32_t key = makeTrigram(a, (unsigned char)m_normalized[length - 2], (unsigned char)c);
+        level.trigram = findTrigram(key);
+        countTrigram(level.trigram, 1);
+        m_queryTrigrams++;
+    }
+    
+    m_levels.push_back(level);
+}
+
+void ExerciseSearch::popCharacter() {
+    const Level& level = m_levels.back();
+    if (m_normalized.size() >= 2) {
+        countTrigram(level.trigram, -1);
+        m_queryTrigrams--;
+    }
+    m_levelResults.resize(level.scratchMark);
+    m_levels.pop_back();
+    m_normalized.pop_back();
+}
+
+void ExerciseSearch::countTrigram(int trigram, int delta) {
+    if (trigram < 0) {
+        return;
+    }
+    
+    for (int i = m_trigramFirst[trigram]; i < m_trigramFirst[trigram + 1]; ++i) {
+        int entry = m_trigramPostings[i];
+        // A count that fell back to zero is still listed until the next compaction
+        if (!m_isTouched[entry]) {
+            m_isTouched[entry] = 1;
+            m_touched.push_back(entry);
+        }
+        m_trigramCounts[entry] = (uint16_t)(m_trigramCounts[entry] + delta);
+    }
+}
+
+void ExerciseSearch::collectFuzzyMatches() {
+    m_fuzzy.clear();
+    
+    // Entries back at zero drop out of the touched list
+    size_t kept = 0;
+    for (size_t i = 0; i < m_touched.size(); ++i) {
+        if (m_trigramCounts[m_touched[i]] > 0) {
+            m_touched[kept++] = m_touched[i];
+        } else {
+            m_isTouched[m_touched[i]] = 0;
+        }
+    }
+    m_touched.resize(kept);
+    
+    if (m_normalized.size() < FUZZY_MIN_LENGTH || m_queryTrigrams == 0) {
+        return;
+    }
+    
+    // At least two thirds of the query's trigrams: one typo in a longer word
+    // breaks up to three of them
+    int threshold = (m_queryTrigrams * 2 + 2) / 3;
+    const Level& level = m_levels.back();
+    const int* prefix = getLevelResults(level);
+    for (size_t i = 0; i < m_touched.size(); ++i) {
+        int entry = m_touched[i];
+        if (m_trigramCounts[entry] >= threshold &&
+            !std::binary_search(prefix, prefix + level.resultCount, entry)) {
+            m_fuzzy.push_back(entry);
+        }
+    }
+    
+    std::sort(m_fuzzy.begin(), m_fuzzy.end(), [this](int a, int b) {
+        if (m_trigramCounts[a] != m_trigramCounts[b]) {
+            return m_trigramCounts[a] > m_trigramCounts[b];
+        }
+        return a < b;
+    });
+}
+
+size_t ExerciseSearch::getPrefixMatchCount() const {
+    const Level& level = m_levels.back();
+    return level.all ? m_names.size() : (size_t)level.resultCount;
+}
+
+size_t ExerciseSearch::getResultCount() const {
+    return getPrefixMatchCount() + m_fuzzy.size();
+}
+
+int ExerciseSearch::getResult(size_t index) const {
+    const Level& level = m_levels.back();
+    if (level.all) {
+        return (int)index;
+    }
+    if (index < (size_t)level.resultCount) {
+        return getLevelResults(level)[index];
+    }
+    return m_fuzzy[index - (size_t)level.resultCount];
+}
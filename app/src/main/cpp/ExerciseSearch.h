@@ -0,0 +1,96 @@
+#ifndef EXERCISE_SEARCH_H
+#define EXERCISE_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Search over the exercise catalog as the user types. Names and queries are
+// compared as lowercase words: an entry matches when every query word is a
+// prefix of one of its words. A prefix trie finds those, each node listing
+// the entries of every word below it. Entries that share most of the query's
+// trigrams follow as typo-tolerant matches.
+//
+// The query is kept as a stack of states, one per character. Typing narrows
+// the previous result set with a single trie step and one set of trigram
+// postings, deleting pops back to the stored state; no keystroke rescans the
+// catalog.
+class ExerciseSearch {
+public:
+    ExerciseSearch();
+    
+    // Replaces the catalog and clears the query
+    void setCatalog(const std::vector<std::string>& names);
+    size_t getCatalogSize() const { return m_names.size(); }
+    const std::string& getName(int entry) const { return m_names[entry]; }
+    
+    // Keeps the states of the part shared with the previous query
+    void setQuery(const std::string& query);
+    const std::string& getQuery() const { return m_query; }
+    
+    // Prefix matches in catalog order, then typo-tolerant matches, best first;
+    // the whole catalog for an empty query
+    size_t getResultCount() const;
+    int getResult(size_t index) const;
+    size_t getPrefixMatchCount() const;
+    
+private:
+    struct TrieNode {
+        int firstEdge;
+        int edgeCount;
+        int firstPosting;
+        int postingCount;
+    };
+    
+    struct TrieEdge {
+        unsigned char c;
+        int node;
+    };
+    
+    // Search state after one more character of the normalized query
+    struct Level {
+        int node;            // trie node of the last word, -1 once it matches nothing
+        bool all;            // no word typed yet, everything matches
+        bool inPostings;     // results are a trie node's postings, not a stored intersection
+        int resultBegin;
+        int resultCount;
+        size_t scratchMark;  // m_levelResults size before this level
+        int trigram;         // index into m_trigramKeys counted at this level, or -1
+    };
+    
+    std::vector<std::string> m_names;
+    
+    std::vector<TrieNode> m_nodes;
+    std::vector<TrieEdge> m_edges;
+    std::vector<int> m_postings;
+    
+    // Trigram postings, keys sorted for binary search
+    std::vector<uint32_t> m_trigramKeys;
+    std::vector<int> m_trigramFirst;
+    std::vector<int> m_trigramPostings;
+    
+    std::string m_query;
+    std::string m_normalized;
+    std::vector<Level> m_levels;
+    std::vector<int> m_levelResults;
+    
+    // Shared query trigrams per entry, and the entries counted at all
+    std::vector<uint16_t> m_trigramCounts;
+    std::vector<uint8_t> m_isTouched;   // listed in m_touched
+    std::vector<int> m_touched;
+    int m_queryTrigrams;
+    std::vector<int> m_fuzzy;
+    
+    int buildNode(const std::vector<std::pair<std::string, int> >& words, size_t begin, size_t end,
+                  size_t depth, std::vector<int>& scratch);
+    int findChild(int node, unsigned char c) const;
+    int findTrigram(uint32_t key) const;
+    const int* getLevelResults(const Level& level) const;
+    void pushCharacter(char c);
+    void popCharacter();
+    void countTrigram(int trigram, int delta);
+    void collectFuzzyMatches();
+};
+
+#endif // EXERCISE_SEARCH_H
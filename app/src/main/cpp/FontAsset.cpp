@@ -0,0 +1,98 @@
+#include "FontAsset.h"
+#include <android/log.h>
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "FontAsset", __VA_ARGS__))
+#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "FontAsset", __VA_ARGS__))
+
+FontAsset::FontAsset()
+    : m_header(nullptr)
+    , m_pageDirectory(nullptr)
+    , m_pages(nullptr)
+    , m_glyphs(nullptr)
+{
+}
+
+FontAsset::~FontAsset() {
+    close();
+}
+
+bool FontAsset::openFile(const char* path) {
+    close();
+    return m_file.openFile(path) && useMapping();
+}
+
+bool FontAsset::openDescriptor(int fd, off_t offset, size_t length) {
+    close();
+    return m_file.openDescriptor(fd, offset, length) && useMapping();
+}
+
+bool FontAsset::useMapping() {
+    if (!validate(m_file.getData(), m_file.getLength())) {
+        LOGE("Invalid font asset");
+        close();
+        return false;
+    }
+    
+    LOGI("Font asset mapped: %u glyphs, %u x %u atlas", m_header->glyphCount,
+         m_header->atlasWidth, m_header->atlasHeight);
+    return true;
+}
+
+bool FontAsset::validate(const uint8_t* data, size_t length) {
+    if (length < sizeof(FontAssetHeader)) {
+        return false;
+    }
+    
+    const FontAssetHeader* header = reinterpret_cast<const FontAssetHeader*>(data);
+    if (header->magic != FONT_ASSET_MAGIC || header->version != FONT_ASSET_VERSION ||
+        header->fileSize != length || header->pageCount == 0 || header->pageCount > FONT_ASSET_NO_GLYPH ||
+        header->glyphCount >= FONT_ASSET_NO_GLYPH || header->atlasWidth == 0 || header->atlasHeight == 0 ||
+        header->distanceRange <= 0.0f || header->pixelSize <= 0.0f || header->capHeight <= 0.0f) {
+        return false;
+    }
+    
+    // Every section must lie inside the file
+    uint64_t directoryEnd = (uint64_t)header->pageDirectoryOffset + FONT_ASSET_PAGE_COUNT * sizeof(uint16_t);
+    uint64_t pagesEnd = (uint64_t)header->pagesOffset +
+                        (uint64_t)header->pageCount * FONT_ASSET_PAGE_SIZE * sizeof(uint16_t);
+    uint64_t glyphsEnd = (uint64_t)header->glyphsOffset + (uint64_t)header->glyphCount * sizeof(FontAssetGlyph);
+    uint64_t atlasEnd = (uint64_t)header->atlasOffset + (uint64_t)header->atlasWidth * header->atlasHeight;
+    if (directoryEnd > length || pagesEnd > length || glyphsEnd > length || atlasEnd > length ||
+        header->pageDirectoryOffset % 4 != 0 || header->pagesOffset % 4 != 0 || header->glyphsOffset % 4 != 0) {
+        return false;
+    }
+    
+    // The tables are not scanned: page and glyph indices are range-checked
+    // where they are read
+    m_header = header;
+    m_pageDirectory = reinterpret_cast<const uint16_t*>(data + header->pageDirectoryOffset);
+    m_pages = reinterpret_cast<const uint16_t*>(data + header->pagesOffset);
+    m_glyphs = reinterpret_cast<const FontAssetGlyph*>(data + header->glyphsOffset);
+    return true;
+}
+
+void FontAsset::close() {
+    m_file.close();
+    m_header = nullptr;
+    m_pageDirectory = nullptr;
+    m_pages = nullptr;
+    m_glyphs = nullptr;
+}
+
+const FontAssetGlyph* FontAsset::findGlyph(uint32_t codepoint) const {
+    if (!m_header || codepoint >= 0x10000) {
+        return nullptr;
+    }
+    
+    uint32_t page = m_pageDirectory[codepoint >> FONT_ASSET_PAGE_BITS];
+    page = page < m_header->pageCount ? page : 0;
+    uint32_t glyph = m_pages[page * FONT_ASSET_PAGE_SIZE + (codepoint & (FONT_ASSET_PAGE_SIZE - 1))];
+    return glyph < m_header->glyphCount ? &m_glyphs[glyph] : nullptr;
+}
+
+const uint8_t* FontAsset::getAtlasPixels() const {
+    if (!m_header) {
+        return nullptr;
+    }
+    return reinterpret_cast<const uint8_t*>(m_header) + m_header->atlasOffset;
+}
@@ -0,0 +1,89 @@
+#ifndef FONT_ASSET_H
+#define FONT_ASSET_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+// Baked signed-distance-field font, produced on the host by
+// workouttracker_fontbake and used on the device exactly as stored:
+//
+//   FontAssetHeader
+//   uint16_t pageDirectory[FONT_ASSET_PAGE_COUNT]   page of each 128-code-point block, 0 = empty
+//   uint16_t pages[pageCount][FONT_ASSET_PAGE_SIZE] glyph index, FONT_ASSET_NO_GLYPH if none
+//   FontAssetGlyph glyphs[glyphCount]
+//   uint8_t atlas[atlasWidth * atlasHeight]         distance field, 128 on the outline
+//
+// All sections are 4-byte aligned and little-endian. Lengths are in atlas
+// pixels at the size the font was rasterized at.
+static const uint32_t FONT_ASSET_MAGIC = 0x4E465457; // "WTFN"
+static const uint32_t FONT_ASSET_VERSION = 1;
+static const int FONT_ASSET_PAGE_BITS = 7;
+static const uint32_t FONT_ASSET_PAGE_SIZE = 1u << FONT_ASSET_PAGE_BITS;
+static const uint32_t FONT_ASSET_PAGE_COUNT = 0x10000 >> FONT_ASSET_PAGE_BITS; // the BMP
+static const uint16_t FONT_ASSET_NO_GLYPH = 0xFFFF;
+
+struct FontAssetHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t glyphCount;
+    uint32_t pageCount;         // including the empty page 0
+    uint32_t atlasWidth;
+    uint32_t atlasHeight;
+    float pixelSize;            // em size the glyphs were rasterized at
+    float distanceRange;        // pixels from the outline to distance 0 or 255
+    float ascender;
+    float descender;            // negative below the baseline
+    float capHeight;
+    uint32_t pageDirectoryOffset;
+    uint32_t pagesOffset;
+    uint32_t glyphsOffset;
+    uint32_t atlasOffset;
+};
+
+struct FontAssetGlyph {
+    uint32_t codepoint;
+    uint16_t atlasX, atlasY;    // top-left of the glyph's box, distance padding included
+    uint16_t width, height;     // 0 for glyphs without ink (space)
+    float bearingX;             // box left edge relative to the pen position
+    float bearingY;             // box top edge above the baseline
+    float advance;
+};
+
+// Read-only memory mapping of a font asset. Opening checks the header and the
+// section bounds only, so its cost does not depend on the number of glyphs;
+// glyph lookups read the mapped tables in place.
+class FontAsset {
+public:
+    FontAsset();
+    ~FontAsset();
+    
+    FontAsset(const FontAsset&) = delete;
+    FontAsset& operator=(const FontAsset&) = delete;
+    
+    bool openFile(const char* path);
+    // Maps length bytes at offset of an open file, e.g. an uncompressed APK
+    // asset; the descriptor can be closed afterwards
+    bool openDescriptor(int fd, off_t offset, size_t length);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    
+    const FontAssetHeader& getHeader() const { return *m_header; }
+    // Constant time: two table loads
+    const FontAssetGlyph* findGlyph(uint32_t codepoint) const;
+    const uint8_t* getAtlasPixels() const;
+    
+private:
+    MappedFile m_file;
+    const FontAssetHeader* m_header;   // into the mapping
+    const uint16_t* m_pageDirectory;
+    const uint16_t* m_pages;
+    const FontAssetGlyph* m_glyphs;
+    
+    bool useMapping();
+    bool validate(const uint8_t* data, size_t length);
+};
+
+#endif // FONT_ASSET_H
@@ -0,0 +1,118 @@
+#include "FrameArena.h"
+#include <android/log.h>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "FrameArena", __VA_ARGS__))
+
+FrameArena::FrameArena(size_t blockSize)
+    : m_blockSize(blockSize > 0 ? blockSize : DEFAULT_BLOCK_SIZE)
+    , m_currentBlock(0)
+    , m_offset(0)
+    , m_usedBytes(0)
+    , m_lastFrameBytes(0)
+    , m_peakBytes(0)
+    , m_debugMode(false)
+{
+}
+
+FrameArena::~FrameArena() {
+    releaseBlocks();
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    if (size == 0) {
+        size = 1;
+    }
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        alignment = alignof(std::max_align_t);
+    }
+    
+    while (true) {
+        if (m_currentBlock < m_blocks.size()) {
+            Block& block = m_blocks[m_currentBlock];
+            uintptr_t base = (uintptr_t)block.data;
+            uintptr_t aligned = (base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            size_t end = (size_t)(aligned - base) + size;
+            if (end <= block.size) {
+                m_usedBytes += end - m_offset;
+                m_offset = end;
+                return (void*)aligned;
+            }
+            
+            // The rest of this block is wasted for the frame; try the next one
+            if (m_currentBlock + 1 < m_blocks.size()) {
+                m_usedBytes += block.size - m_offset;
+                m_currentBlock++;
+                m_offset = 0;
+                continue;
+            }
+            m_usedBytes += block.size - m_offset;
+            m_offset = block.size;
+        }
+        
+        addBlock(size + alignment);
+        m_currentBlock = m_blocks.size() - 1;
+        m_offset = 0;
+    }
+}
+
+void FrameArena::reset() {
+    m_lastFrameBytes = m_usedBytes;
+    if (m_usedBytes > m_peakBytes) {
+        m_peakBytes = m_usedBytes;
+        if (m_debugMode) {
+            LOGI("Frame arena peak: %zu bytes in %zu blocks", m_peakBytes, m_blocks.size());
+        }
+    }
+    
+    if (m_debugMode) {
+        for (size_t i = 0; i <= m_currentBlock && i < m_blocks.size(); ++i) {
+            size_t used = i < m_currentBlock ? m_blocks[i].size : m_offset;
+            std::memset(m_blocks[i].data, POISON_BYTE, used);
+        }
+    }
+    
+    // A frame that overflowed into extra blocks gets one block large enough
+    // for all of them, so the next frame of the same size stays in one block
+    if (m_blocks.size() > 1) {
+        size_t total = getCapacity();
+        releaseBlocks();
+        addBlock(total);
+        if (m_debugMode) {
+            std::memset(m_blocks[0].data, POISON_BYTE, m_blocks[0].size);
+        }
+    }
+    
+    m_currentBlock = 0;
+    m_offset = 0;
+    m_usedBytes = 0;
+}
+
+size_t FrameArena::getCapacity() const {
+    size_t total = 0;
+    for (size_t i = 0; i < m_blocks.size(); ++i) {
+        total += m_blocks[i].size;
+    }
+    return total;
+}
+
+void FrameArena::addBlock(size_t minimumSize) {
+    Block block;
+    block.size = minimumSize > m_blockSize ? minimumSize : m_blockSize;
+    block.data = static_cast<uint8_t*>(std::malloc(block.size));
+    if (!block.data) {
+        throw std::bad_alloc();
+    }
+    m_blocks.push_back(block);
+}
+
+void FrameArena::releaseBlocks() {
+    for (size_t i = 0; i < m_blocks.size(); ++i) {
+        std::free(m_blocks[i].data);
+    }
+    m_blocks.clear();
+    m_currentBlock = 0;
+    m_offset = 0;
+}
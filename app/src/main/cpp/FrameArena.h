@@ -0,0 +1,103 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for data that lives no longer than one frame: vertex
+// scratch, laid-out labels, temporary layout results. Allocation is a pointer
+// increment and nothing is freed individually; Renderer::beginFrame resets
+// the whole arena. When a frame outgrows the arena, overflow blocks are
+// chained and merged into one larger block at the next reset, so a steady
+// workload stops touching the heap after its first frames.
+class FrameArena {
+public:
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+    
+    explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~FrameArena();
+    
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    
+    // Never returns nullptr; size 0 yields a valid, unique pointer
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    
+    // Uninitialized storage for count objects. Destructors never run, so only
+    // trivially destructible types are allowed.
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+    
+    // Invalidates everything allocated since the previous reset
+    void reset();
+    
+    // Debug mode fills released memory with POISON_BYTE on reset, so stale
+    // pointers into a previous frame read obvious garbage, and logs every
+    // new peak
+    static const uint8_t POISON_BYTE = 0xCD;
+    void setDebugMode(bool enabled) { m_debugMode = enabled; }
+    bool isDebugMode() const { return m_debugMode; }
+    
+    // Bytes handed out in the current frame, including alignment padding
+    size_t getUsedBytes() const { return m_usedBytes; }
+    // Usage of the last completed frame and the highest over all frames
+    size_t getLastFrameBytes() const { return m_lastFrameBytes; }
+    size_t getPeakBytes() const { return m_peakBytes; }
+    size_t getCapacity() const;
+    
+private:
+    struct Block {
+        uint8_t* data;
+        size_t size;
+    };
+    
+    size_t m_blockSize;
+    std::vector<Block> m_blocks;
+    size_t m_currentBlock;
+    size_t m_offset;       // into the current block
+    size_t m_usedBytes;
+    size_t m_lastFrameBytes;
+    size_t m_peakBytes;
+    bool m_debugMode;
+    
+    void addBlock(size_t minimumSize);
+    void releaseBlocks();
+};
+
+// Standard allocator over a FrameArena. deallocate is a no-op, so containers
+// built on it should reserve up front: a grown vector leaves its old buffer
+// behind in the arena until the frame ends.
+template <typename T>
+class FrameArenaAllocator {
+public:
+    typedef T value_type;
+    
+    explicit FrameArenaAllocator(FrameArena* arena) : m_arena(arena) {}
+    template <typename U>
+    FrameArenaAllocator(const FrameArenaAllocator<U>& other) : m_arena(other.getArena()) {}
+    
+    T* allocate(size_t count) { return static_cast<T*>(m_arena->allocate(sizeof(T) * count, alignof(T))); }
+    void deallocate(T*, size_t) {}
+    
+    FrameArena* getArena() const { return m_arena; }
+    
+    template <typename U>
+    bool operator==(const FrameArenaAllocator<U>& other) const { return m_arena == other.getArena(); }
+    template <typename U>
+    bool operator!=(const FrameArenaAllocator<U>& other) const { return m_arena != other.getArena(); }
+    
+private:
+    FrameArena* m_arena;
+};
+
+// Containers whose storage is released wholesale at the next beginFrame.
+// They must not be kept across frames.
+template <typename T>
+using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
+
+#endif // FRAME_ARENA_H
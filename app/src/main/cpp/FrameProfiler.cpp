@@ -0,0 +1,125 @@
+#include "FrameProfiler.h"
+#include "Renderer.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cstdio>
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "FrameProfiler", __VA_ARGS__))
+#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "FrameProfiler", __VA_ARGS__))
+
+static const char* PHASE_NAMES[FrameProfiler::PHASE_COUNT] = {
+    "input_us", "update_us", "layout_us", "render_us", "swap_us"
+};
+
+FrameProfiler::FrameProfiler()
+    : m_records(CAPACITY)
+    , m_head(0)
+    , m_count(0)
+{
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        m_pendingUs[i] = 0;
+    }
+    m_sortScratch.reserve(CAPACITY);
+}
+
+void FrameProfiler::beginPhase(Phase phase) {
+    m_phaseStart[phase] = Clock::now();
+}
+
+void FrameProfiler::endPhase(Phase phase) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_phaseStart[phase]);
+    // Phases can run several times per frame (one input dispatch per event)
+    m_pendingUs[phase] += (uint32_t)elapsed.count();
+}
+
+void FrameProfiler::endFrame(const RenderStats& stats) {
+    FrameRecord& record = m_records[m_head];
+    
+    // Layout runs inside the render phase; report the two separately
+    if (m_pendingUs[PHASE_RENDER] >= m_pendingUs[PHASE_LAYOUT]) {
+        m_pendingUs[PHASE_RENDER] -= m_pendingUs[PHASE_LAYOUT];
+    }
+    
+    record.totalUs = 0;
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        record.phaseUs[i] = m_pendingUs[i];
+        record.totalUs += m_pendingUs[i];
+        m_pendingUs[i] = 0;
+    }
+    
+    record.timestampUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now().time_since_epoch()).count();
+    record.drawCalls = (uint32_t)stats.drawCalls;
+    record.vertices = (uint32_t)stats.vertices;
+    record.stateChanges = (uint32_t)stats.stateChanges;
+    
+    m_head = (m_head + 1) % CAPACITY;
+    if (m_count < CAPACITY) {
+        m_count++;
+    }
+}
+
+const FrameProfiler::FrameRecord& FrameProfiler::getFrame(int age) const {
+    int index = (m_head - 1 - age + CAPACITY * 2) % CAPACITY;
+    return m_records[index];
+}
+
+void FrameProfiler::getPercentiles(uint32_t& p50, uint32_t& p95, uint32_t& p99) const {
+    p50 = p95 = p99 = 0;
+    if (m_count == 0) {
+        return;
+    }
+    
+    m_sortScratch.clear();
+    for (int i = 0; i < m_count; ++i) {
+        m_sortScratch.push_back(getFrame(i).totalUs);
+    }
+    
+    // Each nth_element leaves larger values to the right, so later calls can narrow the range
+    size_t i50 = (m_sortScratch.size() - 1) * 50 / 100;
+    size_t i95 = (m_sortScratch.size() - 1) * 95 / 100;
+    size_t i99 = (m_sortScratch.size() - 1) * 99 / 100;
+    std::nth_element(m_sortScratch.begin(), m_sortScratch.begin() + i50, m_sortScratch.end());
+    std::nth_element(m_sortScratch.begin() + i50, m_sortScratch.begin() + i95, m_sortScratch.end());
+    std::nth_element(m_sortScratch.begin() + i95, m_sortScratch.begin() + i99, m_sortScratch.end());
+    p50 = m_sortScratch[i50];
+    p95 = m_sortScratch[i95];
+    p99 = m_sortScratch[i99];
+}
+
+bool FrameProfiler::dumpCsv(const std::string& path) const {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        LOGE("Failed to open %s", path.c_str());
+        return false;
+    }
+    
+    fprintf(file, "timestamp_us");
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        fprintf(file, ",%s", PHASE_NAMES[i]);
+    }
+    fprintf(file, ",total_us,draw_calls,vertices,state_changes\n");
+    
+    for (int age = m_count - 1; age >= 0; --age) {
+        const FrameRecord& record = getFrame(age);
+        fprintf(file, "%llu", (unsigned long long)record.timestampUs);
+        for (int i = 0; i < PHASE_COUNT; ++i) {
+            fprintf(file, ",%u", record.phaseUs[i]);
+        }
+        fprintf(file, ",%u,%u,%u,%u\n", record.totalUs, record.drawCalls, record.vertices, record.stateChanges);
+    }
+    
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    LOGI("Dumped %d frames to %s", m_count, path.c_str());
+    return ok;
+}
+
+bool FrameProfiler::dumpCsvToOutputDirectory() const {
+    if (m_outputDirectory.empty()) {
+        LOGE("No output directory for frame profile");
+        return false;
+    }
+    
+    return dumpCsv(m_outputDirectory + "/frame_profile.csv");
+}
@@ -0,0 +1,87 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct RenderStats;
+
+// Times the phases of each drawn frame and keeps the most recent frames in a
+// fixed-size ring buffer for the debug overlay and offline analysis.
+class FrameProfiler {
+public:
+    enum Phase {
+        PHASE_INPUT = 0,    // input dispatch since the previous frame
+        PHASE_UPDATE,       // WorkoutTracker::update
+        PHASE_LAYOUT,       // WorkoutTracker::updateLayout
+        PHASE_RENDER,       // scene rebuild/replay and batch submission (excluding layout)
+        PHASE_SWAP,         // eglSwapBuffers
+        PHASE_COUNT
+    };
+    
+    struct FrameRecord {
+        uint64_t timestampUs;           // frame end, steady clock
+        uint32_t phaseUs[PHASE_COUNT];
+        uint32_t totalUs;
+        uint32_t drawCalls;
+        uint32_t vertices;
+        uint32_t stateChanges;
+    };
+    
+    static const int CAPACITY = 4096;
+    
+    FrameProfiler();
+    
+    void beginPhase(Phase phase);
+    void endPhase(Phase phase);
+    
+    // Closes the frame: stores accumulated phase times and the renderer's counters
+    void endFrame(const RenderStats& stats);
+    
+    int getFrameCount() const { return m_count; }
+    // 0 is the most recent frame
+    const FrameRecord& getFrame(int age) const;
+    
+    // Percentiles of total frame time over the whole ring, in microseconds
+    void getPercentiles(uint32_t& p50, uint32_t& p95, uint32_t& p99) const;
+    
+    // Writes the ring, oldest frame first, as CSV
+    bool dumpCsv(const std::string& path) const;
+    
+    // Directory that dumpCsvToOutputDirectory writes into (e.g. the app's internal data path)
+    void setOutputDirectory(const std::string& directory) { m_outputDirectory = directory; }
+    bool dumpCsvToOutputDirectory() const;
+    
+private:
+    typedef std::chrono::steady_clock Clock;
+    
+    std::vector<FrameRecord> m_records;
+    int m_head;   // next slot to write
+    int m_count;
+    
+    uint32_t m_pendingUs[PHASE_COUNT];
+    Clock::time_point m_phaseStart[PHASE_COUNT];
+    std::string m_outputDirectory;
+    
+    mutable std::vector<uint32_t> m_sortScratch;
+};
+
+// Times a phase for the lifetime of the scope; a null profiler makes it a no-op
+class ProfileScope {
+public:
+    ProfileScope(FrameProfiler* profiler, FrameProfiler::Phase phase)
+        : m_profiler(profiler), m_phase(phase) {
+        if (m_profiler) m_profiler->beginPhase(m_phase);
+    }
+    ~ProfileScope() {
+        if (m_profiler) m_profiler->endPhase(m_phase);
+    }
+    
+private:
+    FrameProfiler* m_profiler;
+    FrameProfiler::Phase m_phase;
+};
+
+#endif // FRAME_PROFILER_H
@@ -0,0 +1,78 @@
+#include "FrameScheduler.h"
+#include <android/log.h>
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "FrameScheduler", __VA_ARGS__))
+
+static const int STATS_WINDOW_MS = 60000;
+
+FrameScheduler::FrameScheduler()
+    : m_invalid(true)
+    , m_hasDeadline(false)
+    , m_deadline()
+    , m_windowStart(Clock::now())
+    , m_windowWakeups(0)
+    , m_windowFrames(0)
+    , m_wakeupsPerMinute(0)
+    , m_framesPerMinute(0)
+{
+}
+
+void FrameScheduler::requestFrameIn(int delayMs) {
+    if (delayMs < 0) {
+        return;
+    }
+    
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(delayMs);
+    if (!m_hasDeadline || deadline < m_deadline) {
+        m_deadline = deadline;
+        m_hasDeadline = true;
+    }
+}
+
+int FrameScheduler::getPollTimeoutMs() const {
+    if (m_invalid) {
+        return 0;
+    }
+    
+    if (!m_hasDeadline) {
+        return -1;
+    }
+    
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_deadline - Clock::now());
+    return remaining.count() > 0 ? (int)remaining.count() : 0;
+}
+
+bool FrameScheduler::isFrameDue() const {
+    return m_invalid || (m_hasDeadline && Clock::now() >= m_deadline);
+}
+
+void FrameScheduler::onWakeup() {
+    m_windowWakeups++;
+    
+    Clock::time_point now = Clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_windowStart);
+    if (elapsed.count() >= STATS_WINDOW_MS) {
+        // Normalize to a minute; the window can be longer if the loop slept through its end
+        m_wakeupsPerMinute = (int)((long long)m_windowWakeups * STATS_WINDOW_MS / elapsed.count());
+        m_framesPerMinute = (int)((long long)m_windowFrames * STATS_WINDOW_MS / elapsed.count());
+        LOGI("Wakeups/min: %d, frames/min: %d", m_wakeupsPerMinute, m_framesPerMinute);
+        
+        m_windowStart = now;
+        m_windowWakeups = 0;
+        m_windowFrames = 0;
+    }
+}
+
+void FrameScheduler::onFrameRendered() {
+    m_windowFrames++;
+    onFrameSkipped();
+}
+
+void FrameScheduler::onFrameSkipped() {
+    m_invalid = false;
+    
+    // Deadlines still in the future were requested for a later frame
+    if (m_hasDeadline && Clock::now() >= m_deadline) {
+        m_hasDeadline = false;
+    }
+}
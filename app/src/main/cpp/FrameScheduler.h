@@ -0,0 +1,46 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <chrono>
+
+// Decides when the main loop has to wake up and whether a frame must be drawn.
+// Sources of work either invalidate the screen (input, window changes) or
+// request a frame at a deadline (clock ticks, button highlight release).
+class FrameScheduler {
+public:
+    typedef std::chrono::steady_clock Clock;
+    
+    FrameScheduler();
+    
+    // Something visible changed; render on the next loop iteration
+    void invalidate() { m_invalid = true; }
+    
+    // Render no later than delayMs from now; the earliest request wins
+    void requestFrameIn(int delayMs);
+    
+    // Timeout for ALooper_pollAll: 0 when a frame is due, -1 to block until an event arrives
+    int getPollTimeoutMs() const;
+    bool isFrameDue() const;
+    
+    void onWakeup();
+    void onFrameRendered();
+    // The frame was due but nothing had changed, so nothing was drawn
+    void onFrameSkipped();
+    
+    // Rates measured over the last complete one-minute window
+    int getWakeupsPerMinute() const { return m_wakeupsPerMinute; }
+    int getFramesPerMinute() const { return m_framesPerMinute; }
+    
+private:
+    bool m_invalid;
+    bool m_hasDeadline;
+    Clock::time_point m_deadline;
+    
+    Clock::time_point m_windowStart;
+    int m_windowWakeups;
+    int m_windowFrames;
+    int m_wakeupsPerMinute;
+    int m_framesPerMinute;
+};
+
+#endif // FRAME_SCHEDULER_H
@@ -0,0 +1,489 @@
+#include "GLRenderBackend.h"
+#include <android/log.h>
+#include <cstddef>
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "GLRenderBackend", __VA_ARGS__))
+#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "GLRenderBackend", __VA_ARGS__))
+
+static const char* vertexShaderSource = R"(
+attribute vec2 a_position;
+attribute vec2 a_texCoord;
+attribute vec4 a_color;
+attribute vec4 a_shape;
+uniform mat4 u_matrix;
+varying vec2 v_texCoord;
+varying vec4 v_color;
+varying vec4 v_shape;
+
+void main() {
+    gl_Position = u_matrix * vec4(a_position, 0.0, 1.0);
+    v_texCoord = a_texCoord;
+    v_color = a_color;
+    v_shape = a_shape;
+}
+)";
+
+// Shaped quads evaluate a rounded-box signed distance (circles are boxes whose
+// radius equals the half size, strokes take the distance's absolute value) and
+// turn it into one pixel of analytic antialiasing. Offsets reach hundreds of
+// pixels, hence highp where the GPU supports it. Untextured quads carry
+// texcoord (-1, -1) and are fully covered; textured quads use the texel alpha,
+// or with a distance-field texture (shape.z = distance change per screen
+// pixel) the same one pixel ramp across the stored outline.
+static const char* fragmentShaderSource = R"(
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+uniform sampler2D u_texture;
+varying vec2 v_texCoord;
+varying vec4 v_color;
+varying vec4 v_shape;
+
+void main() {
+    float coverage;
+    if (v_shape.x > 0.0) {
+        vec2 q = abs(v_texCoord) - v_shape.xy + v_shape.z;
+        float dist = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - v_shape.z;
+        if (v_shape.w > 0.0) {
+            dist = abs(dist + v_shape.w * 0.5) - v_shape.w * 0.5;
+        }
+        coverage = clamp(0.5 - dist, 0.0, 1.0);
+    } else if (v_shape.z > 0.0) {
+        float dist = texture2D(u_texture, v_texCoord).a - 0.5;
+        coverage = clamp(dist / v_shape.z + 0.5, 0.0, 1.0);
+    } else {
+        coverage = max(texture2D(u_texture, v_texCoord).a, step(v_texCoord.x, -0.5));
+    }
+    gl_FragColor = vec4(v_color.rgb, v_color.a * coverage);
+}
+)";
+
+GLRenderBackend::GLRenderBackend(ANativeWindow* window)
+    : m_window(window)
+    , m_display(EGL_NO_DISPLAY)
+    , m_surface(EGL_NO_SURFACE)
+    , m_context(EGL_NO_CONTEXT)
+    , m_config(nullptr)
+    , m_width(0)
+    , m_height(0)
+    , m_shaderProgram(0)
+    , m_positionHandle(0)
+    , m_colorHandle(0)
+    , m_matrixHandle(0)
+    , m_texCoordHandle(0)
+    , m_textureHandle(0)
+    , m_shapeHandle(0)
+    , m_vertexBuffer(0)
+    , m_indexBuffer(0)
+    , m_stateBound(false)
+    , m_scissorEnabled(false)
+    , m_boundTexture(0)
+{
+}
+
+GLRenderBackend::~GLRenderBackend() {
+    cleanup();
+}
+
+bool GLRenderBackend::initialize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    
+    if (!initializeEGL()) {
+        LOGE("Failed to initialize EGL");
+        return false;
+    }
+    
+    if (!createShaderProgram()) {
+        LOGE("Failed to create shader program");
+        cleanupEGL();
+        return false;
+    }
+    
+    if (!createBuffers()) {
+        LOGE("Failed to create batch buffers");
+        cleanup();
+        return false;
+    }
+    
+    LOGI("GL backend initialized: %d x %d", m_width, m_height);
+    return true;
+}
+
+void GLRenderBackend::cleanup() {
+    m_stateBound = false;
+    m_scissorEnabled = false;
+    m_boundTexture = 0;
+    
+    if (!m_textures.empty()) {
+        glDeleteTextures((GLsizei)m_textures.size(), m_textures.data());
+        m_textures.clear();
+    }
+    
+    if (m_vertexBuffer != 0) {
+        glDeleteBuffers(1, &m_vertexBuffer);
+        m_vertexBuffer = 0;
+    }
+    
+    if (m_indexBuffer != 0) {
+        glDeleteBuffers(1, &m_indexBuffer);
+        m_indexBuffer = 0;
+    }
+    
+    if (m_shaderProgram != 0) {
+        glDeleteProgram(m_shaderProgram);
+        m_shaderProgram = 0;
+    }
+    
+    cleanupEGL();
+}
+
+void GLRenderBackend::resize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    glViewport(0, 0, m_width, m_height);
+    // Projection depends on the window size
+    m_stateBound = false;
+}
+
+void GLRenderBackend::beginFrame() {
+    m_stateBound = false;
+    setClipRect(nullptr);
+    glViewport(0, 0, m_width, m_height);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void GLRenderBackend::clear(float r, float g, float b, float a) {
+    // The scissor test also limits glClear
+    if (m_scissorEnabled) {
+        glDisable(GL_SCISSOR_TEST);
+    }
+    glClearColor(r, g, b, a);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (m_scissorEnabled) {
+        glEnable(GL_SCISSOR_TEST);
+    }
+}
+
+void GLRenderBackend::setClipRect(const ClipRect* clip) {
+    if (!clip) {
+        if (m_scissorEnabled) {
+            glDisable(GL_SCISSOR_TEST);
+            m_scissorEnabled = false;
+        }
+        return;
+    }
+    
+    // GL counts scissor rows from the bottom of the surface
+    int width = clip->width > 0 ? clip->width : 0;
+    int height = clip->height > 0 ? clip->height : 0;
+    glScissor(clip->x, m_height - clip->y - height, width, height);
+    if (!m_scissorEnabled) {
+        glEnable(GL_SCISSOR_TEST);
+        m_scissorEnabled = true;
+    }
+}
+
+void GLRenderBackend::drawQuads(const BatchVertex* vertices, int quadCount, TextureHandle texture) {
+    if (m_shaderProgram == 0 || m_vertexBuffer == 0 || quadCount <= 0) {
+        return;
+    }
+    
+    if (!m_stateBound) {
+        bindState();
+    }
+    
+    if (texture != 0 && m_boundTexture != texture) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        m_boundTexture = texture;
+    }
+    
+    // Larger submissions are split to fit the 16-bit index buffer
+    while (quadCount > 0) {
+        int count = quadCount < MAX_QUADS_PER_DRAW ? quadCount : MAX_QUADS_PER_DRAW;
+        
+        // Respecify the whole store so the driver can hand us a fresh buffer
+        // instead of waiting for the previous draw to finish reading it
+        glBufferData(GL_ARRAY_BUFFER, count * 4 * sizeof(BatchVertex), vertices, GL_STREAM_DRAW);
+        glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_SHORT, nullptr);
+        
+        vertices += count * 4;
+        quadCount -= count;
+    }
+}
+
+void GLRenderBackend::present() {
+    if (m_display != EGL_NO_DISPLAY && m_surface != EGL_NO_SURFACE) {
+        eglSwapBuffers(m_display, m_surface);
+    }
+}
+
+TextureHandle GLRenderBackend::createAlphaTexture(const uint8_t* pixels, int width, int height) {
+    return createTexture(pixels, width, height, GL_NEAREST);
+}
+
+TextureHandle GLRenderBackend::createDistanceFieldTexture(const uint8_t* pixels, int width, int height) {
+    return createTexture(pixels, width, height, GL_LINEAR);
+}
+
+TextureHandle GLRenderBackend::createTexture(const uint8_t* pixels, int width, int height, GLint filter) {
+    if (m_display == EGL_NO_DISPLAY || !pixels || width <= 0 || height <= 0) {
+        return 0;
+    }
+    
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, width, height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, pixels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    m_boundTexture = texture;
+    m_textures.push_back(texture);
+    
+    return texture;
+}
+
+void GLRenderBackend::destroyTexture(TextureHandle texture) {
+    if (texture == m_boundTexture) {
+        m_boundTexture = 0;
+    }
+    
+    for (size_t i = 0; i < m_textures.size(); ++i) {
+        if (m_textures[i] == texture) {
+            m_textures.erase(m_textures.begin() + i);
+            glDeleteTextures(1, &texture);
+            break;
+        }
+    }
+}
+
+void GLRenderBackend::bindState() {
+    glUseProgram(m_shaderProgram);
+    
+    float matrix[16];
+    setupOrthographicMatrix(matrix, 0.0f, (float)m_width, (float)m_height, 0.0f);
+    glUniformMatrix4fv(m_matrixHandle, 1, GL_FALSE, matrix);
+    
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(m_textureHandle, 0);
+    
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    
+    glVertexAttribPointer(m_positionHandle, 2, GL_FLOAT, GL_FALSE, sizeof(BatchVertex),
+                          (const void*)offsetof(BatchVertex, x));
+    glEnableVertexAttribArray(m_positionHandle);
+    
+    glVertexAttribPointer(m_texCoordHandle, 2, GL_FLOAT, GL_FALSE, sizeof(BatchVertex),
+                          (const void*)offsetof(BatchVertex, u));
+    glEnableVertexAttribArray(m_texCoordHandle);
+    
+    glVertexAttribPointer(m_colorHandle, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(BatchVertex),
+                          (const void*)offsetof(BatchVertex, color));
+    glEnableVertexAttribArray(m_colorHandle);
+    
+    glVertexAttribPointer(m_shapeHandle, 4, GL_FLOAT, GL_FALSE, sizeof(BatchVertex),
+                          (const void*)offsetof(BatchVertex, shape));
+    glEnableVertexAttribArray(m_shapeHandle);
+    
+    // Antialiased shape edges and translucent colors need blending
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    m_stateBound = true;
+}
+
+bool GLRenderBackend::createBuffers() {
+    // Shared index pattern: every quad is two triangles over 4 consecutive vertices
+    std::vector<GLushort> indices(MAX_QUADS_PER_DRAW * 6);
+    for (int i = 0; i < MAX_QUADS_PER_DRAW; ++i) {
+        GLushort base = (GLushort)(i * 4);
+        indices[i * 6 + 0] = base;
+        indices[i * 6 + 1] = base + 1;
+        indices[i * 6 + 2] = base + 2;
+        indices[i * 6 + 3] = base;
+        indices[i * 6 + 4] = base + 2;
+        indices[i * 6 + 5] = base + 3;
+    }
+    
+    glGenBuffers(1, &m_indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+    
+    glGenBuffers(1, &m_vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, MAX_QUADS_PER_DRAW * 4 * sizeof(BatchVertex), nullptr, GL_STREAM_DRAW);
+    
+    return m_indexBuffer != 0 && m_vertexBuffer != 0;
+}
+
+bool GLRenderBackend::initializeEGL() {
+    m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (m_display == EGL_NO_DISPLAY) {
+        LOGE("eglGetDisplay failed");
+        return false;
+    }
+    
+    if (eglInitialize(m_display, nullptr, nullptr) == EGL_FALSE) {
+        LOGE("eglInitialize failed");
+        return false;
+    }
+    
+    const EGLint attribs[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
+        EGL_BLUE_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_RED_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    
+    EGLint numConfigs;
+    if (eglChooseConfig(m_display, attribs, &m_config, 1, &numConfigs) == EGL_FALSE) {
+        LOGE("eglChooseConfig failed");
+        cleanupEGL();
+        return false;
+    }
+    
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+        EGL_NONE
+    };
+    
+    m_context = eglCreateContext(m_display, m_config, EGL_NO_CONTEXT, contextAttribs);
+    if (m_context == EGL_NO_CONTEXT) {
+        LOGE("eglCreateContext failed");
+        cleanupEGL();
+        return false;
+    }
+    
+    const EGLint surfaceAttribs[] = {
+        EGL_NONE
+    };
+    
+    m_surface = eglCreateWindowSurface(m_display, m_config, m_window, surfaceAttribs);
+    if (m_surface == EGL_NO_SURFACE) {
+        LOGE("eglCreateWindowSurface failed");
+        cleanupEGL();
+        return false;
+    }
+    
+    if (eglMakeCurrent(m_display, m_surface, m_surface, m_context) == EGL_FALSE) {
+        LOGE("eglMakeCurrent failed");
+        cleanupEGL();
+        return false;
+    }
+    
+    return true;
+}
+
+void GLRenderBackend::cleanupEGL() {
+    if (m_display != EGL_NO_DISPLAY) {
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        
+        if (m_context != EGL_NO_CONTEXT) {
+            eglDestroyContext(m_display, m_context);
+            m_context = EGL_NO_CONTEXT;
+        }
+        
+        if (m_surface != EGL_NO_SURFACE) {
+            eglDestroySurface(m_display, m_surface);
+            m_surface = EGL_NO_SURFACE;
+        }
+        
+        eglTerminate(m_display);
+        m_display = EGL_NO_DISPLAY;
+    }
+}
+
+bool GLRenderBackend::createShaderProgram() {
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
+    glCompileShader(vertexShader);
+    
+    GLint compiled;
+    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled) {
+        GLchar infoLog[512];
+        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
+        LOGE("Vertex shader compilation failed: %s", infoLog);
+        glDeleteShader(vertexShader);
+        return false;
+    }
+    
+    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
+    glCompileShader(fragmentShader);
+    
+    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled) {
+        GLchar infoLog[512];
+        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
+        LOGE("Fragment shader compilation failed: %s", infoLog);
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return false;
+    }
+    
+    m_shaderProgram = glCreateProgram();
+    glAttachShader(m_shaderProgram, vertexShader);
+    glAttachShader(m_shaderProgram, fragmentShader);
+    glLinkProgram(m_shaderProgram);
+    
+    GLint linked;
+    glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        GLchar infoLog[512];
+        glGetProgramInfoLog(m_shaderProgram, 512, nullptr, infoLog);
+        LOGE("Shader program linking failed: %s", infoLog);
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        glDeleteProgram(m_shaderProgram);
+        m_shaderProgram = 0;
+        return false;
+    }
+    
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    
+    m_positionHandle = glGetAttribLocation(m_shaderProgram, "a_position");
+    m_texCoordHandle = glGetAttribLocation(m_shaderProgram, "a_texCoord");
+    m_colorHandle = glGetAttribLocation(m_shaderProgram, "a_color");
+    m_matrixHandle = glGetUniformLocation(m_shaderProgram, "u_matrix");
+    m_textureHandle = glGetUniformLocation(m_shaderProgram, "u_texture");
+    m_shapeHandle = glGetAttribLocation(m_shaderProgram, "a_shape");
+    
+    return true;
+}
+
+void GLRenderBackend::setupOrthographicMatrix(float* matrix, float left, float right, float bottom, float top) {
+    float near = -1.0f;
+    float far = 1.0f;
+    
+    matrix[0] = 2.0f / (right - left);
+    matrix[1] = 0.0f;
+    matrix[2] = 0.0f;
+    matrix[3] = 0.0f;
+    
+    matrix[4] = 0.0f;
+    matrix[5] = 2.0f / (top - bottom);
+    matrix[6] = 0.0f;
+    matrix[7] = 0.0f;
+    
+    matrix[8] = 0.0f;
+    matrix[9] = 0.0f;
+    matrix[10] = -2.0f / (far - near);
+    matrix[11] = 0.0f;
+    
+    matrix[12] = -(right + left) / (right - left);
+    matrix[13] = -(top + bottom) / (top - bottom);
+    matrix[14] = -(far + near) / (far - near);
+    matrix[15] = 1.0f;
+}
+
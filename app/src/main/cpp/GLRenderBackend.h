@@ -0,0 +1,67 @@
+#ifndef GL_RENDER_BACKEND_H
+#define GL_RENDER_BACKEND_H
+
+#include "RenderBackend.h"
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <android/native_window.h>
+#include <vector>
+
+// OpenGL ES 2.0 backend drawing into an ANativeWindow through EGL
+class GLRenderBackend : public RenderBackend {
+public:
+    // Indices are 16-bit, so one draw holds at most 65536 / 4 quads
+    static const int MAX_QUADS_PER_DRAW = 4096;
+    
+    explicit GLRenderBackend(ANativeWindow* window);
+    ~GLRenderBackend() override;
+    
+    bool initialize(int width, int height) override;
+    void cleanup() override;
+    void resize(int width, int height) override;
+    
+    void beginFrame() override;
+    void clear(float r, float g, float b, float a) override;
+    void setClipRect(const ClipRect* clip) override;
+    void drawQuads(const BatchVertex* vertices, int quadCount, TextureHandle texture) override;
+    void present() override;
+    
+    TextureHandle createAlphaTexture(const uint8_t* pixels, int width, int height) override;
+    TextureHandle createDistanceFieldTexture(const uint8_t* pixels, int width, int height) override;
+    void destroyTexture(TextureHandle texture) override;
+    
+private:
+    ANativeWindow* m_window;
+    EGLDisplay m_display;
+    EGLSurface m_surface;
+    EGLContext m_context;
+    EGLConfig m_config;
+    
+    int m_width;
+    int m_height;
+    
+    GLuint m_shaderProgram;
+    GLuint m_positionHandle;
+    GLuint m_colorHandle;
+    GLuint m_matrixHandle;
+    GLuint m_texCoordHandle;
+    GLuint m_textureHandle;
+    GLuint m_shapeHandle;
+    
+    GLuint m_vertexBuffer;
+    GLuint m_indexBuffer;
+    bool m_stateBound;
+    bool m_scissorEnabled;
+    GLuint m_boundTexture;
+    std::vector<GLuint> m_textures;
+    
+    bool initializeEGL();
+    void cleanupEGL();
+    bool createShaderProgram();
+    bool createBuffers();
+    TextureHandle createTexture(const uint8_t* pixels, int width, int height, GLint filter);
+    void bindState();
+    void setupOrthographicMatrix(float* matrix, float left, float right, float bottom, float top);
+};
+
+#endif // GL_RENDER_BACKEND_H
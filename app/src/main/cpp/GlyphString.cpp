@@ -0,0 +1,69 @@
+#include "GlyphString.h"
+#include "Utf8.h"
+#include <cstring>
+
+GlyphString& GlyphString::append(const char* text) {
+    if (!text) {
+        return *this;
+    }
+    
+    size_t length = std::strlen(text);
+    size_t offset = 0;
+    while (offset < length) {
+        appendCodepoint(decodeUtf8(text, length, offset));
+    }
+    return *this;
+}
+
+GlyphString& GlyphString::appendChar(char c) {
+    return appendCodepoint((uint8_t)c);
+}
+
+GlyphString& GlyphString::appendCodepoint(uint32_t codepoint) {
+    if (m_length < CAPACITY) {
+        m_codepoints[m_length++] = codepoint;
+    }
+    return *this;
+}
+
+GlyphString& GlyphString::appendInt(long long value) {
+    // Magnitude as unsigned so the most negative value does not overflow
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    if (value < 0) {
+        appendChar('-');
+    }
+    
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    
+    while (count > 0) {
+        appendChar(digits[--count]);
+    }
+    return *this;
+}
+
+GlyphString& GlyphString::appendWeight(float kilograms) {
+    appendInt((long long)kilograms);
+    return append("kg");
+}
+
+GlyphString& GlyphString::appendTime(int seconds) {
+    if (seconds < 0) {
+        seconds = 0;
+    }
+    
+    int minutes = seconds / 60;
+    int secs = seconds % 60;
+    if (minutes < 10) {
+        appendChar('0');
+    }
+    appendInt(minutes);
+    appendChar(':');
+    appendChar((char)('0' + secs / 10));
+    appendChar((char)('0' + secs % 10));
+    return *this;
+}
@@ -0,0 +1,38 @@
+#ifndef GLYPH_STRING_H
+#define GLYPH_STRING_H
+
+#include <cstdint>
+
+// Fixed-capacity label built on the stack for values that change from frame
+// to frame (counters, reps, weights, the workout clock). Text is decoded to
+// code points as it is appended and mapped to glyphs of the active font when
+// drawn, so formatting and drawing never touch the heap. Text beyond the
+// capacity is dropped.
+class GlyphString {
+public:
+    static const int CAPACITY = 64;
+    
+    GlyphString() : m_length(0) {}
+    
+    // UTF-8 text
+    GlyphString& append(const char* text);
+    // A single ASCII character
+    GlyphString& appendChar(char c);
+    GlyphString& appendCodepoint(uint32_t codepoint);
+    GlyphString& appendInt(long long value);
+    // Whole kilograms followed by "kg"; the bitmap font has no decimal point
+    GlyphString& appendWeight(float kilograms);
+    // mm:ss, minutes growing past two digits as needed
+    GlyphString& appendTime(int seconds);
+    
+    void clear() { m_length = 0; }
+    int length() const { return m_length; }
+    bool empty() const { return m_length == 0; }
+    const uint32_t* codepoints() const { return m_codepoints; }
+    
+private:
+    uint32_t m_codepoints[CAPACITY];
+    int m_length;
+};
+
+#endif // GLYPH_STRING_H
@@ -0,0 +1,426 @@
+#include "HistoryFile.h"
+#include "WorkoutJournal.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "HistoryFile", __VA_ARGS__))
+#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "HistoryFile", __VA_ARGS__))
+
+static uint32_t alignUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static uint32_t quantizeWeight(float weight) {
+    float steps = std::round(weight / HISTORY_WEIGHT_UNIT);
+    return steps > 0.0f ? (uint32_t)std::min(steps, 4.0e9f) : 0;
+}
+
+HistoryFile::HistoryFile()
+    : m_header(nullptr)
+    , m_blocks(nullptr)
+    , m_nameOffsets(nullptr)
+    , m_names(nullptr)
+    , m_data(nullptr)
+{
+}
+
+HistoryFile::~HistoryFile() {
+    close();
+}
+
+bool HistoryFile::openFile(const char* path) {
+    close();
+    return m_file.openFile(path) && useMapping();
+}
+
+bool HistoryFile::openDescriptor(int fd, off_t offset, size_t length) {
+    close();
+    return m_file.openDescriptor(fd, offset, length) && useMapping();
+}
+
+bool HistoryFile::useMapping() {
+    if (!validate(m_file.getData(), m_file.getLength())) {
+        LOGE("Invalid history file");
+        close();
+        return false;
+    }
+    
+    LOGI("History file mapped: %u workouts, %u sets in %u blocks", m_header->workoutCount, m_header->setCount,
+         m_header->blockCount);
+    return true;
+}
+
+bool HistoryFile::validate(const uint8_t* data, size_t length) {
+    if (length < sizeof(HistoryFileHeader)) {
+        return false;
+    }
+    
+    const HistoryFileHeader* header = reinterpret_cast<const HistoryFileHeader*>(data);
+    if (header->magic != HISTORY_FILE_MAGIC || header->version != HISTORY_FILE_VERSION ||
+        header->fileSize != length) {
+        return false;
+    }
+    
+    // Every section must lie inside the file, and the last name must end in it
+    uint64_t blocksEnd = (uint64_t)header->blocksOffset + (uint64_t)header->blockCount * sizeof(HistoryBlock);
+    uint64_t nameOffsetsEnd = (uint64_t)header->nameOffsetsOffset + (uint64_t)header->exerciseCount * sizeof(uint32_t);
+    uint64_t namesEnd = (uint64_t)header->namesOffset + header->namesSize;
+    uint64_t dataEnd = (uint64_t)header->dataOffset + header->dataSize;
+    if (blocksEnd > length || nameOffsetsEnd > length || namesEnd > length || dataEnd > length ||
+        header->blocksOffset % 8 != 0 || header->nameOffsetsOffset % 4 != 0 ||
+        (header->namesSize > 0 && data[namesEnd - 1] != 0)) {
+        return false;
+    }
+    
+    // Blocks are not scanned: their column offsets are checked by the cursor
+    m_header = header;
+    m_blocks = reinterpret_cast<const HistoryBlock*>(data + header->blocksOffset);
+    m_nameOffsets = reinterpret_cast<const uint32_t*>(data + header->nameOffsetsOffset);
+    m_names = reinterpret_cast<const char*>(data + header->namesOffset);
+    m_data = data + header->dataOffset;
+    return true;
+}
+
+void HistoryFile::close() {
+    m_file.close();
+    m_header = nullptr;
+    m_blocks = nullptr;
+    m_nameOffsets = nullptr;
+    m_names = nullptr;
+    m_data = nullptr;
+}
+
+bool HistoryFile::buildImage(const std::vector<JournalWorkout>& workouts, std::vector<uint8_t>& image) {
+    image.clear();
+    
+    std::unordered_map<std::string, uint32_t> exerciseIndices;
+    std::vector<uint32_t> nameOffsets;
+    std::string names;
+    std::vector<HistoryBlock> blocks;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> columns[4];
+    std::vector<uint8_t> completed;
+    uint32_t setCount = 0;
+    
+    for (size_t first = 0; first < workouts.size(); first += HISTORY_BLOCK_WORKOUTS) {
+        size_t last = std::min(workouts.size(), first + HISTORY_BLOCK_WORKOUTS);
+        HistoryBlock block;
+        std::memset(&block, 0, sizeof(block));
+        block.firstWorkout = (uint32_t)first;
+        block.workoutCount = (uint32_t)(last - first);
+        block.minStartMs = workouts[first].startMs;
+        block.maxStartMs = workouts[first].startMs;
+        block.minWeight = 0xFFFFFFFFu;
+        for (size_t w = first; w < last; ++w) {
+            block.minStartMs = std::min(block.minStartMs, workouts[w].startMs);
+            block.maxStartMs = std::max(block.maxStartMs, workouts[w].startMs);
+        }
+        
+        for (std::vector<uint8_t>& column : columns) {
+            column.clear();
+        }
+        completed.clear();
+        int64_t previousStart = block.minStartMs;
+        int64_t previousWeight = 0;
+        uint32_t blockSet = 0;
+        for (size_t w = first; w < last; ++w) {
+            const JournalWorkout& workout = workouts[w];
+            if (workout.active) {
+                return false;
+            }
+            putVarint(columns[0], zigzag(workout.startMs - previousStart));
+            putVarint(columns[0], workout.endMs > workout.startMs ? (uint64_t)(workout.endMs - workout.startMs) / 1000 : 0);
+            putVarint(columns[0], workout.exercises.size());
+            previousStart = workout.startMs;
+            block.exerciseCount += (uint32_t)workout.exercises.size();
+            
+            for (const JournalExercise& exercise : workout.exercises) {
+                auto found = exerciseIndices.find(exercise.name);
+                if (found == exerciseIndices.end()) {
+                    found = exerciseIndices.emplace(exercise.name, (uint32_t)nameOffsets.size()).first;
+                    nameOffsets.push_back((uint32_t)names.size());
+                    names.append(exercise.name.c_str(), exercise.name.size() + 1);
+                }
+                putVarint(columns[1], found->second);
+                putVarint(columns[1], exercise.sets.size());
+                
+                for (const JournalSet& set : exercise.sets) {
+                    uint32_t reps = set.reps > 0 ? (uint32_t)set.reps : 0;
+                    uint32_t weight = quantizeWeight(set.weight);
+                    putVarint(columns[2], reps);
+                    putVarint(columns[3], zigzag((int64_t)weight - previousWeight));
+                    previousWeight = weight;
+                    
+                    if (blockSet % 8 == 0) {
+                        completed.push_back(0);
+                    }
+                    if (set.completed) {
+                        completed.back() |= (uint8_t)(1u << (blockSet % 8));
+                        block.completedSets++;
+                        block.completedVolume += (uint64_t)reps * weight;
+                    }
+                    block.minWeight = std::min(block.minWeight, weight);
+                    block.maxWeight = std::max(block.maxWeight, weight);
+                    block.maxReps = std::max(block.maxReps, reps);
+                    blockSet++;
+                }
+            }
+        }
+        block.setCount = blockSet;
+        block.minWeight = blockSet > 0 ? block.minWeight : 0;
+        setCount += blockSet;
+        
+        block.workoutsOffset = (uint32_t)data.size();
+        data.insert(data.end(), columns[0].begin(), columns[0].end());
+        block.exercisesOffset = (uint32_t)data.size();
+        data.insert(data.end(), columns[1].begin(), columns[1].end());
+        block.repsOffset = (uint32_t)data.size();
+        data.insert(data.end(), columns[2].begin(), columns[2].end());
+        block.weightsOffset = (uint32_t)data.size();
+        data.insert(data.end(), columns[3].begin(), columns[3].end());
+        block.completedOffset = (uint32_t)data.size();
+        data.insert(data.end(), completed.begin(), completed.end());
+        block.endOffset = (uint32_t)data.size();
+        blocks.push_back(block);
+    }
+    
+    HistoryFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = HISTORY_FILE_MAGIC;
+    header.version = HISTORY_FILE_VERSION;
+    header.blockCount = (uint32_t)blocks.size();
+    header.workoutCount = (uint32_t)workouts.size();
+    header.setCount = setCount;
+    header.exerciseCount = (uint32_t)nameOffsets.size();
+    header.blocksOffset = alignUp(sizeof(HistoryFileHeader), 8);
+    header.nameOffsetsOffset = header.blocksOffset + (uint32_t)(blocks.size() * sizeof(HistoryBlock));
+    header.namesOffset = alignUp(header.nameOffsetsOffset + (uint32_t)(nameOffsets.size() * sizeof(uint32_t)), 4);
+    header.namesSize = (uint32_t)names.size();
+    header.dataOffset = alignUp(header.namesOffset + header.namesSize, 4);
+    header.dataSize = (uint32_t)data.size();
+    header.fileSize = alignUp(header.dataOffset + header.dataSize, 4);
+    
+    image.assign(header.fileSize, 0);
+    std::memcpy(&image[0], &header, sizeof(header));
+    if (!blocks.empty()) {
+        std::memcpy(&image[header.blocksOffset], blocks.data(), blocks.size() * sizeof(HistoryBlock));
+        std::memcpy(&image[header.dataOffset], data.data(), data.size());
+    }
+    if (!nameOffsets.empty()) {
+        std::memcpy(&image[header.nameOffsetsOffset], nameOffsets.data(), nameOffsets.size() * sizeof(uint32_t));
+        std::memcpy(&image[header.namesOffset], names.data(), names.size());
+    }
+    return true;
+}
+
+const char* HistoryFile::getExerciseName(uint32_t index) const {
+    if (index >= getExerciseCount()) {
+        return "";
+    }
+    uint32_t offset = m_nameOffsets[index];
+    return offset < m_header->namesSize ? m_names + offset : "";
+}
+
+uint32_t HistoryFile::findExercise(const std::string& name) const {
+    // Few distinct exercises, looked up once per query
+    uint32_t count = getExerciseCount();
+    for (uint32_t i = 0; i < count; ++i) {
+        if (name == getExerciseName(i)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+double HistoryFile::getVolume(int64_t fromMs, int64_t toMs) const {
+    double volume = 0.0;
+    for (uint32_t b = 0; b < getBlockCount(); ++b) {
+        const HistoryBlock& block = m_blocks[b];
+        if (block.maxStartMs < fromMs || block.minStartMs >= toMs || block.completedSets == 0) {
+            continue;
+        }
+        if (block.minStartMs >= fromMs && block.maxStartMs < toMs) {
+            volume += (double)block.completedVolume * HISTORY_WEIGHT_UNIT;
+            continue;
+        }
+        
+        HistoryCursor cursor(*this, b);
+        while (cursor.nextWorkout()) {
+            if (cursor.startMs < fromMs || cursor.startMs >= toMs) {
+                continue;
+            }
+            while (cursor.nextExercise()) {
+                while (cursor.nextSet()) {
+                    volume += cursor.completed ? (double)cursor.reps * cursor.weight : 0.0;
+                }
+            }
+        }
+    }
+    return volume;
+}
+
+float HistoryFile::getBestWeight(uint32_t exercise) const {
+    float best = 0.0f;
+    for (uint32_t b = 0; b < getBlockCount(); ++b) {
+        const HistoryBlock& block = m_blocks[b];
+        if (block.completedSets == 0 || (float)block.maxWeight * HISTORY_WEIGHT_UNIT <= best) {
+            continue;
+        }
+        
+        HistoryCursor cursor(*this, b);
+        while (cursor.nextWorkout()) {
+            while (cursor.nextExercise()) {
+                if (cursor.exercise != exercise) {
+                    continue;
+                }
+                while (cursor.nextSet()) {
+                    best = cursor.completed && cursor.weight > best ? cursor.weight : best;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+HistoryCursor::HistoryCursor(const HistoryFile& file, uint32_t block)
+    : startMs(0)
+    , durationSeconds(0)
+    , exerciseCount(0)
+    , exercise(0)
+    , setCount(0)
+    , reps(0)
+    , weight(0.0f)
+    , completed(false)
+    , m_completed(nullptr)
+    , m_completedEnd(nullptr)
+    , m_workoutsLeft(0)
+    , m_exercisesLeft(0)
+    , m_setsLeft(0)
+    , m_setIndex(0)
+    , m_weightSteps(0)
+    , m_ok(false)
+{
+    if (block >= file.getBlockCount()) {
+        return;
+    }
+    
+    // Columns must be in order and inside the data section
+    const HistoryBlock& summary = file.getBlock(block);
+    const uint32_t offsets[] = {
+        summary.workoutsOffset, summary.exercisesOffset, summary.repsOffset,
+        summary.weightsOffset, summary.completedOffset, summary.endOffset,
+    };
+    for (size_t i = 1; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+        if (offsets[i] < offsets[i - 1]) {
+            return;
+        }
+    }
+    if (summary.endOffset > file.m_header->dataSize || summary.endOffset - summary.completedOffset < (summary.setCount + 7) / 8) {
+        return;
+    }
+    
+    const uint8_t* data = file.m_data;
+    m_workouts = { data + summary.workoutsOffset, data + summary.exercisesOffset };
+    m_exercises = { data + summary.exercisesOffset, data + summary.repsOffset };
+    m_reps = { data + summary.repsOffset, data + summary.weightsOffset };
+    m_weights = { data + summary.weightsOffset, data + summary.completedOffset };
+    m_completed = data + summary.completedOffset;
+    m_completedEnd = data + summary.endOffset;
+    m_workoutsLeft = summary.workoutCount;
+    startMs = summary.minStartMs;
+    m_ok = true;
+}
+
+bool HistoryCursor::readVarint(Column& column, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && column.position < column.end; shift += 7) {
+        uint8_t byte = *column.position++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HistoryCursor::nextWorkout() {
+    while (nextExercise()) {
+    }
+    if (!m_ok || m_workoutsLeft == 0) {
+        return false;
+    }
+    
+    uint64_t delta;
+    uint64_t duration;
+    uint64_t exercises;
+    m_ok = readVarint(m_workouts, delta) && readVarint(m_workouts, duration) && readVarint(m_workouts, exercises);
+    if (!m_ok) {
+        return false;
+    }
+    startMs += unzigzag(delta);
+    durationSeconds = (uint32_t)duration;
+    exerciseCount = (uint32_t)exercises;
+    m_exercisesLeft = exerciseCount;
+    m_workoutsLeft--;
+    return true;
+}
+
+bool HistoryCursor::nextExercise() {
+    while (nextSet()) {
+    }
+    if (!m_ok || m_exercisesLeft == 0) {
+        return false;
+    }
+    
+    uint64_t index;
+    uint64_t sets;
+    m_ok = readVarint(m_exercises, index) && readVarint(m_exercises, sets);
+    if (!m_ok) {
+        return false;
+    }
+    exercise = (uint32_t)index;
+    setCount = (uint32_t)sets;
+    m_setsLeft = setCount;
+    m_exercisesLeft--;
+    return true;
+}
+
+bool HistoryCursor::nextSet() {
+    if (!m_ok || m_setsLeft == 0) {
+        return false;
+    }
+    
+    uint64_t repsValue;
+    uint64_t weightDelta;
+    m_ok = readVarint(m_reps, repsValue) && readVarint(m_weights, weightDelta) &&
+           m_completed + m_setIndex / 8 < m_completedEnd;
+    if (!m_ok) {
+        return false;
+    }
+    m_weightSteps += unzigzag(weightDelta);
+    reps = (uint32_t)repsValue;
+    weight = (float)m_weightSteps * HISTORY_WEIGHT_UNIT;
+    completed = (m_completed[m_setIndex / 8] >> (m_setIndex % 8)) & 1;
+    m_setIndex++;
+    m_setsLeft--;
+    return true;
+}
@@ -0,0 +1,178 @@
+#ifndef HISTORY_FILE_H
+#define HISTORY_FILE_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+struct JournalWorkout;
+
+// Finished workouts in columnar form, for browsing and analysing years of
+// history straight from a memory mapping:
+//
+//   HistoryFileHeader
+//   HistoryBlock blocks[blockCount]            summaries, in time order
+//   uint32_t nameOffsets[exerciseCount]         into the name pool
+//   char names[namesSize]                       NUL-terminated UTF-8
+//   uint8_t data[dataSize]                      the blocks' columns
+//
+// A block holds up to HISTORY_BLOCK_WORKOUTS workouts as separate columns,
+// each starting at its own offset into data:
+//
+//   workouts   per workout: zigzag varint start ms minus the previous start
+//              (the block's minStartMs for the first), varint duration in
+//              seconds, varint exercise count
+//   exercises  per exercise: varint exercise index, varint set count
+//   reps       per set: varint
+//   weights    per set: zigzag varint of the weight in HISTORY_WEIGHT_UNIT
+//              steps minus the previous set's in the block
+//   completed  one bit per set, LSB first
+//
+// Exercise indices are the file's own name table, so the file does not
+// depend on the catalog it was written with. Workout names are not stored.
+// All fixed-size sections are 4-byte aligned and little-endian.
+static const uint32_t HISTORY_FILE_MAGIC = 0x53485457; // "WTHS"
+static const uint32_t HISTORY_FILE_VERSION = 1;
+static const uint32_t HISTORY_BLOCK_WORKOUTS = 64;
+static const float HISTORY_WEIGHT_UNIT = 0.01f;     // kg
+
+struct HistoryFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t blockCount;
+    uint32_t workoutCount;
+    uint32_t setCount;
+    uint32_t exerciseCount;
+    uint32_t blocksOffset;
+    uint32_t nameOffsetsOffset;
+    uint32_t namesOffset;
+    uint32_t namesSize;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+};
+
+// Summary of one block: enough to skip it without decoding its columns
+struct HistoryBlock {
+    int64_t minStartMs;
+    int64_t maxStartMs;
+    uint64_t completedVolume;   // reps x HISTORY_WEIGHT_UNIT steps of completed sets
+    uint32_t firstWorkout;
+    uint32_t workoutCount;
+    uint32_t exerciseCount;
+    uint32_t setCount;
+    uint32_t completedSets;
+    uint32_t minWeight;         // HISTORY_WEIGHT_UNIT steps
+    uint32_t maxWeight;
+    uint32_t maxReps;
+    // Column offsets into data; each column ends where the next begins
+    uint32_t workoutsOffset;
+    uint32_t exercisesOffset;
+    uint32_t repsOffset;
+    uint32_t weightsOffset;
+    uint32_t completedOffset;
+    uint32_t endOffset;
+};
+
+// Read-only memory mapping of a history file. Opening checks the header and
+// the section bounds only; columns are decoded in place by HistoryCursor.
+class HistoryFile {
+public:
+    HistoryFile();
+    ~HistoryFile();
+    
+    HistoryFile(const HistoryFile&) = delete;
+    HistoryFile& operator=(const HistoryFile&) = delete;
+    
+    bool openFile(const char* path);
+    bool openDescriptor(int fd, off_t offset, size_t length);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    
+    // The stored format of the given workouts, which must be finished and
+    // in time order
+    static bool buildImage(const std::vector<JournalWorkout>& workouts, std::vector<uint8_t>& image);
+    
+    uint32_t getWorkoutCount() const { return m_header ? m_header->workoutCount : 0; }
+    uint32_t getSetCount() const { return m_header ? m_header->setCount : 0; }
+    uint32_t getBlockCount() const { return m_header ? m_header->blockCount : 0; }
+    const HistoryBlock& getBlock(uint32_t index) const { return m_blocks[index]; }
+    size_t getSize() const { return m_header ? m_header->fileSize : 0; }
+    
+    uint32_t getExerciseCount() const { return m_header ? m_header->exerciseCount : 0; }
+    // Empty for an unknown index
+    const char* getExerciseName(uint32_t index) const;
+    // Exact name; getExerciseCount() when missing
+    uint32_t findExercise(const std::string& name) const;
+    
+    // Volume (reps x weight of completed sets) of workouts started in
+    // [fromMs, toMs); only blocks straddling an end of the range are decoded
+    double getVolume(int64_t fromMs, int64_t toMs) const;
+    // Heaviest completed set of an exercise; blocks that cannot beat the
+    // best so far are skipped
+    float getBestWeight(uint32_t exercise) const;
+    
+private:
+    friend class HistoryCursor;
+    
+    MappedFile m_file;
+    const HistoryFileHeader* m_header;
+    const HistoryBlock* m_blocks;
+    const uint32_t* m_nameOffsets;
+    const char* m_names;
+    const uint8_t* m_data;
+    
+    bool useMapping();
+    bool validate(const uint8_t* data, size_t length);
+};
+
+// Walks one block workout by workout, exercise by exercise and set by set,
+// reading each column only as far as asked. Skipped exercises and sets are
+// stepped over, so a caller can stop at any level. Corrupt columns end the
+// walk early.
+class HistoryCursor {
+public:
+    HistoryCursor(const HistoryFile& file, uint32_t block);
+    
+    bool nextWorkout();
+    bool nextExercise();
+    bool nextSet();
+    
+    // Current workout
+    int64_t startMs;
+    uint32_t durationSeconds;
+    uint32_t exerciseCount;
+    // Current exercise
+    uint32_t exercise;
+    uint32_t setCount;
+    // Current set
+    uint32_t reps;
+    float weight;
+    bool completed;
+    
+private:
+    struct Column {
+        const uint8_t* position;
+        const uint8_t* end;
+    };
+    
+    Column m_workouts;
+    Column m_exercises;
+    Column m_reps;
+    Column m_weights;
+    const uint8_t* m_completed;
+    const uint8_t* m_completedEnd;
+    uint32_t m_workoutsLeft;
+    uint32_t m_exercisesLeft;
+    uint32_t m_setsLeft;
+    uint32_t m_setIndex;        // within the block, for the completed bits
+    int64_t m_weightSteps;
+    bool m_ok;
+    
+    static bool readVarint(Column& column, uint64_t& value);
+};
+
+#endif // HISTORY_FILE_H
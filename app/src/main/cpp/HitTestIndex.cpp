@@ -0,0 +1,114 @@
+#include "HitTestIndex.h"
+#include <algorithm>
+#include <cmath>
+
+// Band height in pixels: a touch scans only the targets crossing its band
+static const float BAND_HEIGHT = 64.0f;
+
+HitTestIndex::HitTestIndex()
+    : m_nextOrder(0)
+{
+}
+
+int HitTestIndex::add(int id, int z) {
+    int slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = (int)m_targets.size();
+        m_targets.push_back(Target());
+    }
+    
+    Target& target = m_targets[slot];
+    target.rect = LayoutRect();
+    target.id = id;
+    target.z = z;
+    target.order = m_nextOrder++;
+    target.enabled = true;
+    target.indexed = false;
+    target.firstBand = 0;
+    target.lastBand = -1;
+    return slot;
+}
+
+void HitTestIndex::remove(int slot) {
+    erase(slot);
+    m_freeSlots.push_back(slot);
+}
+
+void HitTestIndex::setRect(int slot, const LayoutRect& rect) {
+    erase(slot);
+    m_targets[slot].rect = rect;
+    insert(slot);
+}
+
+void HitTestIndex::setEnabled(int slot, bool enabled) {
+    if (m_targets[slot].enabled == enabled) {
+        return;
+    }
+    erase(slot);
+    m_targets[slot].enabled = enabled;
+    insert(slot);
+}
+
+int HitTestIndex::hitTest(float x, float y) const {
+    if (y < 0.0f) {
+        return HIT_TEST_NONE;
+    }
+    size_t band = (size_t)(y / BAND_HEIGHT);
+    if (band >= m_bands.size()) {
+        return HIT_TEST_NONE;
+    }
+    
+    const std::vector<int>& slots = m_bands[band];
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const Target& target = m_targets[slots[i]];
+        if (target.rect.contains(x, y)) {
+            return target.id;
+        }
+    }
+    return HIT_TEST_NONE;
+}
+
+bool HitTestIndex::isAbove(int slot, int other) const {
+    const Target& a = m_targets[slot];
+    const Target& b = m_targets[other];
+    return a.z != b.z ? a.z > b.z : a.order > b.order;
+}
+
+void HitTestIndex::insert(int slot) {
+    Target& target = m_targets[slot];
+    if (!target.enabled || target.rect.width <= 0.0f || target.rect.height <= 0.0f ||
+        target.rect.y + target.rect.height < 0.0f) {
+        return;
+    }
+    
+    // Edges are inclusive, so a rectangle ending on a band boundary is in both bands
+    target.firstBand = (int)std::max(0.0f, std::floor(target.rect.y / BAND_HEIGHT));
+    target.lastBand = (int)std::floor((target.rect.y + target.rect.height) / BAND_HEIGHT);
+    target.indexed = true;
+    if ((int)m_bands.size() <= target.lastBand) {
+        m_bands.resize(target.lastBand + 1);
+    }
+    
+    for (int band = target.firstBand; band <= target.lastBand; ++band) {
+        std::vector<int>& slots = m_bands[band];
+        std::vector<int>::iterator position = std::lower_bound(slots.begin(), slots.end(), slot,
+            [this](int a, int b) { return isAbove(a, b); });
+        slots.insert(position, slot);
+    }
+}
+
+void HitTestIndex::erase(int slot) {
+    Target& target = m_targets[slot];
+    if (!target.indexed) {
+        return;
+    }
+    
+    for (int band = target.firstBand; band <= target.lastBand; ++band) {
+        std::vector<int>& slots = m_bands[band];
+        slots.erase(std::find(slots.begin(), slots.end(), slot));
+    }
+    target.indexed = false;
+}
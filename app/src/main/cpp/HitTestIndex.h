@@ -0,0 +1,53 @@
+#ifndef HIT_TEST_INDEX_H
+#define HIT_TEST_INDEX_H
+
+#include "LayoutTree.h"
+#include <cstdint>
+#include <vector>
+
+static const int HIT_TEST_NONE = -1;
+
+// Touch targets bucketed into horizontal bands of the screen. Each band keeps
+// its targets ordered topmost first (higher z, then later added), so a touch
+// reads one band and stops at the first rectangle containing it. Targets are
+// moved band by band as the layout pass changes their rectangles; nothing is
+// rebuilt wholesale.
+class HitTestIndex {
+public:
+    HitTestIndex();
+    
+    // Returns a slot for the target; it takes part in hit tests once it has a
+    // non-empty rectangle and is enabled
+    int add(int id, int z);
+    void remove(int slot);
+    void setRect(int slot, const LayoutRect& rect);
+    void setEnabled(int slot, bool enabled);
+    
+    // Id of the topmost enabled target containing the point, or HIT_TEST_NONE
+    int hitTest(float x, float y) const;
+    
+    size_t getTargetCount() const { return m_targets.size() - m_freeSlots.size(); }
+    
+private:
+    struct Target {
+        LayoutRect rect;
+        int id;
+        int z;
+        uint32_t order;
+        bool enabled;
+        bool indexed;       // present in the bands firstBand..lastBand
+        int firstBand;
+        int lastBand;
+    };
+    
+    std::vector<Target> m_targets;
+    std::vector<int> m_freeSlots;
+    std::vector<std::vector<int>> m_bands;
+    uint32_t m_nextOrder;
+    
+    bool isAbove(int slot, int other) const;
+    void insert(int slot);
+    void erase(int slot);
+};
+
+#endif // HIT_TEST_INDEX_H
@@ -1,6 +1,140 @@
 #include "IconRenderer.h"
 #include "Renderer.h"
-#include <cmath>
+#include <vector>
+
+// Base meshes; arrows share one right-pointing mesh and differ by rotation
+enum IconMesh {
+    MESH_PLAY = 0,
+    MESH_PAUSE,
+    MESH_PLUS,
+    MESH_MINUS,
+    MESH_CHECK,
+    MESH_ARROW,
+    MESH_COUNT
+};
+
+// All meshes in one vertex array, in a unit square with y pointing down.
+// Quads are stored without the antialiasing pad; it is one pixel at any size,
+// so it is added per instance.
+struct IconMeshTable {
+    std::vector<BatchVertex> vertices;
+    int firstQuad[MESH_COUNT];
+    int quadCount[MESH_COUNT];
+};
+
+static void addMeshQuad(IconMeshTable& table, float x, float y, float width, float height,
+                        float radius, float strokeWidth) {
+    float halfWidth = width * 0.5f;
+    float halfHeight = height * 0.5f;
+    float maxRadius = halfWidth < halfHeight ? halfWidth : halfHeight;
+    
+    BatchVertex quad[4];
+    for (int i = 0; i < 4; ++i) {
+        quad[i].color[0] = quad[i].color[1] = quad[i].color[2] = quad[i].color[3] = 255;
+        quad[i].shape[0] = halfWidth;
+        quad[i].shape[1] = halfHeight;
+        quad[i].shape[2] = radius > maxRadius ? maxRadius : radius;
+        quad[i].shape[3] = strokeWidth;
+    }
+    quad[0].x = x;         quad[0].y = y;          quad[0].u = -halfWidth; quad[0].v = -halfHeight;
+    quad[1].x = x + width; quad[1].y = y;          quad[1].u = halfWidth;  quad[1].v = -halfHeight;
+    quad[2].x = x + width; quad[2].y = y + height; quad[2].u = halfWidth;  quad[2].v = halfHeight;
+    quad[3].x = x;         quad[3].y = y + height; quad[3].u = -halfWidth; quad[3].v = halfHeight;
+    table.vertices.insert(table.vertices.end(), quad, quad + 4);
+}
+
+// Right-pointing triangle as vertical strips that shrink towards the tip. Each
+// strip reaches back under its taller neighbour so no antialiased seam shows.
+static void addTriangleStrips(IconMeshTable& table, float baseX, float tipX, float centerY,
+                              float baseHeight, int strips) {
+    float stripWidth = (tipX - baseX) / (float)strips;
+    for (int i = 0; i < strips; ++i) {
+        float height = baseHeight * (1.0f - ((float)i + 0.5f) / (float)strips);
+        float overlap = i > 0 ? stripWidth * 0.5f : 0.0f;
+        addMeshQuad(table, baseX + stripWidth * (float)i - overlap, centerY - height * 0.5f,
+                    stripWidth + overlap, height, 0.0f, 0.0f);
+    }
+}
+
+// Round-capped line as overlapping dots, about a third of a thickness apart
+static void addDottedLine(IconMeshTable& table, float x0, float y0, float x1, float y1, float thickness) {
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float length = dx > 0.0f ? dx : -dx;
+    float lengthY = dy > 0.0f ? dy : -dy;
+    // Chebyshev length is enough to keep neighbouring dots overlapping
+    int steps = (int)((length > lengthY ? length : lengthY) / (thickness * 0.35f)) + 1;
+    float radius = thickness * 0.5f;
+    for (int i = 0; i <= steps; ++i) {
+        float t = (float)i / (float)steps;
+        addMeshQuad(table, x0 + dx * t - radius, y0 + dy * t - radius, thickness, thickness, radius, 0.0f);
+    }
+}
+
+static void beginMesh(IconMeshTable& table, IconMesh mesh) {
+    table.firstQuad[mesh] = (int)(table.vertices.size() / 4);
+}
+
+static void endMesh(IconMeshTable& table, IconMesh mesh) {
+    table.quadCount[mesh] = (int)(table.vertices.size() / 4) - table.firstQuad[mesh];
+}
+
+static IconMeshTable buildMeshTable() {
+    IconMeshTable table;
+    
+    beginMesh(table, MESH_PLAY);
+    addTriangleStrips(table, 0.3f, 0.78f, 0.5f, 0.62f, 8);
+    endMesh(table, MESH_PLAY);
+    
+    const float barWidth = 1.0f / 6.0f;
+    beginMesh(table, MESH_PAUSE);
+    addMeshQuad(table, 1.0f / 3.0f, 0.2f, barWidth, 0.6f, barWidth * 0.5f, 0.0f);
+    addMeshQuad(table, 1.0f - 1.0f / 3.0f - barWidth, 0.2f, barWidth, 0.6f, barWidth * 0.5f, 0.0f);
+    endMesh(table, MESH_PAUSE);
+    
+    const float thickness = 0.25f;
+    beginMesh(table, MESH_PLUS);
+    addMeshQuad(table, 0.25f, 0.5f - thickness * 0.5f, 0.5f, thickness, thickness * 0.25f, 0.0f);
+    addMeshQuad(table, 0.5f - thickness * 0.5f, 0.25f, thickness, 0.5f, thickness * 0.25f, 0.0f);
+    endMesh(table, MESH_PLUS);
+    
+    beginMesh(table, MESH_MINUS);
+    addMeshQuad(table, 0.25f, 0.5f - thickness * 0.5f, 0.5f, thickness, thickness * 0.25f, 0.0f);
+    endMesh(table, MESH_MINUS);
+    
+    beginMesh(table, MESH_CHECK);
+    addDottedLine(table, 0.2f, 0.5f, 0.42f, 0.72f, 1.0f / 6.0f);
+    addDottedLine(table, 0.42f, 0.72f, 0.8f, 0.3f, 1.0f / 6.0f);
+    endMesh(table, MESH_CHECK);
+    
+    beginMesh(table, MESH_ARROW);
+    addMeshQuad(table, 0.18f, 0.5f - 0.08f, 0.4f, 0.16f, 0.08f, 0.0f);
+    addTriangleStrips(table, 0.5f, 0.84f, 0.5f, 0.56f, 6);
+    endMesh(table, MESH_ARROW);
+    
+    return table;
+}
+
+static const IconMeshTable& getMeshTable() {
+    static const IconMeshTable table = buildMeshTable();
+    return table;
+}
+
+static void getIconMesh(IconType type, IconMesh& mesh, int& quarterTurns) {
+    quarterTurns = 0;
+    switch (type) {
+        case IconType::PLAY:        mesh = MESH_PLAY; break;
+        case IconType::PAUSE:       mesh = MESH_PAUSE; break;
+        case IconType::PLUS:        mesh = MESH_PLUS; break;
+        case IconType::MINUS:       mesh = MESH_MINUS; break;
+        case IconType::CHECK:       mesh = MESH_CHECK; break;
+        case IconType::ARROW_RIGHT: mesh = MESH_ARROW; break;
+        case IconType::ARROW_DOWN:  mesh = MESH_ARROW; quarterTurns = 1; break;
+        case IconType::ARROW_LEFT:  mesh = MESH_ARROW; quarterTurns = 2; break;
+        case IconType::ARROW_UP:    mesh = MESH_ARROW; quarterTurns = 3; break;
+        default:                    mesh = MESH_PLAY; break;
+    }
+}
 
 IconRenderer::IconRenderer()
     : m_renderer(nullptr)
@@ -13,6 +147,8 @@ IconRenderer::~IconRenderer() {
 
 bool IconRenderer::initialize(Renderer* renderer) {
     m_renderer = renderer;
+    // Tessellate up front rather than inside the first frame that shows an icon
+    getMeshTable();
     return m_renderer != nullptr;
 }
 
@@ -21,112 +157,92 @@ void IconRenderer::cleanup() {
 }
 
 void IconRenderer::drawIcon(float x, float y, IconType type, float size, float r, float g, float b, float a) {
-    if (!m_renderer) return;
-    
-    switch (type) {
-        case IconType::PLAY:
-            drawPlayIcon(x, y, size, r, g, b, a);
-            break;
-        case IconType::PAUSE:
-            drawPauseIcon(x, y, size, r, g, b, a);
-            break;
-        case IconType::PLUS:
-            drawPlusIcon(x, y, size, r, g, b, a);
-            break;
-        case IconType::MINUS:
-            drawMinusIcon(x, y, size, r, g, b, a);
-            break;
-        case IconType::CHECK:
-            drawCheckIcon(x, y, size, r, g, b, a);
-            break;
-        case IconType::ARROW_LEFT:
-            drawArrowIcon(x, y, size, r, g, b, a, 0.0f);
-            break;
-        case IconType::ARROW_RIGHT:
-            drawArrowIcon(x, y, size, r, g, b, a, 180.0f);
-            break;
-        case IconType::ARROW_UP:
-            drawArrowIcon(x, y, size, r, g, b, a, 90.0f);
-            break;
-        case IconType::ARROW_DOWN:
-            drawArrowIcon(x, y, size, r, g, b, a, 270.0f);
-            break;
-    }
+    IconInstance instance(type, x, y, size, r, g, b, a);
+    drawIcons(&instance, 1);
 }
 
-void IconRenderer::drawPlayIcon(float x, float y, float size, float r, float g, float b, float a) {
-    // Triangle pointing right
-    float centerX = x + size / 2.0f;
-    float centerY = y + size / 2.0f;
-    float halfSize = size / 3.0f;
-    
-    // Draw triangle using three rectangles (simplified)
-    float x1 = centerX - halfSize;
-    float y1 = centerY - halfSize;
-    float x2 = centerX + halfSize;
-    float y2 = centerY;
-    float x3 = centerX - halfSize;
-    float y3 = centerY + halfSize;
+void IconRenderer::drawIcons(const IconInstance* instances, int count) {
+    if (!m_renderer || !instances || count <= 0) return;
     
-    // Draw as filled triangle approximation
-    m_renderer->drawRect(x1, y1, halfSize * 2, halfSize, r, g, b, a);
-    m_renderer->drawRect(x1, centerY, halfSize * 2, halfSize, r, g, b, a);
-}
-
-void IconRenderer::drawPauseIcon(float x, float y, float size, float r, float g, float b, float a) {
-    float barWidth = size / 6.0f;
-    float barHeight = size * 0.6f;
-    float centerY = y + (size - barHeight) / 2.0f;
-    float gap = size / 3.0f;
+    // Sized up front: arena vectors leave a grown buffer behind
+    const IconMeshTable& table = getMeshTable();
+    size_t vertexCount = 0;
+    for (int i = 0; i < count; ++i) {
+        IconMesh mesh;
+        int turns;
+        getIconMesh(instances[i].type, mesh, turns);
+        vertexCount += (size_t)table.quadCount[mesh] * 4;
+    }
     
-    m_renderer->drawRect(x + gap, centerY, barWidth, barHeight, r, g, b, a);
-    m_renderer->drawRect(x + size - gap - barWidth, centerY, barWidth, barHeight, r, g, b, a);
-}
-
-void IconRenderer::drawPlusIcon(float x, float y, float size, float r, float g, float b, float a) {
-    float thickness = size / 4.0f;
-    float centerX = x + size / 2.0f;
-    float centerY = y + size / 2.0f;
+    FrameVector<BatchVertex> vertices{FrameArenaAllocator<BatchVertex>(&m_renderer->getFrameArena())};
+    vertices.reserve(vertexCount);
+    for (int i = 0; i < count; ++i) {
+        appendInstance(instances[i], vertices);
+    }
     
-    // Horizontal bar
-    m_renderer->drawRect(x + size * 0.25f, centerY - thickness / 2.0f, size * 0.5f, thickness, r, g, b, a);
-    // Vertical bar
-    m_renderer->drawRect(centerX - thickness / 2.0f, y + size * 0.25f, thickness, size * 0.5f, r, g, b, a);
+    m_renderer->drawQuads(vertices.data(), (int)(vertices.size() / 4));
 }
 
-void IconRenderer::drawMinusIcon(float x, float y, float size, float r, float g, float b, float a) {
-    float thickness = size / 4.0f;
-    float centerY = y + size / 2.0f;
+void IconRenderer::appendInstance(const IconInstance& instance, FrameVector<BatchVertex>& out) const {
+    if (instance.size <= 0.0f) {
+        return;
+    }
     
-    m_renderer->drawRect(x + size * 0.25f, centerY - thickness / 2.0f, size * 0.5f, thickness, r, g, b, a);
-}
-
-void IconRenderer::drawCheckIcon(float x, float y, float size, float r, float g, float b, float a) {
-    float thickness = size / 6.0f;
-    float startX = x + size * 0.2f;
-    float startY = y + size * 0.5f;
-    float endX = x + size * 0.45f;
-    float endY = y + size * 0.7f;
-    float tipX = x + size * 0.8f;
-    float tipY = y + size * 0.3f;
+    IconMesh mesh;
+    int turns;
+    getIconMesh(instance.type, mesh, turns);
+    turns = ((turns + instance.quarterTurns) % 4 + 4) % 4;
     
-    // Draw checkmark as two connected rectangles
-    float len1 = sqrtf((endX - startX) * (endX - startX) + (endY - startY) * (endY - startY));
-    float len2 = sqrtf((tipX - endX) * (tipX - endX) + (tipY - endY) * (tipY - endY));
+    const uint8_t color[4] = {
+        packColorComponent(instance.r),
+        packColorComponent(instance.g),
+        packColorComponent(instance.b),
+        packColorComponent(instance.a)
+    };
     
-    // Simplified: draw as horizontal and diagonal segments
-    m_renderer->drawRect(startX, startY, len1 * 0.7f, thickness, r, g, b, a);
-    m_renderer->drawRect(endX, endY - thickness, len2 * 0.6f, thickness, r, g, b, a);
-}
-
-void IconRenderer::drawArrowIcon(float x, float y, float size, float r, float g, float b, float a, float rotation) {
-    // Draw arrow as triangle + rectangle
-    float centerX = x + size / 2.0f;
-    float centerY = y + size / 2.0f;
-    float halfSize = size / 3.0f;
+    const IconMeshTable& table = getMeshTable();
+    const BatchVertex* src = table.vertices.data() + table.firstQuad[mesh] * 4;
+    const float size = instance.size;
+    const float pad = 1.0f;
     
-    // Simplified arrow (always points right, rotation not implemented for simplicity)
-    m_renderer->drawRect(centerX - halfSize, centerY - size / 6.0f, halfSize * 2, size / 3.0f, r, g, b, a);
-    m_renderer->drawRect(centerX + halfSize, centerY - halfSize, halfSize, halfSize * 2, r, g, b, a);
+    for (int q = 0; q < table.quadCount[mesh]; ++q, src += 4) {
+        float x0 = src[0].x;
+        float y0 = src[0].y;
+        float x1 = src[2].x;
+        float y1 = src[2].y;
+        // Clockwise quarter turns about the center keep quads axis-aligned,
+        // which is all the batch format can express
+        for (int t = 0; t < turns; ++t) {
+            float rx0 = 1.0f - y1;
+            float rx1 = 1.0f - y0;
+            y0 = x0;
+            y1 = x1;
+            x0 = rx0;
+            x1 = rx1;
+        }
+        
+        x0 = instance.x + x0 * size;
+        y0 = instance.y + y0 * size;
+        x1 = instance.x + x1 * size;
+        y1 = instance.y + y1 * size;
+        float halfWidth = (x1 - x0) * 0.5f;
+        float halfHeight = (y1 - y0) * 0.5f;
+        
+        BatchVertex quad[4];
+        for (int i = 0; i < 4; ++i) {
+            quad[i].color[0] = color[0];
+            quad[i].color[1] = color[1];
+            quad[i].color[2] = color[2];
+            quad[i].color[3] = color[3];
+            quad[i].shape[0] = halfWidth;
+            quad[i].shape[1] = halfHeight;
+            quad[i].shape[2] = src[0].shape[2] * size;
+            quad[i].shape[3] = src[0].shape[3] * size;
+        }
+        quad[0].x = x0 - pad; quad[0].y = y0 - pad; quad[0].u = -halfWidth - pad; quad[0].v = -halfHeight - pad;
+        quad[1].x = x1 + pad; quad[1].y = y0 - pad; quad[1].u = halfWidth + pad;  quad[1].v = -halfHeight - pad;
+        quad[2].x = x1 + pad; quad[2].y = y1 + pad; quad[2].u = halfWidth + pad;  quad[2].v = halfHeight + pad;
+        quad[3].x = x0 - pad; quad[3].y = y1 + pad; quad[3].u = -halfWidth - pad; quad[3].v = halfHeight + pad;
+        out.insert(out.end(), quad, quad + 4);
+    }
 }
-
@@ -1,6 +1,9 @@
 #ifndef ICON_RENDERER_H
 #define ICON_RENDERER_H
 
+#include "RenderBackend.h"
+#include "FrameArena.h"
+
 class Renderer;
 
 enum class IconType {
@@ -15,6 +18,25 @@ enum class IconType {
     ARROW_DOWN
 };
 
+// One placed icon: top-left corner, edge length in pixels, extra clockwise
+// quarter turns on top of the type's own orientation, and color
+struct IconInstance {
+    IconType type;
+    float x, y;
+    float size;
+    int quarterTurns;
+    float r, g, b, a;
+    
+    IconInstance()
+        : type(IconType::PLAY), x(0.0f), y(0.0f), size(0.0f), quarterTurns(0)
+        , r(1.0f), g(1.0f), b(1.0f), a(1.0f) {}
+    IconInstance(IconType t, float px, float py, float s, float cr, float cg, float cb, float ca)
+        : type(t), x(px), y(py), size(s), quarterTurns(0), r(cr), g(cg), b(cb), a(ca) {}
+};
+
+// Icons are tessellated once, for all IconRenderers, into unit-square meshes of
+// SDF shape quads. Drawing only scales, turns, translates and colors a copy of
+// the mesh, and any number of instances go to the renderer in one call.
 class IconRenderer {
 public:
     IconRenderer();
@@ -24,17 +46,13 @@ public:
     void cleanup();
     
     void drawIcon(float x, float y, IconType type, float size, float r, float g, float b, float a);
+    void drawIcons(const IconInstance* instances, int count);
     
 private:
     Renderer* m_renderer;
     
-    void drawPlayIcon(float x, float y, float size, float r, float g, float b, float a);
-    void drawPauseIcon(float x, float y, float size, float r, float g, float b, float a);
-    void drawPlusIcon(float x, float y, float size, float r, float g, float b, float a);
-    void drawMinusIcon(float x, float y, float size, float r, float g, float b, float a);
-    void drawCheckIcon(float x, float y, float size, float r, float g, float b, float a);
-    void drawArrowIcon(float x, float y, float size, float r, float g, float b, float a, float rotation);
+    // Appends the transformed mesh of one instance to frame arena scratch
+    void appendInstance(const IconInstance& instance, FrameVector<BatchVertex>& out) const;
 };
 
 #endif // ICON_RENDERER_H
-
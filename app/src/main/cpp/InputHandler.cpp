@@ -26,11 +26,11 @@ int32_t InputHandler::handleEvent(AInputEvent* event, WorkoutTracker* tracker) {
         case AINPUT_EVENT_TYPE_MOTION:
             handleTouchEvent(event, tracker);
             return 1;
-            
+        
         case AINPUT_EVENT_TYPE_KEY:
             handleKeyEvent(event, tracker);
             return 1;
-            
+        
         default:
             return 0;
     }
@@ -48,12 +48,12 @@ void InputHandler::handleTouchEvent(AInputEvent* event, WorkoutTracker* tracker)
             m_lastTouchY = y;
             tracker->onTouchDown(x, y);
             break;
-            
+        
         case AMOTION_EVENT_ACTION_UP:
             m_touching = false;
             tracker->onTouchUp(x, y);
             break;
-            
+        
         case AMOTION_EVENT_ACTION_MOVE:
             if (m_touching) {
                 float dx = x - m_lastTouchX;
@@ -63,12 +63,12 @@ void InputHandler::handleTouchEvent(AInputEvent* event, WorkoutTracker* tracker)
                 m_lastTouchY = y;
             }
             break;
-            
+        
         case AMOTION_EVENT_ACTION_CANCEL:
             m_touching = false;
             tracker->onTouchCancel();
             break;
-            
+        
         default:
             break;
     }
@@ -83,8 +83,31 @@ void InputHandler::handleKeyEvent(AInputEvent* event, WorkoutTracker* tracker) {
             case AKEYCODE_BACK:
                 tracker->onBackPressed();
                 break;
-                
+            
+            case AKEYCODE_MENU:
+                // Debug overlay toggle (adb shell input keyevent KEYCODE_MENU)
+                tracker->toggleDebugMode();
+                break;
+            
+            case AKEYCODE_DEL:
+                tracker->onTextDelete();
+                break;
+            
+            case AKEYCODE_SPACE:
+                tracker->onTextInput(' ');
+                break;
+            
+            case AKEYCODE_MINUS:
+                tracker->onTextInput('-');
+                break;
+            
             default:
+                // Letters and digits for the exercise search (adb shell input text)
+                if (keyCode >= AKEYCODE_A && keyCode <= AKEYCODE_Z) {
+                    tracker->onTextInput((char)('a' + keyCode - AKEYCODE_A));
+                } else if (keyCode >= AKEYCODE_0 && keyCode <= AKEYCODE_9) {
+                    tracker->onTextInput((char)('0' + keyCode - AKEYCODE_0));
+                }
                 break;
         }
     }
@@ -23,6 +23,18 @@ public:
     static constexpr float ADD_SET_BUTTON_WIDTH = 280.0f;
     static constexpr float ADD_SET_BUTTON_HEIGHT = 100.0f;
     static constexpr float REPS_BUTTON_SIZE = 100.0f;
+    static constexpr float PROGRESS_BAR_HEIGHT = 8.0f;
+    static constexpr float SELECTION_ITEM_HEIGHT = 120.0f;
+    static constexpr float SELECTION_MODAL_HEIGHT_FRACTION = 0.6f;
+    static constexpr float SEARCH_FIELD_HEIGHT = 100.0f;
+    
+    // Exercise card controls, from the top-left of the card's padded content
+    static constexpr float CARD_ADD_SET_X = 500.0f;
+    static constexpr float CARD_ADD_SET_Y = 15.0f;
+    static constexpr float CARD_REPS_BUTTONS_X = 250.0f;
+    static constexpr float CARD_REPS_BUTTONS_Y = 60.0f;
+    // Exercise picker: the list starts below the modal's title
+    static constexpr float SELECTION_LIST_TOP = PADDING_LARGE * 2 + 60.0f;
     
     // Helper functions
     static float centerX(float width, float screenWidth) {
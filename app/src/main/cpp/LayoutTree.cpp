@@ -0,0 +1,377 @@
+#include "LayoutTree.h"
+#include "HitTestIndex.h"
+
+enum { EDGE_LEFT, EDGE_TOP, EDGE_RIGHT, EDGE_BOTTOM };
+
+// Size along one axis once the parent's content size is known
+static float resolveSize(LayoutSizeMode mode, float value, float measured, float available) {
+    switch (mode) {
+        case LAYOUT_SIZE_FRACTION:
+            return value * available;
+        case LAYOUT_SIZE_FILL:
+            return available > 0.0f ? available : 0.0f;
+        default:
+            return measured;
+    }
+}
+
+// Offset of a box inside a span, margins included
+static float alignOffset(LayoutAlign align, float span, float leading, float trailing, float size) {
+    switch (align) {
+        case LAYOUT_ALIGN_CENTER:
+            return leading + (span - leading - trailing - size) * 0.5f;
+        case LAYOUT_ALIGN_END:
+            return span - trailing - size;
+        default:
+            return leading;
+    }
+}
+
+LayoutNode::LayoutNode()
+    : m_parent(nullptr)
+    , m_hitIndex(nullptr)
+    , m_hitSlot(-1)
+    , m_hitEnabled(true)
+    , m_hitReachable(true)
+    , m_direction(LAYOUT_OVERLAY)
+    , m_spacing(0.0f)
+    , m_justify(LAYOUT_ALIGN_START)
+    , m_alignX(LAYOUT_ALIGN_START)
+    , m_alignY(LAYOUT_ALIGN_START)
+    , m_measuredWidth(0.0f)
+    , m_measuredHeight(0.0f)
+    , m_measureDirty(true)
+    , m_arrangeDirty(true)
+{
+    m_width.mode = LAYOUT_SIZE_FILL;
+    m_width.value = 0.0f;
+    m_height.mode = LAYOUT_SIZE_FILL;
+    m_height.value = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        m_margin[i] = 0.0f;
+        m_padding[i] = 0.0f;
+    }
+}
+
+LayoutNode::~LayoutNode() {
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        delete m_children[i];
+    }
+    if (m_hitSlot >= 0) {
+        m_hitIndex->remove(m_hitSlot);
+    }
+}
+
+LayoutNode* LayoutNode::addChild() {
+    LayoutNode* child = new LayoutNode();
+    child->m_parent = this;
+    child->m_hitIndex = m_hitIndex;
+    child->m_hitReachable = m_hitReachable;
+    m_children.push_back(child);
+    invalidate();
+    return child;
+}
+
+void LayoutNode::removeChildren(size_t first) {
+    if (first >= m_children.size()) {
+        return;
+    }
+    
+    for (size_t i = first; i < m_children.size(); ++i) {
+        delete m_children[i];
+    }
+    m_children.erase(m_children.begin() + first, m_children.end());
+    invalidate();
+}
+
+void LayoutNode::setDirection(LayoutDirection direction) {
+    if (direction != m_direction) {
+        m_direction = direction;
+        invalidate();
+    }
+}
+
+void LayoutNode::setWidth(LayoutSizeMode mode, float value) {
+    if (mode != m_width.mode || value != m_width.value) {
+        m_width.mode = mode;
+        m_width.value = value;
+        invalidate();
+    }
+}
+
+void LayoutNode::setHeight(LayoutSizeMode mode, float value) {
+    if (mode != m_height.mode || value != m_height.value) {
+        m_height.mode = mode;
+        m_height.value = value;
+        invalidate();
+    }
+}
+
+void LayoutNode::setMargin(float left, float top, float right, float bottom) {
+    if (left != m_margin[EDGE_LEFT] || top != m_margin[EDGE_TOP] ||
+        right != m_margin[EDGE_RIGHT] || bottom != m_margin[EDGE_BOTTOM]) {
+        m_margin[EDGE_LEFT] = left;
+        m_margin[EDGE_TOP] = top;
+        m_margin[EDGE_RIGHT] = right;
+        m_margin[EDGE_BOTTOM] = bottom;
+        invalidate();
+    }
+}
+
+void LayoutNode::setPadding(float left, float top, float right, float bottom) {
+    if (left != m_padding[EDGE_LEFT] || top != m_padding[EDGE_TOP] ||
+        right != m_padding[EDGE_RIGHT] || bottom != m_padding[EDGE_BOTTOM]) {
+        m_padding[EDGE_LEFT] = left;
+        m_padding[EDGE_TOP] = top;
+        m_padding[EDGE_RIGHT] = right;
+        m_padding[EDGE_BOTTOM] = bottom;
+        invalidate();
+    }
+}
+
+void LayoutNode::setSpacing(float spacing) {
+    if (spacing != m_spacing) {
+        m_spacing = spacing;
+        invalidate();
+    }
+}
+
+void LayoutNode::setJustify(LayoutAlign justify) {
+    if (justify != m_justify) {
+        m_justify = justify;
+        invalidate();
+    }
+}
+
+void LayoutNode::setAlign(LayoutAlign alignX, LayoutAlign alignY) {
+    if (alignX != m_alignX || alignY != m_alignY) {
+        m_alignX = alignX;
+        m_alignY = alignY;
+        invalidate();
+    }
+}
+
+void LayoutNode::setHitTarget(int id, int z) {
+    if (m_hitSlot >= 0) {
+        m_hitIndex->remove(m_hitSlot);
+    }
+    m_hitSlot = m_hitIndex->add(id, z);
+    m_hitIndex->setEnabled(m_hitSlot, m_hitReachable);
+    m_hitIndex->setRect(m_hitSlot, m_rect);
+}
+
+void LayoutNode::setHitEnabled(bool enabled) {
+    if (enabled != m_hitEnabled) {
+        m_hitEnabled = enabled;
+        updateHitReachable(m_parent ? m_parent->m_hitReachable : true);
+    }
+}
+
+void LayoutNode::updateHitReachable(bool parentReachable) {
+    bool reachable = parentReachable && m_hitEnabled;
+    if (reachable == m_hitReachable) {
+        return;
+    }
+    
+    m_hitReachable = reachable;
+    if (m_hitSlot >= 0) {
+        m_hitIndex->setEnabled(m_hitSlot, reachable);
+    }
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        m_children[i]->updateHitReachable(reachable);
+    }
+}
+
+LayoutRect LayoutNode::getContentRect() const {
+    return LayoutRect(m_rect.x + m_padding[EDGE_LEFT], m_rect.y + m_padding[EDGE_TOP],
+                      m_rect.width - m_padding[EDGE_LEFT] - m_padding[EDGE_RIGHT],
+                      m_rect.height - m_padding[EDGE_TOP] - m_padding[EDGE_BOTTOM]);
+}
+
+void LayoutNode::invalidate() {
+    // Ancestors of a dirty node are dirty already, so the walk can stop there
+    for (LayoutNode* node = this; node && !(node->m_measureDirty && node->m_arrangeDirty); node = node->m_parent) {
+        node->m_measureDirty = true;
+        node->m_arrangeDirty = true;
+    }
+}
+
+void LayoutNode::invalidateTree() {
+    m_measureDirty = true;
+    m_arrangeDirty = true;
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        m_children[i]->invalidateTree();
+    }
+}
+
+void LayoutNode::measure(LayoutStats& stats) {
+    if (!m_measureDirty) {
+        return;
+    }
+    m_measureDirty = false;
+    stats.nodesMeasured++;
+    
+    // Fill and fraction children have no intrinsic size and add only their margins
+    float contentWidth = 0.0f;
+    float contentHeight = 0.0f;
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        LayoutNode* child = m_children[i];
+        child->measure(stats);
+        float width = child->m_measuredWidth + child->getMarginWidth();
+        float height = child->m_measuredHeight + child->getMarginHeight();
+        
+        if (m_direction == LAYOUT_COLUMN) {
+            contentWidth = width > contentWidth ? width : contentWidth;
+            contentHeight += height;
+        } else if (m_direction == LAYOUT_ROW) {
+            contentWidth += width;
+            contentHeight = height > contentHeight ? height : contentHeight;
+        } else {
+            contentWidth = width > contentWidth ? width : contentWidth;
+            contentHeight = height > contentHeight ? height : contentHeight;
+        }
+    }
+    
+    if (m_children.size() > 1) {
+        float gaps = m_spacing * (float)(m_children.size() - 1);
+        if (m_direction == LAYOUT_COLUMN) {
+            contentHeight += gaps;
+        } else if (m_direction == LAYOUT_ROW) {
+            contentWidth += gaps;
+        }
+    }
+    
+    m_measuredWidth = m_width.mode == LAYOUT_SIZE_FIXED ? m_width.value
+                    : m_width.mode == LAYOUT_SIZE_CONTENT ? contentWidth + m_padding[EDGE_LEFT] + m_padding[EDGE_RIGHT]
+                    : 0.0f;
+    m_measuredHeight = m_height.mode == LAYOUT_SIZE_FIXED ? m_height.value
+                     : m_height.mode == LAYOUT_SIZE_CONTENT ? contentHeight + m_padding[EDGE_TOP] + m_padding[EDGE_BOTTOM]
+                     : 0.0f;
+}
+
+void LayoutNode::arrange(const LayoutRect& rect, LayoutStats& stats) {
+    // A clean node that keeps its place keeps its whole subtree
+    if (!m_arrangeDirty && rect == m_rect) {
+        return;
+    }
+    
+    bool changed = rect != m_rect;
+    m_rect = rect;
+    m_arrangeDirty = false;
+    stats.nodesArranged++;
+    
+    if (m_direction == LAYOUT_OVERLAY) {
+        arrangeOverlay(getContentRect(), stats);
+    } else {
+        arrangeStack(getContentRect(), m_direction == LAYOUT_COLUMN, stats);
+    }
+    
+    if (changed && m_hitSlot >= 0) {
+        m_hitIndex->setRect(m_hitSlot, m_rect);
+    }
+    if (changed && m_onChanged) {
+        m_onChanged(m_rect);
+    }
+}
+
+void LayoutNode::arrangeOverlay(const LayoutRect& content, LayoutStats& stats) {
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        LayoutNode* child = m_children[i];
+        float width = resolveSize(child->m_width.mode, child->m_width.value, child->m_measuredWidth,
+                                  child->m_width.mode == LAYOUT_SIZE_FILL ? content.width - child->getMarginWidth()
+                                                                          : content.width);
+        float height = resolveSize(child->m_height.mode, child->m_height.value, child->m_measuredHeight,
+                                   child->m_height.mode == LAYOUT_SIZE_FILL ? content.height - child->getMarginHeight()
+                                                                            : content.height);
+        float x = alignOffset(child->m_alignX, content.width, child->m_margin[EDGE_LEFT], child->m_margin[EDGE_RIGHT], width);
+        float y = alignOffset(child->m_alignY, content.height, child->m_margin[EDGE_TOP], child->m_margin[EDGE_BOTTOM], height);
+        child->arrange(LayoutRect(content.x + x, content.y + y, width, height), stats);
+    }
+}
+
+void LayoutNode::arrangeStack(const LayoutRect& content, bool column, LayoutStats& stats) {
+    const int lead = column ? EDGE_TOP : EDGE_LEFT;
+    const int trail = column ? EDGE_BOTTOM : EDGE_RIGHT;
+    const int crossLead = column ? EDGE_LEFT : EDGE_TOP;
+    const int crossTrail = column ? EDGE_RIGHT : EDGE_BOTTOM;
+    float mainSize = column ? content.height : content.width;
+    float crossSize = column ? content.width : content.height;
+    
+    // First pass: space taken by sized children, margins and gaps
+    float used = 0.0f;
+    float fillWeight = 0.0f;
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        const LayoutNode* child = m_children[i];
+        const Size& size = column ? child->m_height : child->m_width;
+        used += child->m_margin[lead] + child->m_margin[trail];
+        if (size.mode == LAYOUT_SIZE_FILL) {
+            fillWeight += size.value > 0.0f ? size.value : 1.0f;
+        } else {
+            used += resolveSize(size.mode, size.value, column ? child->m_measuredHeight : child->m_measuredWidth, mainSize);
+        }
+    }
+    if (m_children.size() > 1) {
+        used += m_spacing * (float)(m_children.size() - 1);
+    }
+    float remaining = mainSize > used ? mainSize - used : 0.0f;
+    
+    // Leftover space goes to fill children, or positions the whole stack
+    float position = 0.0f;
+    if (fillWeight == 0.0f) {
+        position = alignOffset(m_justify, remaining, 0.0f, 0.0f, 0.0f);
+    }
+    
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        LayoutNode* child = m_children[i];
+        const Size& mainMode = column ? child->m_height : child->m_width;
+        const Size& crossMode = column ? child->m_width : child->m_height;
+        
+        float main;
+        if (mainMode.mode == LAYOUT_SIZE_FILL) {
+            main = remaining * (mainMode.value > 0.0f ? mainMode.value : 1.0f) / fillWeight;
+        } else {
+            main = resolveSize(mainMode.mode, mainMode.value, column ? child->m_measuredHeight : child->m_measuredWidth,
+                               mainSize);
+        }
+        float crossMargins = child->m_margin[crossLead] + child->m_margin[crossTrail];
+        float cross = resolveSize(crossMode.mode, crossMode.value, column ? child->m_measuredWidth : child->m_measuredHeight,
+                                  crossMode.mode == LAYOUT_SIZE_FILL ? crossSize - crossMargins : crossSize);
+        float crossOffset = alignOffset(column ? child->m_alignX : child->m_alignY, crossSize,
+                                        child->m_margin[crossLead], child->m_margin[crossTrail], cross);
+        
+        position += child->m_margin[lead];
+        if (column) {
+            child->arrange(LayoutRect(content.x + crossOffset, content.y + position, cross, main), stats);
+        } else {
+            child->arrange(LayoutRect(content.x + position, content.y + crossOffset, main, cross), stats);
+        }
+        position += main + child->m_margin[trail] + m_spacing;
+    }
+}
+
+LayoutTree::LayoutTree()
+    : m_hitIndex(new HitTestIndex())
+    , m_root(new LayoutNode())
+{
+    m_root->m_hitIndex = m_hitIndex;
+}
+
+LayoutTree::~LayoutTree() {
+    // Nodes unregister their hit targets as they go
+    delete m_root;
+    delete m_hitIndex;
+}
+
+void LayoutTree::update(float width, float height) {
+    m_stats = LayoutStats();
+    m_root->measure(m_stats);
+    m_root->arrange(LayoutRect(0.0f, 0.0f, width, height), m_stats);
+}
+
+void LayoutTree::invalidateAll() {
+    m_root->invalidateTree();
+}
+
+int LayoutTree::hitTest(float x, float y) const {
+    return m_hitIndex->hitTest(x, y);
+}
@@ -0,0 +1,185 @@
+#ifndef LAYOUT_TREE_H
+#define LAYOUT_TREE_H
+
+#include <functional>
+#include <vector>
+
+class HitTestIndex;
+
+struct LayoutRect {
+    float x, y;
+    float width, height;
+    
+    LayoutRect() : x(0.0f), y(0.0f), width(0.0f), height(0.0f) {}
+    LayoutRect(float x_, float y_, float width_, float height_) : x(x_), y(y_), width(width_), height(height_) {}
+    
+    // Edges are inclusive, like the touch tests before the layout tree
+    bool contains(float px, float py) const {
+        return px >= x && px <= x + width && py >= y && py <= y + height;
+    }
+    bool contains(const LayoutRect& other) const {
+        return other.x >= x && other.x + other.width <= x + width &&
+               other.y >= y && other.y + other.height <= y + height;
+    }
+    bool intersects(const LayoutRect& other) const {
+        return other.x <= x + width && other.x + other.width >= x &&
+               other.y <= y + height && other.y + other.height >= y;
+    }
+    bool operator==(const LayoutRect& other) const {
+        return x == other.x && y == other.y && width == other.width && height == other.height;
+    }
+    bool operator!=(const LayoutRect& other) const { return !(*this == other); }
+};
+
+// How a node places its children inside its padded content box
+enum LayoutDirection {
+    LAYOUT_OVERLAY,     // each child on its own, offset by its margins
+    LAYOUT_COLUMN,      // stacked top to bottom
+    LAYOUT_ROW          // stacked left to right
+};
+
+// Size of a node along one axis
+enum LayoutSizeMode {
+    LAYOUT_SIZE_FIXED,      // value pixels
+    LAYOUT_SIZE_CONTENT,    // extent of the children plus padding
+    LAYOUT_SIZE_FRACTION,   // value times the parent's content size
+    LAYOUT_SIZE_FILL        // along a stack: the space left, shared by value
+                            // as weight; otherwise the whole content box
+};
+
+enum LayoutAlign {
+    LAYOUT_ALIGN_START,
+    LAYOUT_ALIGN_CENTER,
+    LAYOUT_ALIGN_END
+};
+
+// Work done by the last LayoutTree::update
+struct LayoutStats {
+    int nodesMeasured;
+    int nodesArranged;
+    
+    LayoutStats() : nodesMeasured(0), nodesArranged(0) {}
+};
+
+// Declarative box in the layout tree. Setters only record the change and mark
+// the node and its ancestors dirty; LayoutTree::update() then measures the
+// dirty nodes and arranges every node whose rectangle may have moved, skipping
+// clean subtrees whose rectangle stays the same.
+class LayoutNode {
+public:
+    typedef std::function<void(const LayoutRect&)> ChangeFunc;
+    
+    LayoutNode();
+    ~LayoutNode();
+    
+    LayoutNode(const LayoutNode&) = delete;
+    LayoutNode& operator=(const LayoutNode&) = delete;
+    
+    // The node owns its children
+    LayoutNode* addChild();
+    // Deletes the children from index first on
+    void removeChildren(size_t first);
+    void clearChildren() { removeChildren(0); }
+    size_t getChildCount() const { return m_children.size(); }
+    LayoutNode* getChild(size_t index) const { return m_children[index]; }
+    
+    void setDirection(LayoutDirection direction);
+    void setWidth(LayoutSizeMode mode, float value = 0.0f);
+    void setHeight(LayoutSizeMode mode, float value = 0.0f);
+    void setMargin(float left, float top, float right, float bottom);
+    void setPadding(float left, float top, float right, float bottom);
+    // Gap between the children of a stack
+    void setSpacing(float spacing);
+    // Where a stack puts its children when they leave space along its axis
+    void setJustify(LayoutAlign justify);
+    // Where the node sits in its parent's content box, on the axes the parent
+    // does not stack along
+    void setAlign(LayoutAlign alignX, LayoutAlign alignY);
+    
+    // Called from update() after the node's rectangle moved or resized, with
+    // its children already arranged
+    void setOnChanged(const ChangeFunc& onChanged) { m_onChanged = onChanged; }
+    
+    // Makes the node's rectangle a touch target reported by LayoutTree::hitTest;
+    // where targets overlap the higher z wins, then the later registered one
+    void setHitTarget(int id, int z);
+    // Touches pass through a disabled node and everything below it
+    void setHitEnabled(bool enabled);
+    
+    // Margin box excluded, padding included; valid after LayoutTree::update()
+    const LayoutRect& getRect() const { return m_rect; }
+    LayoutRect getContentRect() const;
+    
+    // Forces the node to be measured and arranged again
+    void invalidate();
+    
+private:
+    friend class LayoutTree;
+    
+    struct Size {
+        LayoutSizeMode mode;
+        float value;
+    };
+    
+    LayoutNode* m_parent;
+    std::vector<LayoutNode*> m_children;
+    HitTestIndex* m_hitIndex;
+    int m_hitSlot;
+    bool m_hitEnabled;          // own setting
+    bool m_hitReachable;        // own setting and every ancestor's
+    
+    LayoutDirection m_direction;
+    Size m_width;
+    Size m_height;
+    float m_margin[4];
+    float m_padding[4];
+    float m_spacing;
+    LayoutAlign m_justify;
+    LayoutAlign m_alignX;
+    LayoutAlign m_alignY;
+    ChangeFunc m_onChanged;
+    
+    // Intrinsic size from the last measure; 0 for fill and fraction axes
+    float m_measuredWidth;
+    float m_measuredHeight;
+    bool m_measureDirty;
+    bool m_arrangeDirty;
+    LayoutRect m_rect;
+    
+    void measure(LayoutStats& stats);
+    void arrange(const LayoutRect& rect, LayoutStats& stats);
+    void arrangeOverlay(const LayoutRect& content, LayoutStats& stats);
+    void arrangeStack(const LayoutRect& content, bool column, LayoutStats& stats);
+    void invalidateTree();
+    void updateHitReachable(bool parentReachable);
+    float getMarginWidth() const { return m_margin[0] + m_margin[2]; }
+    float getMarginHeight() const { return m_margin[1] + m_margin[3]; }
+};
+
+// Owns the root node, which always spans the viewport
+class LayoutTree {
+public:
+    LayoutTree();
+    ~LayoutTree();
+    
+    LayoutNode* getRoot() { return m_root; }
+    
+    // Brings every rectangle up to date for a width x height viewport. Cheap
+    // when nothing changed: a clean tree in an unchanged viewport is not visited.
+    void update(float width, float height);
+    // Measures and arranges every node on the next update
+    void invalidateAll();
+    
+    // Id of the topmost enabled hit target under the point as of the last
+    // update, or HIT_TEST_NONE
+    int hitTest(float x, float y) const;
+    
+    const LayoutStats& getStats() const { return m_stats; }
+    
+private:
+    HitTestIndex* m_hitIndex;
+    LayoutNode* m_root;
+    LayoutStats m_stats;
+};
+
+#endif // LAYOUT_TREE_H
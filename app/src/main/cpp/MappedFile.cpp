@@ -0,0 +1,67 @@
+#include "MappedFile.h"
+#include <android/log.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "MappedFile", __VA_ARGS__))
+
+MappedFile::MappedFile()
+    : m_mapping(nullptr)
+    , m_mappingLength(0)
+    , m_data(nullptr)
+    , m_length(0)
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::openFile(const char* path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        LOGE("Cannot open %s", path);
+        return false;
+    }
+    
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0 && openDescriptor(fd, 0, (size_t)info.st_size);
+    ::close(fd);
+    return ok;
+}
+
+bool MappedFile::openDescriptor(int fd, off_t offset, size_t length) {
+    close();
+    if (fd < 0 || length == 0) {
+        return false;
+    }
+    
+    // mmap offsets must be page aligned; APK assets start anywhere
+    long pageSize = sysconf(_SC_PAGESIZE);
+    off_t alignedOffset = offset - offset % pageSize;
+    size_t lead = (size_t)(offset - alignedOffset);
+    void* mapping = mmap(nullptr, length + lead, PROT_READ, MAP_PRIVATE, fd, alignedOffset);
+    if (mapping == MAP_FAILED) {
+        LOGE("Cannot map %zu bytes", length);
+        return false;
+    }
+    
+    m_mapping = mapping;
+    m_mappingLength = length + lead;
+    m_data = static_cast<const uint8_t*>(mapping) + lead;
+    m_length = length;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_mapping) {
+        munmap(m_mapping, m_mappingLength);
+    }
+    m_mapping = nullptr;
+    m_mappingLength = 0;
+    m_data = nullptr;
+    m_length = 0;
+}
@@ -0,0 +1,36 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+// Read-only memory mapping of a whole file or of a byte range of one, the
+// storage behind the assets and data files that are read in place
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool openFile(const char* path);
+    // Maps length bytes at offset of an open file, e.g. an uncompressed APK
+    // asset; the descriptor can be closed afterwards
+    bool openDescriptor(int fd, off_t offset, size_t length);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    
+    // The requested bytes, past any page alignment
+    const uint8_t* getData() const { return m_data; }
+    size_t getLength() const { return m_length; }
+    
+private:
+    void* m_mapping;
+    size_t m_mappingLength;
+    const uint8_t* m_data;
+    size_t m_length;
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,65 @@
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include <cstdint>
+
+typedef uint32_t TextureHandle; // 0 is never a valid texture
+
+// Interleaved vertex: position + texcoord + RGBA8 color + shape (36 bytes).
+// Solid, textured and SDF-shaped quads share one batch:
+//  - solid quads use texcoord (-1, -1) and a zero shape
+//  - textured quads use a zero shape; with a distance-field texture the shape
+//    is (0, 0, k, 0), k being the texel value change per screen pixel
+//  - shaped quads carry (halfWidth, halfHeight, cornerRadius, strokeWidth) and
+//    use the texcoord as the pixel offset from the shape's center
+struct BatchVertex {
+    float x, y;
+    float u, v;
+    uint8_t color[4];
+    float shape[4];
+};
+
+// Float color channel to the vertex's 8-bit value
+inline uint8_t packColorComponent(float c) {
+    if (c <= 0.0f) return 0;
+    if (c >= 1.0f) return 255;
+    return (uint8_t)(c * 255.0f + 0.5f);
+}
+
+// Pixel rectangle of the render target: columns x .. x + width - 1 and rows
+// y .. y + height - 1, top-left origin
+struct ClipRect {
+    int x, y;
+    int width, height;
+};
+
+// Device side of Renderer. Renderer does all batching and bookkeeping and
+// hands the backend finished batches of axis-aligned quads; each quad is four
+// vertices: top-left, top-right, bottom-right, bottom-left.
+class RenderBackend {
+public:
+    virtual ~RenderBackend() {}
+    
+    virtual bool initialize(int width, int height) = 0;
+    virtual void cleanup() = 0;
+    virtual void resize(int width, int height) = 0;
+    
+    // Also resets the clip to the whole target
+    virtual void beginFrame() = 0;
+    // Clears the whole target regardless of the clip
+    virtual void clear(float r, float g, float b, float a) = 0;
+    // Limits the pixels drawQuads writes; nullptr lifts the limit
+    virtual void setClipRect(const ClipRect* clip) = 0;
+    virtual void drawQuads(const BatchVertex* vertices, int quadCount, TextureHandle texture) = 0;
+    // Shows the finished frame (buffer swap for on-screen targets)
+    virtual void present() = 0;
+    
+    // Single-channel coverage textures, sampled with nearest filtering.
+    // Textures still alive at cleanup() are released with the device.
+    virtual TextureHandle createAlphaTexture(const uint8_t* pixels, int width, int height) = 0;
+    // Signed distance fields (128 on the outline), sampled with linear filtering
+    virtual TextureHandle createDistanceFieldTexture(const uint8_t* pixels, int width, int height) = 0;
+    virtual void destroyTexture(TextureHandle texture) = 0;
+};
+
+#endif // RENDER_BACKEND_H
@@ -1,321 +1,827 @@
 #include "Renderer.h"
 #include <android/log.h>
+#include <cstddef>
 #include <cmath>
 
 #define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "Renderer", __VA_ARGS__))
 #define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "Renderer", __VA_ARGS__))
 
-static const char* vertexShaderSource = R"(
-attribute vec4 a_position;
-attribute vec4 a_color;
-uniform mat4 u_matrix;
-varying vec4 v_color;
+static unsigned int s_nextContextId = 1;
 
-void main() {
-    gl_Position = u_matrix * a_position;
-    v_color = a_color;
+// First pixel whose center lies at or after the edge, as the backends rasterize
+static inline int pixelEdge(float edge) {
+    return (int)std::ceil(edge - 0.5f);
 }
-)";
 
-static const char* fragmentShaderSource = R"(
-precision mediump float;
-varying vec4 v_color;
-
-void main() {
-    gl_FragColor = v_color;
+void GeometryCache::updateBounds() {
+    if (vertices.empty()) {
+        bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0.0f;
+        return;
+    }
+    
+    bounds[0] = bounds[2] = vertices[0].x;
+    bounds[1] = bounds[3] = vertices[0].y;
+    for (size_t i = 1; i < vertices.size(); ++i) {
+        const BatchVertex& vertex = vertices[i];
+        if (vertex.x < bounds[0]) bounds[0] = vertex.x;
+        if (vertex.y < bounds[1]) bounds[1] = vertex.y;
+        if (vertex.x > bounds[2]) bounds[2] = vertex.x;
+        if (vertex.y > bounds[3]) bounds[3] = vertex.y;
+    }
 }
-)";
 
 Renderer::Renderer()
-    : m_window(nullptr)
-    , m_display(EGL_NO_DISPLAY)
-    , m_surface(EGL_NO_SURFACE)
-    , m_context(EGL_NO_CONTEXT)
-    , m_config(nullptr)
+    : m_backend(nullptr)
     , m_width(0)
     , m_height(0)
-    , m_shaderProgram(0)
-    , m_positionHandle(0)
-    , m_colorHandle(0)
-    , m_matrixHandle(0)
+    , m_batchTexture(0)
+    , m_stateSubmitted(false)
+    , m_submittedTexture(0)
+    , m_contextId(0)
+    , m_recording(nullptr)
+    , m_ownArena(4096)
+    , m_frameArena(&m_ownArena)
+    , m_trace(nullptr)
 {
+    m_batch.reserve(MAX_BATCH_QUADS * 4);
+    m_clipStack.reserve(MAX_CLIP_DEPTH);
 }
 
 Renderer::~Renderer() {
     cleanup();
 }
 
-bool Renderer::initialize(ANativeWindow* window, int width, int height) {
-    m_window = window;
-    m_width = width;
-    m_height = height;
-    
-    if (!initializeEGL()) {
-        LOGE("Failed to initialize EGL");
+bool Renderer::initialize(RenderBackend* backend, int width, int height) {
+    cleanup();
+    if (!backend) {
         return false;
     }
     
-    if (!createShaderProgram()) {
-        LOGE("Failed to create shader program");
-        cleanupEGL();
+    m_backend = backend;
+    m_width = width;
+    m_height = height;
+    
+    if (!m_backend->initialize(width, height)) {
+        LOGE("Failed to initialize render backend");
+        delete m_backend;
+        m_backend = nullptr;
         return false;
     }
     
+    m_contextId = s_nextContextId++;
     LOGI("Renderer initialized: %d x %d", m_width, m_height);
     return true;
 }
 
 void Renderer::cleanup() {
-    if (m_shaderProgram != 0) {
-        glDeleteProgram(m_shaderProgram);
-        m_shaderProgram = 0;
+    stopTrace();
+    m_textureCopies.clear();
+    m_batch.clear();
+    m_clipStack.clear();
+    m_recording = nullptr;
+    m_batchTexture = 0;
+    m_stateSubmitted = false;
+    m_submittedTexture = 0;
+    m_contextId = 0;
+    
+    if (m_backend) {
+        // The backend releases any textures still alive
+        m_backend->cleanup();
+        delete m_backend;
+        m_backend = nullptr;
     }
-    
-    cleanupEGL();
 }
 
 void Renderer::onWindowResized(int width, int height) {
+    if (m_trace) {
+        m_trace->writeOp(TRACE_RESIZE);
+        m_trace->writeI32(width);
+        m_trace->writeI32(height);
+    }
+    
+    submitBatch();
     m_width = width;
     m_height = height;
-    glViewport(0, 0, m_width, m_height);
+    if (m_backend) {
+        m_backend->resize(width, height);
+    }
+    m_stateSubmitted = false;
 }
 
 void Renderer::beginFrame() {
-    if (m_display == EGL_NO_DISPLAY || m_surface == EGL_NO_SURFACE) {
+    m_frameArena->reset();
+    if (!m_backend) {
         return;
     }
     
-    glViewport(0, 0, m_width, m_height);
-    glClear(GL_COLOR_BUFFER_BIT);
+    m_stats = RenderStats();
+    m_batch.clear();
+    m_stateSubmitted = false;
+    // The backend drops its clip in beginFrame
+    m_clipStack.clear();
+    
+    if (m_trace) {
+        m_frameStart = std::chrono::steady_clock::now();
+        m_trace->writeOp(TRACE_FRAME_BEGIN);
+        m_trace->writeU64(m_trace->getElapsedUs());
+    }
+    
+    m_backend->beginFrame();
 }
 
 void Renderer::endFrame() {
-    if (m_display != EGL_NO_DISPLAY && m_surface != EGL_NO_SURFACE) {
-        eglSwapBuffers(m_display, m_surface);
+    submitBatch();
+    m_lastFrameStats = m_stats;
+    
+    if (m_backend) {
+        m_backend->present();
+    }
+    
+    if (m_trace) {
+        auto frameUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_frameStart);
+        m_trace->writeOp(TRACE_FRAME_END);
+        m_trace->writeU32((uint32_t)frameUs.count());
+        m_trace->submit();
     }
 }
 
+bool Renderer::startTrace(const std::string& path) {
+    stopTrace();
+    if (!m_backend) {
+        return false;
+    }
+    
+    m_trace = new DrawTraceWriter();
+    if (!m_trace->open(path, m_width, m_height)) {
+        delete m_trace;
+        m_trace = nullptr;
+        return false;
+    }
+    
+    // Textures created before the trace started are recreated first
+    for (size_t i = 0; i < m_textureCopies.size(); ++i) {
+        traceTexture(m_textureCopies[i]);
+    }
+    m_frameStart = std::chrono::steady_clock::now();
+    return true;
+}
+
+void Renderer::stopTrace() {
+    if (!m_trace) {
+        return;
+    }
+    
+    m_trace->close();
+    delete m_trace;
+    m_trace = nullptr;
+}
+
+void Renderer::traceCall(DrawTraceOp op, const float* values, int count) {
+    m_trace->writeOp(op);
+    m_trace->writeFloats(values, count);
+}
+
+void Renderer::traceTexture(const TextureCopy& texture) {
+    m_trace->writeOp(texture.distanceField ? TRACE_CREATE_DISTANCE_FIELD_TEXTURE : TRACE_CREATE_TEXTURE);
+    m_trace->writeU32(texture.handle);
+    m_trace->writeI32(texture.width);
+    m_trace->writeI32(texture.height);
+    m_trace->writeBytes(texture.pixels.data(), texture.pixels.size());
+}
+
 void Renderer::clear(float r, float g, float b, float a) {
-    glClearColor(r, g, b, a);
-    glClear(GL_COLOR_BUFFER_BIT);
+    if (m_trace) {
+        const float values[4] = { r, g, b, a };
+        traceCall(TRACE_CLEAR, values, 4);
+    }
+    
+    // Clearing must not overwrite quads that are still queued
+    submitBatch();
+    if (m_backend) {
+        m_backend->clear(r, g, b, a);
+    }
 }
 
 void Renderer::drawRect(float x, float y, float width, float height, float r, float g, float b, float a) {
-    if (m_shaderProgram == 0) {
+    if (m_trace) {
+        const float values[8] = { x, y, width, height, r, g, b, a };
+        traceCall(TRACE_RECT, values, 8);
+    }
+    fillRect(x, y, width, height, r, g, b, a);
+}
+
+void Renderer::fillRect(float x, float y, float width, float height, float r, float g, float b, float a) {
+    if (!m_backend) {
         return;
     }
     
-    glUseProgram(m_shaderProgram);
-    
-    // Setup orthographic matrix
-    float matrix[16];
-    setupOrthographicMatrix(matrix, 0.0f, (float)m_width, (float)m_height, 0.0f);
-    glUniformMatrix4fv(m_matrixHandle, 1, GL_FALSE, matrix);
+    // Empty rects (e.g. a progress bar at 0%) produce no pixels
+    if (width <= 0.0f || height <= 0.0f) {
+        return;
+    }
     
-    // Setup vertices for rectangle
-    float vertices[] = {
-        x, y, 0.0f,
-        x + width, y, 0.0f,
-        x + width, y + height, 0.0f,
-        x, y + height, 0.0f
+    const uint8_t color[4] = {
+        packColorComponent(r),
+        packColorComponent(g),
+        packColorComponent(b),
+        packColorComponent(a)
     };
+    pushQuad(x, y, x + width, y + height, -1.0f, -1.0f, -1.0f, -1.0f, 0, color, nullptr);
+}
+
+void Renderer::drawTexturedRect(float x, float y, float width, float height,
+                                float u0, float v0, float u1, float v1, TextureHandle texture,
+                                float r, float g, float b, float a) {
+    if (m_trace) {
+        const float rect[8] = { x, y, width, height, u0, v0, u1, v1 };
+        const float color[4] = { r, g, b, a };
+        traceCall(TRACE_TEXTURED_RECT, rect, 8);
+        m_trace->writeU32(texture);
+        m_trace->writeFloats(color, 4);
+    }
     
-    float colors[] = {
-        r, g, b, a,
-        r, g, b, a,
-        r, g, b, a,
-        r, g, b, a
-    };
+    if (!m_backend || texture == 0) {
+        return;
+    }
     
-    GLushort indices[] = { 0, 1, 2, 0, 2, 3 };
+    if (width <= 0.0f || height <= 0.0f) {
+        return;
+    }
     
-    glVertexAttribPointer(m_positionHandle, 3, GL_FLOAT, GL_FALSE, 0, vertices);
-    glEnableVertexAttribArray(m_positionHandle);
+    const uint8_t color[4] = {
+        packColorComponent(r),
+        packColorComponent(g),
+        packColorComponent(b),
+        packColorComponent(a)
+    };
+    pushQuad(x, y, x + width, y + height, u0, v0, u1, v1, texture, color, nullptr);
+}
+
+void Renderer::useBatchTexture(TextureHandle texture) {
+    // Only one texture can be bound per draw; untextured quads don't care which
+    if (texture != 0 && texture != m_batchTexture) {
+        submitBatch();
+        m_batchTexture = texture;
+    }
+}
+
+void Renderer::pushClipRect(float x, float y, float width, float height) {
+    if (m_trace) {
+        const float values[4] = { x, y, width, height };
+        traceCall(TRACE_PUSH_CLIP, values, 4);
+    }
     
-    glVertexAttribPointer(m_colorHandle, 4, GL_FLOAT, GL_FALSE, 0, colors);
-    glEnableVertexAttribArray(m_colorHandle);
+    int x0 = pixelEdge(x);
+    int y0 = pixelEdge(y);
+    int x1 = pixelEdge(x + width);
+    int y1 = pixelEdge(y + height);
+    if (!m_clipStack.empty()) {
+        const ClipRect& outer = m_clipStack.back();
+        if (x0 < outer.x) x0 = outer.x;
+        if (y0 < outer.y) y0 = outer.y;
+        if (x1 > outer.x + outer.width) x1 = outer.x + outer.width;
+        if (y1 > outer.y + outer.height) y1 = outer.y + outer.height;
+    }
     
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, indices);
+    ClipRect clip;
+    clip.x = x0;
+    clip.y = y0;
+    clip.width = x1 > x0 ? x1 - x0 : 0;
+    clip.height = y1 > y0 ? y1 - y0 : 0;
+    m_clipStack.push_back(clip);
+    applyClip();
+}
+
+void Renderer::popClipRect() {
+    if (m_trace) {
+        m_trace->writeOp(TRACE_POP_CLIP);
+    }
     
-    glDisableVertexAttribArray(m_positionHandle);
-    glDisableVertexAttribArray(m_colorHandle);
+    if (m_clipStack.empty()) {
+        LOGE("popClipRect without pushClipRect");
+        return;
+    }
+    m_clipStack.pop_back();
+    applyClip();
 }
 
-void Renderer::drawText(float x, float y, const char* text, float r, float g, float b, float a) {
-    // Legacy method - kept for compatibility
-    // Text rendering is now handled by TextRenderer class
-    drawRect(x, y, 100.0f, 20.0f, r, g, b, a * 0.5f);
+void Renderer::applyClip() {
+    // Queued quads belong to the previous clip
+    submitBatch();
+    if (m_backend) {
+        m_backend->setClipRect(m_clipStack.empty() ? nullptr : &m_clipStack.back());
+        m_stats.stateChanges++;
+    }
 }
 
-void Renderer::drawRoundedRect(float x, float y, float width, float height, float radius, float r, float g, float b, float a) {
-    if (m_shaderProgram == 0) {
+Renderer::ClipResult Renderer::classifyBounds(float x0, float y0, float x1, float y1) const {
+    const ClipRect& clip = m_clipStack.back();
+    int left = pixelEdge(x0);
+    int top = pixelEdge(y0);
+    int right = pixelEdge(x1);
+    int bottom = pixelEdge(y1);
+    
+    if (right <= clip.x || left >= clip.x + clip.width || bottom <= clip.y || top >= clip.y + clip.height ||
+        left >= right || top >= bottom) {
+        return CLIP_OUTSIDE;
+    }
+    if (left >= clip.x && right <= clip.x + clip.width && top >= clip.y && bottom <= clip.y + clip.height) {
+        return CLIP_INSIDE;
+    }
+    return CLIP_PARTIAL;
+}
+
+bool Renderer::clipQuad(BatchVertex* quad) {
+    ClipResult result = classifyBounds(quad[0].x, quad[0].y, quad[2].x, quad[2].y);
+    if (result != CLIP_PARTIAL) {
+        return result == CLIP_INSIDE;
+    }
+    
+    // Cut the edges back to the clip's pixel edges; texcoords are linear
+    // across the quad (also the shape offsets), so they follow the cut
+    const ClipRect& clip = m_clipStack.back();
+    float left = quad[0].x;
+    float top = quad[0].y;
+    float right = quad[2].x;
+    float bottom = quad[2].y;
+    float newLeft = pixelEdge(left) < clip.x ? (float)clip.x : left;
+    float newTop = pixelEdge(top) < clip.y ? (float)clip.y : top;
+    float newRight = pixelEdge(right) > clip.x + clip.width ? (float)(clip.x + clip.width) : right;
+    float newBottom = pixelEdge(bottom) > clip.y + clip.height ? (float)(clip.y + clip.height) : bottom;
+    
+    float du = (quad[2].u - quad[0].u) / (right - left);
+    float dv = (quad[2].v - quad[0].v) / (bottom - top);
+    float u0 = quad[0].u + (newLeft - left) * du;
+    float u1 = quad[0].u + (newRight - left) * du;
+    float v0 = quad[0].v + (newTop - top) * dv;
+    float v1 = quad[0].v + (newBottom - top) * dv;
+    
+    quad[0].x = newLeft;  quad[0].y = newTop;    quad[0].u = u0; quad[0].v = v0;
+    quad[1].x = newRight; quad[1].y = newTop;    quad[1].u = u1; quad[1].v = v0;
+    quad[2].x = newRight; quad[2].y = newBottom; quad[2].u = u1; quad[2].v = v1;
+    quad[3].x = newLeft;  quad[3].y = newBottom; quad[3].u = u0; quad[3].v = v1;
+    m_stats.trimmedQuads++;
+    return true;
+}
+
+void Renderer::beginRecording(GeometryCache* cache) {
+    if (m_trace && cache) {
+        bool defined;
+        uint32_t id = m_trace->getCacheId(cache, defined);
+        m_trace->setCacheDefined(cache);
+        m_trace->writeOp(TRACE_BEGIN_RECORDING);
+        m_trace->writeU32(id);
+    }
+    m_recording = cache;
+}
+
+void Renderer::endRecording() {
+    if (m_trace && m_recording) {
+        m_trace->writeOp(TRACE_END_RECORDING);
+    }
+    if (m_recording) {
+        m_recording->updateBounds();
+    }
+    m_recording = nullptr;
+}
+
+void Renderer::drawGeometry(const GeometryCache& cache) {
+    if (!m_backend) {
         return;
     }
     
-    // For simplicity, draw as regular rectangle for now
-    // Full rounded rectangle would require more complex geometry
-    drawRect(x, y, width, height, r, g, b, a);
+    if (m_trace) {
+        bool defined;
+        uint32_t id = m_trace->getCacheId(&cache, defined);
+        if (!defined) {
+            // Recorded before the trace started: snapshot its vertices once
+            m_trace->writeOp(TRACE_DEFINE_GEOMETRY);
+            m_trace->writeU32(id);
+            m_trace->writeU32((uint32_t)cache.runs.size());
+            for (size_t i = 0; i < cache.runs.size(); ++i) {
+                m_trace->writeU32(cache.runs[i].texture);
+                m_trace->writeI32(cache.runs[i].vertexCount);
+            }
+            m_trace->writeU32((uint32_t)cache.vertices.size());
+            m_trace->writeBytes(cache.vertices.data(), cache.vertices.size() * sizeof(BatchVertex));
+            m_trace->setCacheDefined(&cache);
+        }
+        m_trace->writeOp(TRACE_DRAW_GEOMETRY);
+        m_trace->writeU32(id);
+    }
+    
+    ClipResult clip = CLIP_INSIDE;
+    if (!m_clipStack.empty() && !cache.empty()) {
+        clip = classifyBounds(cache.bounds[0], cache.bounds[1], cache.bounds[2], cache.bounds[3]);
+    }
+    if (clip == CLIP_OUTSIDE) {
+        m_stats.culledDraws++;
+        m_stats.culledVertices += (int)cache.vertices.size();
+        return;
+    }
+    
+    const BatchVertex* src = cache.vertices.data();
+    if (clip == CLIP_PARTIAL) {
+        for (size_t i = 0; i < cache.runs.size(); ++i) {
+            int quadCount = cache.runs[i].vertexCount / 4;
+            appendClippedQuads(src, quadCount, cache.runs[i].texture, nullptr);
+            src += cache.runs[i].vertexCount;
+        }
+        return;
+    }
+    
+    for (size_t i = 0; i < cache.runs.size(); ++i) {
+        useBatchTexture(cache.runs[i].texture);
+        
+        size_t remaining = (size_t)cache.runs[i].vertexCount;
+        while (remaining > 0) {
+            size_t space = (size_t)MAX_BATCH_QUADS * 4 - m_batch.size();
+            if (space == 0) {
+                submitBatch();
+                continue;
+            }
+            size_t count = remaining < space ? remaining : space;
+            m_batch.insert(m_batch.end(), src, src + count);
+            m_stats.quads += (int)(count / 4);
+            src += count;
+            remaining -= count;
+        }
+    }
+}
+
+TextureHandle Renderer::createAlphaTexture(const uint8_t* pixels, int width, int height) {
+    return addTexture(pixels, width, height, false);
+}
+
+TextureHandle Renderer::createDistanceFieldTexture(const uint8_t* pixels, int width, int height) {
+    return addTexture(pixels, width, height, true);
+}
+
+TextureHandle Renderer::addTexture(const uint8_t* pixels, int width, int height, bool distanceField) {
+    if (!m_backend || !pixels || width <= 0 || height <= 0) {
+        return 0;
+    }
+    
+    TextureHandle texture = distanceField ? m_backend->createDistanceFieldTexture(pixels, width, height)
+                                          : m_backend->createAlphaTexture(pixels, width, height);
+    if (texture == 0) {
+        return 0;
+    }
+    
+    // Kept so a trace can recreate the texture; atlases are at most a few
+    // hundred KB
+    TextureCopy copy;
+    copy.handle = texture;
+    copy.width = width;
+    copy.height = height;
+    copy.distanceField = distanceField;
+    copy.pixels.assign(pixels, pixels + (size_t)width * height);
+    m_textureCopies.push_back(copy);
+    if (m_trace) {
+        traceTexture(m_textureCopies.back());
+    }
+    return texture;
 }
 
-bool Renderer::initializeEGL() {
-    m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
-    if (m_display == EGL_NO_DISPLAY) {
-        LOGE("eglGetDisplay failed");
-        return false;
+void Renderer::destroyTexture(TextureHandle texture) {
+    if (texture == 0 || !m_backend) {
+        return;
     }
     
-    if (eglInitialize(m_display, nullptr, nullptr) == EGL_FALSE) {
-        LOGE("eglInitialize failed");
-        return false;
+    if (texture == m_batchTexture) {
+        submitBatch();
+        m_batchTexture = 0;
+    }
+    if (texture == m_submittedTexture) {
+        m_submittedTexture = 0;
     }
     
-    const EGLint attribs[] = {
-        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
-        EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
-        EGL_BLUE_SIZE, 8,
-        EGL_GREEN_SIZE, 8,
-        EGL_RED_SIZE, 8,
-        EGL_ALPHA_SIZE, 8,
-        EGL_NONE
-    };
+    for (size_t i = 0; i < m_textureCopies.size(); ++i) {
+        if (m_textureCopies[i].handle == texture) {
+            m_textureCopies.erase(m_textureCopies.begin() + i);
+            break;
+        }
+    }
+    if (m_trace) {
+        m_trace->writeOp(TRACE_DESTROY_TEXTURE);
+        m_trace->writeU32(texture);
+    }
     
-    EGLint numConfigs;
-    if (eglChooseConfig(m_display, attribs, &m_config, 1, &numConfigs) == EGL_FALSE) {
-        LOGE("eglChooseConfig failed");
-        cleanupEGL();
-        return false;
+    m_backend->destroyTexture(texture);
+}
+
+void Renderer::pushShape(float x, float y, float width, float height, float radius, float strokeWidth,
+                         float r, float g, float b, float a) {
+    if (!m_backend) {
+        return;
     }
     
-    const EGLint contextAttribs[] = {
-        EGL_CONTEXT_CLIENT_VERSION, 2,
-        EGL_NONE
+    if (width <= 0.0f || height <= 0.0f) {
+        return;
+    }
+    
+    float halfWidth = width * 0.5f;
+    float halfHeight = height * 0.5f;
+    float maxRadius = halfWidth < halfHeight ? halfWidth : halfHeight;
+    const float shape[4] = {
+        halfWidth,
+        halfHeight,
+        radius < 0.0f ? 0.0f : (radius > maxRadius ? maxRadius : radius),
+        strokeWidth < 0.0f ? 0.0f : strokeWidth
     };
     
-    m_context = eglCreateContext(m_display, m_config, EGL_NO_CONTEXT, contextAttribs);
-    if (m_context == EGL_NO_CONTEXT) {
-        LOGE("eglCreateContext failed");
-        cleanupEGL();
-        return false;
-    }
+    const uint8_t color[4] = {
+        packColorComponent(r),
+        packColorComponent(g),
+        packColorComponent(b),
+        packColorComponent(a)
+    };
     
-    const EGLint surfaceAttribs[] = {
-        EGL_NONE
+    // Grow the quad by one pixel so the antialiased edge is not cut off;
+    // the texcoord carries the offset from the shape's center
+    const float pad = 1.0f;
+    pushQuad(x - pad, y - pad, x + width + pad, y + height + pad,
+             -halfWidth - pad, -halfHeight - pad, halfWidth + pad, halfHeight + pad,
+             0, color, shape);
+}
+
+void Renderer::buildRectQuad(BatchVertex* quad, float x, float y, float width, float height,
+                             float r, float g, float b, float a) {
+    const uint8_t color[4] = {
+        packColorComponent(r),
+        packColorComponent(g),
+        packColorComponent(b),
+        packColorComponent(a)
     };
+    for (int i = 0; i < 4; ++i) {
+        quad[i].color[0] = color[0];
+        quad[i].color[1] = color[1];
+        quad[i].color[2] = color[2];
+        quad[i].color[3] = color[3];
+        quad[i].u = -1.0f;
+        quad[i].v = -1.0f;
+        quad[i].shape[0] = quad[i].shape[1] = quad[i].shape[2] = quad[i].shape[3] = 0.0f;
+    }
+    quad[0].x = x;         quad[0].y = y;
+    quad[1].x = x + width; quad[1].y = y;
+    quad[2].x = x + width; quad[2].y = y + height;
+    quad[3].x = x;         quad[3].y = y + height;
+}
+
+void Renderer::pushQuad(float x0, float y0, float x1, float y1,
+                        float u0, float v0, float u1, float v1, TextureHandle texture,
+                        const uint8_t* color, const float* shape) {
+    if (!m_recording && !m_clipStack.empty() && classifyBounds(x0, y0, x1, y1) == CLIP_OUTSIDE) {
+        m_stats.culledDraws++;
+        m_stats.culledVertices += 4;
+        return;
+    }
     
-    m_surface = eglCreateWindowSurface(m_display, m_config, m_window, surfaceAttribs);
-    if (m_surface == EGL_NO_SURFACE) {
-        LOGE("eglCreateWindowSurface failed");
-        cleanupEGL();
-        return false;
+    BatchVertex quad[4];
+    for (int i = 0; i < 4; ++i) {
+        quad[i].color[0] = color[0];
+        quad[i].color[1] = color[1];
+        quad[i].color[2] = color[2];
+        quad[i].color[3] = color[3];
+        for (int j = 0; j < 4; ++j) {
+            quad[i].shape[j] = shape ? shape[j] : 0.0f;
+        }
     }
+    quad[0].x = x0; quad[0].y = y0; quad[0].u = u0; quad[0].v = v0;
+    quad[1].x = x1; quad[1].y = y0; quad[1].u = u1; quad[1].v = v0;
+    quad[2].x = x1; quad[2].y = y1; quad[2].u = u1; quad[2].v = v1;
+    quad[3].x = x0; quad[3].y = y1; quad[3].u = u0; quad[3].v = v1;
     
-    if (eglMakeCurrent(m_display, m_surface, m_surface, m_context) == EGL_FALSE) {
-        LOGE("eglMakeCurrent failed");
-        cleanupEGL();
-        return false;
+    appendQuads(quad, 1, texture, nullptr);
+}
+
+// Moves copied vertices by the placement's offset and replaces their color
+static void placeVertices(BatchVertex* vertices, size_t count, const QuadPlacement& placement) {
+    for (size_t i = 0; i < count; ++i) {
+        vertices[i].x += placement.x;
+        vertices[i].y += placement.y;
+        vertices[i].color[0] = placement.color[0];
+        vertices[i].color[1] = placement.color[1];
+        vertices[i].color[2] = placement.color[2];
+        vertices[i].color[3] = placement.color[3];
+    }
+}
+
+void Renderer::appendQuads(const BatchVertex* quads, int quadCount, TextureHandle texture,
+                           const QuadPlacement* placement) {
+    size_t vertexCount = (size_t)quadCount * 4;
+    
+    if (m_recording) {
+        // Extend the current run unless it is bound to a different texture
+        std::vector<GeometryCache::Run>& runs = m_recording->runs;
+        if (runs.empty() || (texture != 0 && runs.back().texture != 0 && runs.back().texture != texture)) {
+            GeometryCache::Run run;
+            run.texture = texture;
+            run.vertexCount = 0;
+            runs.push_back(run);
+        } else if (texture != 0) {
+            runs.back().texture = texture;
+        }
+        m_recording->vertices.insert(m_recording->vertices.end(), quads, quads + vertexCount);
+        if (placement) {
+            placeVertices(&m_recording->vertices.back() + 1 - vertexCount, vertexCount, *placement);
+        }
+        runs.back().vertexCount += (int)vertexCount;
+        return;
     }
     
-    return true;
+    if (!m_clipStack.empty()) {
+        // Extent of the quads where they will land
+        float bounds[4] = { quads[0].x, quads[0].y, quads[2].x, quads[2].y };
+        for (int i = 1; i < quadCount; ++i) {
+            const BatchVertex* quad = quads + i * 4;
+            if (quad[0].x < bounds[0]) bounds[0] = quad[0].x;
+            if (quad[0].y < bounds[1]) bounds[1] = quad[0].y;
+            if (quad[2].x > bounds[2]) bounds[2] = quad[2].x;
+            if (quad[2].y > bounds[3]) bounds[3] = quad[2].y;
+        }
+        float offsetX = placement ? placement->x : 0.0f;
+        float offsetY = placement ? placement->y : 0.0f;
+        ClipResult clip = classifyBounds(bounds[0] + offsetX, bounds[1] + offsetY,
+                                         bounds[2] + offsetX, bounds[3] + offsetY);
+        if (clip == CLIP_OUTSIDE) {
+            m_stats.culledDraws++;
+            m_stats.culledVertices += (int)vertexCount;
+            return;
+        }
+        if (clip == CLIP_PARTIAL) {
+            appendClippedQuads(quads, quadCount, texture, placement);
+            return;
+        }
+    }
+    
+    useBatchTexture(texture);
+    while (vertexCount > 0) {
+        size_t space = (size_t)MAX_BATCH_QUADS * 4 - m_batch.size();
+        if (space == 0) {
+            submitBatch();
+            continue;
+        }
+        size_t count = vertexCount < space ? vertexCount : space;
+        m_batch.insert(m_batch.end(), quads, quads + count);
+        if (placement) {
+            placeVertices(&m_batch.back() + 1 - count, count, *placement);
+        }
+        m_stats.quads += (int)(count / 4);
+        quads += count;
+        vertexCount -= count;
+    }
 }
 
-void Renderer::cleanupEGL() {
-    if (m_display != EGL_NO_DISPLAY) {
-        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
-        
-        if (m_context != EGL_NO_CONTEXT) {
-            eglDestroyContext(m_display, m_context);
-            m_context = EGL_NO_CONTEXT;
+void Renderer::appendClippedQuads(const BatchVertex* quads, int quadCount, TextureHandle texture,
+                                  const QuadPlacement* placement) {
+    useBatchTexture(texture);
+    for (int i = 0; i < quadCount; ++i) {
+        BatchVertex quad[4] = { quads[i * 4], quads[i * 4 + 1], quads[i * 4 + 2], quads[i * 4 + 3] };
+        if (placement) {
+            placeVertices(quad, 4, *placement);
         }
-        
-        if (m_surface != EGL_NO_SURFACE) {
-            eglDestroySurface(m_display, m_surface);
-            m_surface = EGL_NO_SURFACE;
+        if (!clipQuad(quad)) {
+            m_stats.culledVertices += 4;
+            continue;
         }
         
-        eglTerminate(m_display);
-        m_display = EGL_NO_DISPLAY;
+        if (m_batch.size() + 4 > (size_t)MAX_BATCH_QUADS * 4) {
+            submitBatch();
+        }
+        m_batch.insert(m_batch.end(), quad, quad + 4);
+        m_stats.quads++;
     }
 }
 
-bool Renderer::createShaderProgram() {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
+void Renderer::drawQuads(const BatchVertex* quads, int quadCount, TextureHandle texture) {
+    if (m_trace) {
+        m_trace->writeOp(TRACE_QUADS);
+        m_trace->writeU32(texture);
+        m_trace->writeU32((uint32_t)quadCount);
+        m_trace->writeBytes(quads, (size_t)quadCount * 4 * sizeof(BatchVertex));
+    }
     
-    GLint compiled;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &compiled);
-    if (!compiled) {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        LOGE("Vertex shader compilation failed: %s", infoLog);
-        glDeleteShader(vertexShader);
-        return false;
+    if (!m_backend || quadCount <= 0) {
+        return;
+    }
+    
+    appendQuads(quads, quadCount, texture, nullptr);
+}
+
+void Renderer::drawQuadRun(const BatchVertex* quads, int quadCount, TextureHandle texture,
+                           float x, float y, float r, float g, float b, float a) {
+    if (m_trace) {
+        const float values[6] = { x, y, r, g, b, a };
+        m_trace->writeOp(TRACE_QUAD_RUN);
+        m_trace->writeU32(texture);
+        m_trace->writeFloats(values, 6);
+        m_trace->writeU32((uint32_t)quadCount);
+        m_trace->writeBytes(quads, (size_t)quadCount * 4 * sizeof(BatchVertex));
     }
     
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
+    if (!m_backend || quadCount <= 0) {
+        return;
+    }
     
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &compiled);
-    if (!compiled) {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        LOGE("Fragment shader compilation failed: %s", infoLog);
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return false;
+    QuadPlacement placement;
+    placement.x = x;
+    placement.y = y;
+    placement.color[0] = packColorComponent(r);
+    placement.color[1] = packColorComponent(g);
+    placement.color[2] = packColorComponent(b);
+    placement.color[3] = packColorComponent(a);
+    appendQuads(quads, quadCount, texture, &placement);
+}
+
+void Renderer::flush() {
+    // Explicit flushes split batches, so they are part of the draw stream
+    if (m_trace) {
+        m_trace->writeOp(TRACE_FLUSH);
+    }
+    submitBatch();
+}
+
+void Renderer::submitBatch() {
+    if (m_batch.empty()) {
+        return;
     }
     
-    m_shaderProgram = glCreateProgram();
-    glAttachShader(m_shaderProgram, vertexShader);
-    glAttachShader(m_shaderProgram, fragmentShader);
-    glLinkProgram(m_shaderProgram);
-    
-    GLint linked;
-    glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, &linked);
-    if (!linked) {
-        GLchar infoLog[512];
-        glGetProgramInfoLog(m_shaderProgram, 512, nullptr, infoLog);
-        LOGE("Shader program linking failed: %s", infoLog);
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        glDeleteProgram(m_shaderProgram);
-        m_shaderProgram = 0;
-        return false;
+    if (!m_backend) {
+        m_batch.clear();
+        return;
     }
     
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // Mirrors what a GPU backend has to rebind: pipeline state once per
+    // frame, then the texture whenever it changes
+    if (!m_stateSubmitted) {
+        m_stateSubmitted = true;
+        m_stats.stateChanges++;
+    }
+    if (m_batchTexture != 0 && m_batchTexture != m_submittedTexture) {
+        m_submittedTexture = m_batchTexture;
+        m_stats.stateChanges++;
+    }
     
-    m_positionHandle = glGetAttribLocation(m_shaderProgram, "a_position");
-    m_colorHandle = glGetAttribLocation(m_shaderProgram, "a_color");
-    m_matrixHandle = glGetUniformLocation(m_shaderProgram, "u_matrix");
+    int quadCount = (int)(m_batch.size() / 4);
+    m_backend->drawQuads(m_batch.data(), quadCount, m_batchTexture);
     
-    return true;
+    m_stats.drawCalls++;
+    m_stats.vertices += (int)m_batch.size();
+    m_batch.clear();
 }
 
-void Renderer::setupOrthographicMatrix(float* matrix, float left, float right, float bottom, float top) {
-    float near = -1.0f;
-    float far = 1.0f;
+void Renderer::drawText(float x, float y, const char* text, float r, float g, float b, float a) {
+    // Legacy method - kept for compatibility
+    // Text rendering is now handled by TextRenderer class
+    drawRect(x, y, 100.0f, 20.0f, r, g, b, a * 0.5f);
+}
+
+void Renderer::drawRoundedRect(float x, float y, float width, float height, float radius, float r, float g, float b, float a) {
+    if (m_trace) {
+        const float values[9] = { x, y, width, height, radius, r, g, b, a };
+        traceCall(TRACE_ROUNDED_RECT, values, 9);
+    }
     
-    matrix[0] = 2.0f / (right - left);
-    matrix[1] = 0.0f;
-    matrix[2] = 0.0f;
-    matrix[3] = 0.0f;
+    if (radius <= 0.0f) {
+        fillRect(x, y, width, height, r, g, b, a);
+        return;
+    }
     
-    matrix[4] = 0.0f;
-    matrix[5] = 2.0f / (top - bottom);
-    matrix[6] = 0.0f;
-    matrix[7] = 0.0f;
+    pushShape(x, y, width, height, radius, 0.0f, r, g, b, a);
+}
+
+void Renderer::strokeRoundedRect(float x, float y, float width, float height, float radius, float strokeWidth,
+                                 float r, float g, float b, float a) {
+    if (m_trace) {
+        const float values[10] = { x, y, width, height, radius, strokeWidth, r, g, b, a };
+        traceCall(TRACE_STROKE_ROUNDED_RECT, values, 10);
+    }
     
-    matrix[8] = 0.0f;
-    matrix[9] = 0.0f;
-    matrix[10] = -2.0f / (far - near);
-    matrix[11] = 0.0f;
+    if (strokeWidth <= 0.0f) {
+        return;
+    }
     
-    matrix[12] = -(right + left) / (right - left);
-    matrix[13] = -(top + bottom) / (top - bottom);
-    matrix[14] = -(far + near) / (far - near);
-    matrix[15] = 1.0f;
+    pushShape(x, y, width, height, radius, strokeWidth, r, g, b, a);
 }
 
+void Renderer::drawCircle(float centerX, float centerY, float radius, float r, float g, float b, float a) {
+    if (m_trace) {
+        const float values[7] = { centerX, centerY, radius, r, g, b, a };
+        traceCall(TRACE_CIRCLE, values, 7);
+    }
+    pushShape(centerX - radius, centerY - radius, radius * 2.0f, radius * 2.0f, radius, 0.0f, r, g, b, a);
+}
+
+void Renderer::drawRing(float centerX, float centerY, float radius, float thickness, float r, float g, float b, float a) {
+    if (m_trace) {
+        const float values[8] = { centerX, centerY, radius, thickness, r, g, b, a };
+        traceCall(TRACE_RING, values, 8);
+    }
+    if (thickness <= 0.0f) {
+        return;
+    }
+    
+    pushShape(centerX - radius, centerY - radius, radius * 2.0f, radius * 2.0f, radius, thickness, r, g, b, a);
+}
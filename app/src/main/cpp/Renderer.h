@@ -1,16 +1,68 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
-#include <EGL/egl.h>
-#include <GLES2/gl2.h>
-#include <android/native_window.h>
+#include "RenderBackend.h"
+#include "DrawTrace.h"
+#include "FrameArena.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
 
+// Per-frame counters for the batched draw path
+struct RenderStats {
+    int drawCalls;
+    int quads;
+    int vertices;
+    int stateChanges;
+    // Clipping: draw calls and cached geometries dropped whole, vertices never
+    // queued because they were clipped away, quads cut down to the clip
+    int culledDraws;
+    int culledVertices;
+    int trimmedQuads;
+    
+    RenderStats()
+        : drawCalls(0), quads(0), vertices(0), stateChanges(0)
+        , culledDraws(0), culledVertices(0), trimmedQuads(0) {}
+};
+
+// Offset and color applied to quads as they are copied into the batch
+struct QuadPlacement {
+    float x, y;
+    uint8_t color[4];
+};
+
+// Quads captured between Renderer::beginRecording/endRecording. Replaying a
+// cache with drawGeometry appends its vertices to the batch without
+// regenerating them.
+struct GeometryCache {
+    struct Run {
+        TextureHandle texture; // 0 while the run holds only untextured quads
+        int vertexCount;
+    };
+    
+    std::vector<BatchVertex> vertices;
+    std::vector<Run> runs;
+    // minX, minY, maxX, maxY of all vertices, for culling the whole cache;
+    // Renderer::endRecording keeps it up to date
+    float bounds[4];
+    
+    GeometryCache() : bounds() {}
+    
+    void clear() { vertices.clear(); runs.clear(); }
+    bool empty() const { return vertices.empty(); }
+    void updateBounds();
+};
+
+// Batching front-end. Everything device-specific (EGL/GL on Android, the
+// software rasterizer on the host) lives behind RenderBackend.
 class Renderer {
 public:
     Renderer();
     ~Renderer();
     
-    bool initialize(ANativeWindow* window, int width, int height);
+    // Takes ownership of the backend, also when initialization fails
+    bool initialize(RenderBackend* backend, int width, int height);
     void cleanup();
     void onWindowResized(int width, int height);
     
@@ -19,31 +71,134 @@ public:
     
     void clear(float r, float g, float b, float a);
     void drawRect(float x, float y, float width, float height, float r, float g, float b, float a);
+    // Shapes are a single antialiased quad each, batched together with plain rects
     void drawRoundedRect(float x, float y, float width, float height, float radius, float r, float g, float b, float a);
+    void strokeRoundedRect(float x, float y, float width, float height, float radius, float strokeWidth,
+                           float r, float g, float b, float a);
+    void drawCircle(float centerX, float centerY, float radius, float r, float g, float b, float a);
+    void drawRing(float centerX, float centerY, float radius, float thickness, float r, float g, float b, float a);
     void drawText(float x, float y, const char* text, float r, float g, float b, float a);
     
+    // Textures live until destroyTexture or until the renderer is cleaned up.
+    // Textured quads modulate the color by the texture's alpha channel (nearest filtering)
+    TextureHandle createAlphaTexture(const uint8_t* pixels, int width, int height);
+    // Distance-field textures are filtered linearly; quads sampling them carry
+    // the ramp width in shape[2] (see RenderBackend.h)
+    TextureHandle createDistanceFieldTexture(const uint8_t* pixels, int width, int height);
+    void destroyTexture(TextureHandle texture);
+    void drawTexturedRect(float x, float y, float width, float height,
+                          float u0, float v0, float u1, float v1, TextureHandle texture,
+                          float r, float g, float b, float a);
+    
+    // Appends prebuilt quads (four BatchVertex each, see RenderBackend.h) as they
+    // are; for geometry that is transformed on the CPU, e.g. icon instances
+    void drawQuads(const BatchVertex* quads, int quadCount, TextureHandle texture = 0);
+    // Same for a run laid out at the origin (e.g. a cached text run): every
+    // vertex is moved by (x, y) and takes the given color
+    void drawQuadRun(const BatchVertex* quads, int quadCount, TextureHandle texture,
+                     float x, float y, float r, float g, float b, float a);
+    // Writes the four vertices drawRect would queue for this rect, for callers
+    // that collect many rects and submit them with one drawQuads
+    static void buildRectQuad(BatchVertex* quad, float x, float y, float width, float height,
+                              float r, float g, float b, float a);
+    
+    // Clip stack: draws only reach the intersection of the pushed rects, cut
+    // to whole pixels. Draws entirely outside are dropped before their vertices
+    // are built or copied, partly clipped quads are trimmed, and the backend
+    // clips as well (scissor, span limits). Recording ignores the clip: caches
+    // hold unclipped geometry and are clipped when drawn.
+    void pushClipRect(float x, float y, float width, float height);
+    void popClipRect();
+    
+    // While recording, draw calls are captured into the cache instead of the batch
+    void beginRecording(GeometryCache* cache);
+    void endRecording();
+    void drawGeometry(const GeometryCache& cache);
+    
+    // Submits all queued quads; called automatically at endFrame and before state changes
+    void flush();
+    
+    // Draw-command trace (DrawTrace.h) of every call from here on; the file is
+    // written on a background thread. Start and stop between frames.
+    bool startTrace(const std::string& path);
+    void stopTrace();
+    bool isTracing() const { return m_trace != nullptr; }
+    
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
     
+    RenderBackend* getBackend() const { return m_backend; }
+    
+    // Scratch memory for the frame in progress, reset by beginFrame. The arena
+    // is owned by the caller (App); without one the renderer uses its own.
+    void setFrameArena(FrameArena* arena) { m_frameArena = arena ? arena : &m_ownArena; }
+    FrameArena& getFrameArena() const { return *m_frameArena; }
+    
+    // Unique per backend device; textures created under another id are no longer valid
+    unsigned int getContextId() const { return m_contextId; }
+    
+    // Counters of the frame in progress and of the last completed frame
+    const RenderStats& getCurrentStats() const { return m_stats; }
+    const RenderStats& getFrameStats() const { return m_lastFrameStats; }
+    
 private:
-    ANativeWindow* m_window;
-    EGLDisplay m_display;
-    EGLSurface m_surface;
-    EGLContext m_context;
-    EGLConfig m_config;
+    static const int MAX_BATCH_QUADS = 4096;
+    static const int MAX_CLIP_DEPTH = 16;
+    
+    enum ClipResult {
+        CLIP_INSIDE,
+        CLIP_PARTIAL,
+        CLIP_OUTSIDE
+    };
     
+    RenderBackend* m_backend;
     int m_width;
     int m_height;
     
-    GLuint m_shaderProgram;
-    GLuint m_positionHandle;
-    GLuint m_colorHandle;
-    GLuint m_matrixHandle;
+    std::vector<BatchVertex> m_batch;
+    TextureHandle m_batchTexture;
+    // What the backend last drew with, for the state change counter
+    bool m_stateSubmitted;
+    TextureHandle m_submittedTexture;
+    unsigned int m_contextId;
+    GeometryCache* m_recording;
+    std::vector<ClipRect> m_clipStack;
+    FrameArena m_ownArena;
+    FrameArena* m_frameArena;
+    
+    RenderStats m_stats;
+    RenderStats m_lastFrameStats;
+    
+    // CPU copies of live textures, so a trace started later can recreate them
+    struct TextureCopy {
+        TextureHandle handle;
+        int width;
+        int height;
+        bool distanceField;
+        std::vector<uint8_t> pixels;
+    };
+    std::vector<TextureCopy> m_textureCopies;
+    DrawTraceWriter* m_trace;
+    std::chrono::steady_clock::time_point m_frameStart;
     
-    bool initializeEGL();
-    void cleanupEGL();
-    bool createShaderProgram();
-    void setupOrthographicMatrix(float* matrix, float left, float right, float bottom, float top);
+    void traceCall(DrawTraceOp op, const float* values, int count);
+    void traceTexture(const TextureCopy& texture);
+    TextureHandle addTexture(const uint8_t* pixels, int width, int height, bool distanceField);
+    void fillRect(float x, float y, float width, float height, float r, float g, float b, float a);
+    void submitBatch();
+    void pushQuad(float x0, float y0, float x1, float y1,
+                  float u0, float v0, float u1, float v1, TextureHandle texture,
+                  const uint8_t* color, const float* shape);
+    void pushShape(float x, float y, float width, float height, float radius, float strokeWidth,
+                   float r, float g, float b, float a);
+    void appendQuads(const BatchVertex* quads, int quadCount, TextureHandle texture,
+                     const QuadPlacement* placement);
+    void useBatchTexture(TextureHandle texture);
+    void applyClip();
+    ClipResult classifyBounds(float x0, float y0, float x1, float y1) const;
+    bool clipQuad(BatchVertex* quad);
+    void appendClippedQuads(const BatchVertex* quads, int quadCount, TextureHandle texture,
+                            const QuadPlacement* placement);
 };
 
 #endif // RENDERER_H
@@ -0,0 +1,159 @@
+#include "Scene.h"
+
+SceneNode::SceneNode(Scene* scene, const BuildFunc& build)
+    : m_scene(scene)
+    , m_build(build)
+    , m_dirty(true)
+    , m_visible(true)
+    , m_clipped(false)
+    , m_clip()
+{
+}
+
+SceneNode::~SceneNode() {
+    clearChildren();
+}
+
+SceneNode* SceneNode::addChild(const BuildFunc& build) {
+    SceneNode* child = new SceneNode(m_scene, build);
+    m_children.push_back(child);
+    if (m_scene) {
+        m_scene->requestRedraw();
+    }
+    return child;
+}
+
+void SceneNode::clearChildren() {
+    if (m_children.empty()) {
+        return;
+    }
+    
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        delete m_children[i];
+    }
+    m_children.clear();
+    if (m_scene) {
+        m_scene->requestRedraw();
+    }
+}
+
+void SceneNode::invalidate() {
+    m_dirty = true;
+    if (m_scene) {
+        m_scene->requestRedraw();
+    }
+}
+
+void SceneNode::setVisible(bool visible) {
+    if (m_visible == visible) {
+        return;
+    }
+    
+    m_visible = visible;
+    if (m_scene) {
+        m_scene->requestRedraw();
+    }
+}
+
+void SceneNode::reserveQuads(int quadCount) {
+    m_geometry.vertices.reserve((size_t)quadCount * 4);
+}
+
+void SceneNode::setClipRect(float x, float y, float width, float height) {
+    if (m_clipped && m_clip[0] == x && m_clip[1] == y && m_clip[2] == width && m_clip[3] == height) {
+        return;
+    }
+    
+    m_clipped = true;
+    m_clip[0] = x;
+    m_clip[1] = y;
+    m_clip[2] = width;
+    m_clip[3] = height;
+    if (m_scene) {
+        m_scene->requestRedraw();
+    }
+}
+
+void SceneNode::clearClipRect() {
+    if (!m_clipped) {
+        return;
+    }
+    
+    m_clipped = false;
+    if (m_scene) {
+        m_scene->requestRedraw();
+    }
+}
+
+void SceneNode::render(Renderer* renderer, SceneStats& stats) {
+    // Hidden nodes keep their dirty flag and rebuild once shown again
+    if (!m_visible) {
+        return;
+    }
+    
+    if (m_dirty) {
+        m_geometry.clear();
+        if (m_build) {
+            renderer->beginRecording(&m_geometry);
+            m_build(renderer);
+            renderer->endRecording();
+        }
+        m_dirty = false;
+        stats.nodesRebuilt++;
+    }
+    
+    if (m_clipped) {
+        renderer->pushClipRect(m_clip[0], m_clip[1], m_clip[2], m_clip[3]);
+    }
+    
+    renderer->drawGeometry(m_geometry);
+    stats.nodesDrawn++;
+    
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        m_children[i]->render(renderer, stats);
+    }
+    
+    if (m_clipped) {
+        renderer->popClipRect();
+    }
+}
+
+void SceneNode::invalidateTree() {
+    m_dirty = true;
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        m_children[i]->invalidateTree();
+    }
+}
+
+Scene::Scene()
+    : m_root(nullptr)
+    , m_needsRedraw(true)
+    , m_contextId(0)
+{
+    m_root = new SceneNode(this, SceneNode::BuildFunc());
+}
+
+Scene::~Scene() {
+    delete m_root;
+}
+
+void Scene::invalidateAll() {
+    m_root->invalidateTree();
+    m_needsRedraw = true;
+}
+
+void Scene::render(Renderer* renderer) {
+    if (!renderer) {
+        return;
+    }
+    
+    // Cached geometry references textures of the context it was built with
+    if (renderer->getContextId() != m_contextId) {
+        m_contextId = renderer->getContextId();
+        m_root->invalidateTree();
+    }
+    
+    m_stats = SceneStats();
+    m_root->render(renderer, m_stats);
+    m_needsRedraw = false;
+}
@@ -0,0 +1,89 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "Renderer.h"
+#include <functional>
+#include <vector>
+
+class Scene;
+
+// Per-frame counters of the retained scene
+struct SceneStats {
+    int nodesRebuilt;
+    int nodesDrawn;
+    
+    SceneStats() : nodesRebuilt(0), nodesDrawn(0) {}
+};
+
+// Retained UI element (screen, card, button, label). The node records the
+// geometry its build callback emits and replays it on later frames; the
+// callback runs again only after invalidate(). Children draw above the parent.
+class SceneNode {
+public:
+    typedef std::function<void(Renderer*)> BuildFunc;
+    
+    SceneNode(Scene* scene, const BuildFunc& build);
+    ~SceneNode();
+    
+    // The node owns its children
+    SceneNode* addChild(const BuildFunc& build);
+    void clearChildren();
+    
+    // Geometry must be regenerated before the next frame
+    void invalidate();
+    void setVisible(bool visible);
+    // Limits the node and its children to a rectangle; the cached geometry
+    // stays as built and is clipped when drawn
+    void setClipRect(float x, float y, float width, float height);
+    void clearClipRect();
+    // Room for this many quads up front, for nodes whose geometry keeps
+    // changing size (counters, live text)
+    void reserveQuads(int quadCount);
+    
+    bool isDirty() const { return m_dirty; }
+    bool isVisible() const { return m_visible; }
+    
+private:
+    friend class Scene;
+    
+    Scene* m_scene;
+    BuildFunc m_build;
+    GeometryCache m_geometry;
+    std::vector<SceneNode*> m_children;
+    bool m_dirty;
+    bool m_visible;
+    bool m_clipped;
+    float m_clip[4];
+    
+    void render(Renderer* renderer, SceneStats& stats);
+    void invalidateTree();
+};
+
+class Scene {
+public:
+    Scene();
+    ~Scene();
+    
+    SceneNode* getRoot() { return m_root; }
+    
+    // True when any node changed since the last render; a clean scene needs
+    // neither geometry generation nor a buffer swap
+    bool needsRedraw() const { return m_needsRedraw; }
+    void requestRedraw() { m_needsRedraw = true; }
+    
+    // Rebuilds every node, e.g. after a resize
+    void invalidateAll();
+    
+    // Rebuilds dirty visible nodes and replays all visible geometry
+    void render(Renderer* renderer);
+    
+    const SceneStats& getFrameStats() const { return m_stats; }
+    
+private:
+    SceneNode* m_root;
+    bool m_needsRedraw;
+    unsigned int m_contextId;
+    SceneStats m_stats;
+};
+
+#endif // SCENE_H
@@ -0,0 +1,154 @@
+#include "Scroller.h"
+#include <cmath>
+
+// Samples older than this before the newest one do not count toward the velocity
+static const float VELOCITY_WINDOW_MS = 100.0f;
+// Slower releases just stop; faster ones are capped
+static const float MIN_FLING_VELOCITY = 150.0f;
+static const float MAX_FLING_VELOCITY = 8000.0f;
+// Velocity decays as exp(-t / tau); the fling travels velocity * tau in total
+static const float FLING_TIME_CONSTANT = 0.325f;
+// The fling ends once it slows below this (pixels per second)
+static const float FLING_STOP_VELOCITY = 20.0f;
+
+VelocityTracker::VelocityTracker()
+    : m_next(0)
+    , m_count(0)
+{
+}
+
+void VelocityTracker::addSample(Clock::time_point time, float position) {
+    m_samples[m_next].time = time;
+    m_samples[m_next].position = position;
+    m_next = (m_next + 1) % MAX_SAMPLES;
+    if (m_count < MAX_SAMPLES) {
+        m_count++;
+    }
+}
+
+float VelocityTracker::getVelocity() const {
+    if (m_count < 2) {
+        return 0.0f;
+    }
+    
+    // Fit position = a + b * t over the window, t in seconds relative to the newest sample
+    const Sample& newest = m_samples[(m_next + MAX_SAMPLES - 1) % MAX_SAMPLES];
+    double sumT = 0.0, sumP = 0.0, sumTT = 0.0, sumTP = 0.0;
+    int n = 0;
+    for (int i = 0; i < m_count; ++i) {
+        const Sample& sample = m_samples[(m_next + MAX_SAMPLES - 1 - i) % MAX_SAMPLES];
+        double t = std::chrono::duration<double>(sample.time - newest.time).count();
+        if (t * 1000.0 < -VELOCITY_WINDOW_MS) {
+            break;
+        }
+        double p = sample.position - newest.position;
+        sumT += t;
+        sumP += p;
+        sumTT += t * t;
+        sumTP += t * p;
+        n++;
+    }
+    
+    double denominator = n * sumTT - sumT * sumT;
+    if (n < 2 || denominator <= 0.0) {
+        return 0.0f;
+    }
+    return (float)((n * sumTP - sumT * sumP) / denominator);
+}
+
+Scroller::Scroller()
+    : m_offset(0.0f)
+    , m_maxOffset(0.0f)
+    , m_dragging(false)
+    , m_dragStartPointer(0.0f)
+    , m_dragStartOffset(0.0f)
+    , m_flinging(false)
+    , m_flingStartOffset(0.0f)
+    , m_flingVelocity(0.0f)
+{
+}
+
+float Scroller::clampOffset(float offset) const {
+    if (offset > m_maxOffset) {
+        offset = m_maxOffset;
+    }
+    return offset > 0.0f ? offset : 0.0f;
+}
+
+void Scroller::setExtent(float contentSize, float viewportSize) {
+    m_maxOffset = contentSize > viewportSize ? contentSize - viewportSize : 0.0f;
+    float clamped = clampOffset(m_offset);
+    if (clamped != m_offset) {
+        m_offset = clamped;
+        m_flinging = false;
+    }
+}
+
+void Scroller::setOffset(float offset) {
+    m_offset = clampOffset(offset);
+    m_flinging = false;
+}
+
+void Scroller::beginDrag(float pointer, Clock::time_point now) {
+    m_flinging = false;
+    m_dragging = true;
+    m_dragStartPointer = pointer;
+    m_dragStartOffset = m_offset;
+    m_velocity.clear();
+    m_velocity.addSample(now, pointer);
+}
+
+bool Scroller::dragTo(float pointer, Clock::time_point now) {
+    if (!m_dragging) {
+        return false;
+    }
+    
+    m_velocity.addSample(now, pointer);
+    // Content follows the finger: moving up scrolls toward the end
+    float offset = clampOffset(m_dragStartOffset + m_dragStartPointer - pointer);
+    bool changed = offset != m_offset;
+    m_offset = offset;
+    return changed;
+}
+
+void Scroller::endDrag(Clock::time_point now) {
+    if (!m_dragging) {
+        return;
+    }
+    m_dragging = false;
+    
+    float velocity = -m_velocity.getVelocity();
+    if (std::fabs(velocity) < MIN_FLING_VELOCITY) {
+        return;
+    }
+    if (std::fabs(velocity) > MAX_FLING_VELOCITY) {
+        velocity = velocity > 0.0f ? MAX_FLING_VELOCITY : -MAX_FLING_VELOCITY;
+    }
+    m_flinging = true;
+    m_flingStart = now;
+    m_flingStartOffset = m_offset;
+    m_flingVelocity = velocity;
+}
+
+void Scroller::cancelDrag() {
+    m_dragging = false;
+}
+
+bool Scroller::update(Clock::time_point now) {
+    if (!m_flinging) {
+        return false;
+    }
+    
+    float t = std::chrono::duration<float>(now - m_flingStart).count();
+    float decay = std::exp(-t / FLING_TIME_CONSTANT);
+    float target = m_flingStartOffset + m_flingVelocity * FLING_TIME_CONSTANT * (1.0f - decay);
+    float offset = clampOffset(target);
+    
+    // Ends at either edge or once too slow to see
+    if (offset != target || std::fabs(m_flingVelocity * decay) < FLING_STOP_VELOCITY) {
+        m_flinging = false;
+    }
+    bool changed = offset != m_offset;
+    m_offset = offset;
+    return changed;
+}
@@ -0,0 +1,79 @@
+#ifndef SCROLLER_H
+#define SCROLLER_H
+
+#include <chrono>
+
+// Estimates pointer velocity from the most recent move samples with a least
+// squares fit, so one late or early event does not skew the fling.
+class VelocityTracker {
+public:
+    typedef std::chrono::steady_clock Clock;
+    
+    VelocityTracker();
+    
+    void clear() { m_count = 0; }
+    void addSample(Clock::time_point time, float position);
+    // Pixels per second over the samples of the last VELOCITY_WINDOW_MS before
+    // the newest one; 0 with fewer than two samples
+    float getVelocity() const;
+    
+private:
+    static const int MAX_SAMPLES = 16;
+    
+    struct Sample {
+        Clock::time_point time;
+        float position;
+    };
+    
+    Sample m_samples[MAX_SAMPLES];
+    int m_next;
+    int m_count;
+};
+
+// Scroll offset along one axis: dragging moves it with the pointer, releasing
+// a fast drag starts a fling that decelerates exponentially. The offset always
+// stays within [0, content - viewport].
+class Scroller {
+public:
+    typedef std::chrono::steady_clock Clock;
+    
+    Scroller();
+    
+    // Clamps the current offset; stops a fling that ran past the new end
+    void setExtent(float contentSize, float viewportSize);
+    float getOffset() const { return m_offset; }
+    void setOffset(float offset);
+    float getMaxOffset() const { return m_maxOffset; }
+    
+    // Stops any fling; the content then follows the pointer
+    void beginDrag(float pointer, Clock::time_point now);
+    // Returns true when the offset changed
+    bool dragTo(float pointer, Clock::time_point now);
+    // Flings with the release velocity if it is fast enough
+    void endDrag(Clock::time_point now);
+    void cancelDrag();
+    
+    // Advances a fling to now; returns true when the offset changed
+    bool update(Clock::time_point now);
+    
+    bool isDragging() const { return m_dragging; }
+    bool isFlinging() const { return m_flinging; }
+    
+private:
+    float m_offset;
+    float m_maxOffset;
+    
+    bool m_dragging;
+    float m_dragStartPointer;
+    float m_dragStartOffset;
+    VelocityTracker m_velocity;
+    
+    bool m_flinging;
+    Clock::time_point m_flingStart;
+    float m_flingStartOffset;
+    float m_flingVelocity;
+    
+    float clampOffset(float offset) const;
+};
+
+#endif // SCROLLER_H
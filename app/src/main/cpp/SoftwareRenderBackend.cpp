@@ -0,0 +1,431 @@
+#include "SoftwareRenderBackend.h"
+#include <android/log.h>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SOFTWARE_SPANS_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SOFTWARE_SPANS_NEON 1
+#endif
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "SoftwareRenderBackend", __VA_ARGS__))
+
+static inline uint32_t packPixel(const uint8_t* color, uint32_t alpha) {
+    return (uint32_t)color[0] | ((uint32_t)color[1] << 8) | ((uint32_t)color[2] << 16) | (alpha << 24);
+}
+
+static inline uint8_t toByte(float c) {
+    if (c <= 0.0f) return 0;
+    if (c >= 1.0f) return 255;
+    return (uint8_t)(c * 255.0f + 0.5f);
+}
+
+// x / 255 rounded to nearest, exact for x <= 255 * 255
+static inline uint32_t div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// Every channel, alpha included, becomes src * alpha + dst * (1 - alpha)
+static inline uint32_t blendPixel(uint32_t dst, uint32_t src, uint32_t alpha) {
+    uint32_t inverse = 255 - alpha;
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t s = (src >> shift) & 0xFF;
+        uint32_t d = (dst >> shift) & 0xFF;
+        out |= div255(s * alpha + d * inverse) << shift;
+    }
+    return out;
+}
+
+static void fillSpan(uint32_t* dst, int count, uint32_t pixel) {
+    int i = 0;
+#if defined(SOFTWARE_SPANS_SSE2)
+    __m128i value = _mm_set1_epi32((int)pixel);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)(dst + i), value);
+    }
+#elif defined(SOFTWARE_SPANS_NEON)
+    uint32x4_t value = vdupq_n_u32(pixel);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u32(dst + i, value);
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = pixel;
+    }
+}
+
+// Blends one color with constant alpha over a run of pixels
+static void blendSpan(uint32_t* dst, int count, uint32_t pixel, uint32_t alpha) {
+    int i = 0;
+#if defined(SOFTWARE_SPANS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i inverse = _mm_set1_epi16((short)(255 - alpha));
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i src = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int)pixel), zero),
+                                        _mm_set1_epi16((short)alpha));
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inverse), src), half);
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inverse), src), half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(SOFTWARE_SPANS_NEON)
+    const uint8x8_t alpha8 = vdup_n_u8((uint8_t)alpha);
+    const uint8x8_t inverse8 = vdup_n_u8((uint8_t)(255 - alpha));
+    const uint8x8_t src8 = vreinterpret_u8_u32(vdup_n_u32(pixel));
+    for (; i + 4 <= count; i += 4) {
+        uint8x16_t d = vld1q_u8((const uint8_t*)(dst + i));
+        uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(d), inverse8), src8, alpha8);
+        uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(d), inverse8), src8, alpha8);
+        // (x + 128 + ((x + 128) >> 8)) >> 8, same rounding as div255
+        uint8x8_t outLo = vrshrn_n_u16(vrsraq_n_u16(lo, lo, 8), 8);
+        uint8x8_t outHi = vrshrn_n_u16(vrsraq_n_u16(hi, hi, 8), 8);
+        vst1q_u8((uint8_t*)(dst + i), vcombine_u8(outLo, outHi));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = blendPixel(dst[i], pixel, alpha);
+    }
+}
+
+// Fully covered runs go through the span routines, partial pixels one by one
+static inline void writeSpan(uint32_t* dst, int count, uint32_t pixel, uint32_t alpha) {
+    if (count <= 0 || alpha == 0) {
+        return;
+    }
+    if (alpha == 255) {
+        fillSpan(dst, count, pixel | 0xFF000000u);
+    } else {
+        blendSpan(dst, count, (pixel & 0x00FFFFFFu) | (alpha << 24), alpha);
+    }
+}
+
+static inline void writeCoveredPixel(uint32_t* dst, uint32_t pixel, uint32_t alpha) {
+    if (alpha == 0) {
+        return;
+    }
+    *dst = blendPixel(*dst, (pixel & 0x00FFFFFFu) | (alpha << 24), alpha);
+}
+
+// First pixel whose center lies at or after the edge
+static inline int pixelEdge(float edge) {
+    return (int)std::ceil(edge - 0.5f);
+}
+
+SoftwareRenderBackend::SoftwareRenderBackend()
+    : m_width(0)
+    , m_height(0)
+    , m_clearColor(0)
+    , m_clipX0(0)
+    , m_clipY0(0)
+    , m_clipX1(0)
+    , m_clipY1(0)
+{
+}
+
+SoftwareRenderBackend::~SoftwareRenderBackend() {
+    cleanup();
+}
+
+bool SoftwareRenderBackend::initialize(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    
+    resize(width, height);
+    LOGI("Software backend initialized: %d x %d", m_width, m_height);
+    return true;
+}
+
+void SoftwareRenderBackend::cleanup() {
+    m_pixels.clear();
+    m_textures.clear();
+    m_width = 0;
+    m_height = 0;
+}
+
+void SoftwareRenderBackend::resize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_pixels.assign((size_t)width * height, m_clearColor);
+    setClipRect(nullptr);
+}
+
+void SoftwareRenderBackend::beginFrame() {
+    setClipRect(nullptr);
+    fillSpan(m_pixels.data(), (int)m_pixels.size(), m_clearColor);
+}
+
+void SoftwareRenderBackend::setClipRect(const ClipRect* clip) {
+    m_clipX0 = 0;
+    m_clipY0 = 0;
+    m_clipX1 = m_width;
+    m_clipY1 = m_height;
+    if (clip) {
+        m_clipX0 = clip->x > 0 ? clip->x : 0;
+        m_clipY0 = clip->y > 0 ? clip->y : 0;
+        m_clipX1 = clip->x + clip->width < m_width ? clip->x + clip->width : m_width;
+        m_clipY1 = clip->y + clip->height < m_height ? clip->y + clip->height : m_height;
+    }
+}
+
+void SoftwareRenderBackend::clear(float r, float g, float b, float a) {
+    const uint8_t color[3] = { toByte(r), toByte(g), toByte(b) };
+    m_clearColor = packPixel(color, toByte(a));
+    fillSpan(m_pixels.data(), (int)m_pixels.size(), m_clearColor);
+}
+
+void SoftwareRenderBackend::present() {
+    // The framebuffer is read back through getPixels()
+}
+
+void SoftwareRenderBackend::drawQuads(const BatchVertex* vertices, int quadCount, TextureHandle texture) {
+    const Texture* boundTexture = findTexture(texture);
+    
+    for (int i = 0; i < quadCount; ++i) {
+        const BatchVertex* quad = vertices + i * 4;
+        
+        int x0 = pixelEdge(quad[0].x);
+        int y0 = pixelEdge(quad[0].y);
+        int x1 = pixelEdge(quad[2].x);
+        int y1 = pixelEdge(quad[2].y);
+        if (x0 < m_clipX0) x0 = m_clipX0;
+        if (y0 < m_clipY0) y0 = m_clipY0;
+        if (x1 > m_clipX1) x1 = m_clipX1;
+        if (y1 > m_clipY1) y1 = m_clipY1;
+        if (x0 >= x1 || y0 >= y1 || quad[0].color[3] == 0) {
+            continue;
+        }
+        
+        uint32_t color = packPixel(quad[0].color, quad[0].color[3]);
+        if (quad[0].shape[0] > 0.0f) {
+            drawShapeQuad(quad, x0, y0, x1, y1, color);
+        } else if (quad[0].u <= -0.5f) {
+            drawSolidQuad(x0, y0, x1, y1, color);
+        } else if (boundTexture && boundTexture->distanceField && quad[0].shape[2] > 0.0f) {
+            drawDistanceFieldQuad(quad, x0, y0, x1, y1, color, *boundTexture);
+        } else if (boundTexture) {
+            drawTexturedQuad(quad, x0, y0, x1, y1, color, *boundTexture);
+        }
+    }
+}
+
+void SoftwareRenderBackend::drawSolidQuad(int x0, int y0, int x1, int y1, uint32_t color) {
+    uint32_t alpha = color >> 24;
+    for (int y = y0; y < y1; ++y) {
+        writeSpan(&m_pixels[(size_t)y * m_width + x0], x1 - x0, color, alpha);
+    }
+}
+
+void SoftwareRenderBackend::drawTexturedQuad(const BatchVertex* quad, int x0, int y0, int x1, int y1,
+                                             uint32_t color, const Texture& texture) {
+    uint32_t alpha = color >> 24;
+    float du = (quad[2].u - quad[0].u) / (quad[2].x - quad[0].x);
+    float dv = (quad[2].v - quad[0].v) / (quad[2].y - quad[0].y);
+    
+    for (int y = y0; y < y1; ++y) {
+        float v = quad[0].v + ((float)y + 0.5f - quad[0].y) * dv;
+        int ty = (int)std::floor(v * (float)texture.height);
+        ty = ty < 0 ? 0 : (ty >= texture.height ? texture.height - 1 : ty);
+        const uint8_t* texels = &texture.alpha[(size_t)ty * texture.width];
+        uint32_t* row = &m_pixels[(size_t)y * m_width];
+        
+        int runStart = -1;
+        for (int x = x0; x < x1; ++x) {
+            float u = quad[0].u + ((float)x + 0.5f - quad[0].x) * du;
+            int tx = (int)std::floor(u * (float)texture.width);
+            tx = tx < 0 ? 0 : (tx >= texture.width ? texture.width - 1 : tx);
+            uint32_t coverage = texels[tx];
+            
+            if (coverage == 255) {
+                if (runStart < 0) runStart = x;
+                continue;
+            }
+            if (runStart >= 0) {
+                writeSpan(row + runStart, x - runStart, color, alpha);
+                runStart = -1;
+            }
+            writeCoveredPixel(row + x, color, div255(alpha * coverage));
+        }
+        if (runStart >= 0) {
+            writeSpan(row + runStart, x1 - runStart, color, alpha);
+        }
+    }
+}
+
+// Bilinear fetch with GL_LINEAR / CLAMP_TO_EDGE addressing: texel centers
+// sit at (i + 0.5) / size
+static float sampleBilinear(const uint8_t* texels, int width, int height, float u, float v) {
+    float fx = u * (float)width - 0.5f;
+    float fy = v * (float)height - 0.5f;
+    float floorX = std::floor(fx);
+    float floorY = std::floor(fy);
+    float tx = fx - floorX;
+    float ty = fy - floorY;
+    int x0 = (int)floorX;
+    int y0 = (int)floorY;
+    int x1 = x0 + 1;
+    int y1 = y0 + 1;
+    x0 = x0 < 0 ? 0 : (x0 >= width ? width - 1 : x0);
+    x1 = x1 < 0 ? 0 : (x1 >= width ? width - 1 : x1);
+    y0 = y0 < 0 ? 0 : (y0 >= height ? height - 1 : y0);
+    y1 = y1 < 0 ? 0 : (y1 >= height ? height - 1 : y1);
+    
+    const uint8_t* row0 = texels + (size_t)y0 * width;
+    const uint8_t* row1 = texels + (size_t)y1 * width;
+    float top = (float)row0[x0] + ((float)row0[x1] - (float)row0[x0]) * tx;
+    float bottom = (float)row1[x0] + ((float)row1[x1] - (float)row1[x0]) * tx;
+    return (top + (bottom - top) * ty) / 255.0f;
+}
+
+void SoftwareRenderBackend::drawDistanceFieldQuad(const BatchVertex* quad, int x0, int y0, int x1, int y1,
+                                                  uint32_t color, const Texture& texture) {
+    uint32_t alpha = color >> 24;
+    float rampScale = 1.0f / quad[0].shape[2];
+    float du = (quad[2].u - quad[0].u) / (quad[2].x - quad[0].x);
+    float dv = (quad[2].v - quad[0].v) / (quad[2].y - quad[0].y);
+    
+    for (int y = y0; y < y1; ++y) {
+        float v = quad[0].v + ((float)y + 0.5f - quad[0].y) * dv;
+        uint32_t* row = &m_pixels[(size_t)y * m_width];
+        
+        int runStart = -1;
+        for (int x = x0; x < x1; ++x) {
+            float u = quad[0].u + ((float)x + 0.5f - quad[0].x) * du;
+            // Same ramp as the GL fragment shader
+            float dist = sampleBilinear(texture.alpha.data(), texture.width, texture.height, u, v) - 0.5f;
+            float coverage = dist * rampScale + 0.5f;
+            
+            if (coverage >= 1.0f) {
+                if (runStart < 0) runStart = x;
+                continue;
+            }
+            if (runStart >= 0) {
+                writeSpan(row + runStart, x - runStart, color, alpha);
+                runStart = -1;
+            }
+            if (coverage > 0.0f) {
+                writeCoveredPixel(row + x, color, toByte((float)alpha / 255.0f * coverage));
+            }
+        }
+        if (runStart >= 0) {
+            writeSpan(row + runStart, x1 - runStart, color, alpha);
+        }
+    }
+}
+
+void SoftwareRenderBackend::drawShapeQuad(const BatchVertex* quad, int x0, int y0, int x1, int y1, uint32_t color) {
+    uint32_t alpha = color >> 24;
+    float halfWidth = quad[0].shape[0];
+    float halfHeight = quad[0].shape[1];
+    float radius = quad[0].shape[2];
+    float stroke = quad[0].shape[3];
+    float du = (quad[2].u - quad[0].u) / (quad[2].x - quad[0].x);
+    float dv = (quad[2].v - quad[0].v) / (quad[2].y - quad[0].y);
+    
+    // Filled shapes are fully covered wherever both q components stay below
+    // this bound, which lets whole interior runs skip the distance math
+    float interior = radius - 0.5f < 0.0f ? radius - 0.5f : 0.0f;
+    float interiorU = halfWidth - radius + interior;
+    
+    for (int y = y0; y < y1; ++y) {
+        float v = quad[0].v + ((float)y + 0.5f - quad[0].y) * dv;
+        float qy = std::fabs(v) - halfHeight + radius;
+        bool interiorRow = stroke <= 0.0f && qy <= interior;
+        uint32_t* row = &m_pixels[(size_t)y * m_width];
+        
+        int runStart = -1;
+        for (int x = x0; x < x1; ++x) {
+            float u = quad[0].u + ((float)x + 0.5f - quad[0].x) * du;
+            float qx = std::fabs(u) - halfWidth + radius;
+            
+            if (interiorRow && qx <= interior) {
+                // Last pixel whose center still has u <= interiorU
+                int interiorEnd = (int)std::floor((interiorU - quad[0].u) / du + quad[0].x - 0.5f) + 1;
+                if (interiorEnd > x1) interiorEnd = x1;
+                if (runStart < 0) runStart = x;
+                if (interiorEnd > x + 1) x = interiorEnd - 1;
+                continue;
+            }
+            
+            // Same rounded-box distance as the GL fragment shader
+            float ox = qx > 0.0f ? qx : 0.0f;
+            float oy = qy > 0.0f ? qy : 0.0f;
+            float inside = qx > qy ? qx : qy;
+            float dist = std::sqrt(ox * ox + oy * oy) + (inside < 0.0f ? inside : 0.0f) - radius;
+            if (stroke > 0.0f) {
+                dist = std::fabs(dist + stroke * 0.5f) - stroke * 0.5f;
+            }
+            float coverage = 0.5f - dist;
+            
+            if (coverage >= 1.0f) {
+                if (runStart < 0) runStart = x;
+                continue;
+            }
+            if (runStart >= 0) {
+                writeSpan(row + runStart, x - runStart, color, alpha);
+                runStart = -1;
+            }
+            if (coverage > 0.0f) {
+                writeCoveredPixel(row + x, color, toByte((float)alpha / 255.0f * coverage));
+            }
+        }
+        if (runStart >= 0) {
+            writeSpan(row + runStart, x1 - runStart, color, alpha);
+        }
+    }
+}
+
+TextureHandle SoftwareRenderBackend::createAlphaTexture(const uint8_t* pixels, int width, int height) {
+    return addTexture(pixels, width, height, false);
+}
+
+TextureHandle SoftwareRenderBackend::createDistanceFieldTexture(const uint8_t* pixels, int width, int height) {
+    return addTexture(pixels, width, height, true);
+}
+
+TextureHandle SoftwareRenderBackend::addTexture(const uint8_t* pixels, int width, int height, bool distanceField) {
+    if (!pixels || width <= 0 || height <= 0) {
+        return 0;
+    }
+    
+    Texture texture;
+    texture.width = width;
+    texture.height = height;
+    texture.alpha.assign(pixels, pixels + (size_t)width * height);
+    texture.distanceField = distanceField;
+    
+    // Reuse the first destroyed slot so handles stay small
+    for (size_t i = 0; i < m_textures.size(); ++i) {
+        if (m_textures[i].alpha.empty()) {
+            m_textures[i] = texture;
+            return (TextureHandle)(i + 1);
+        }
+    }
+    m_textures.push_back(texture);
+    return (TextureHandle)m_textures.size();
+}
+
+void SoftwareRenderBackend::destroyTexture(TextureHandle texture) {
+    if (texture == 0 || texture > m_textures.size()) {
+        return;
+    }
+    
+    Texture& slot = m_textures[texture - 1];
+    slot.width = 0;
+    slot.height = 0;
+    std::vector<uint8_t>().swap(slot.alpha);
+}
+
+const SoftwareRenderBackend::Texture* SoftwareRenderBackend::findTexture(TextureHandle texture) const {
+    if (texture == 0 || texture > m_textures.size() || m_textures[texture - 1].alpha.empty()) {
+        return nullptr;
+    }
+    return &m_textures[texture - 1];
+}
@@ -0,0 +1,65 @@
+#ifndef SOFTWARE_RENDER_BACKEND_H
+#define SOFTWARE_RENDER_BACKEND_H
+
+#include "RenderBackend.h"
+#include <cstdint>
+#include <vector>
+
+// CPU rasterizer into an RGBA8 framebuffer, for headless runs on the host.
+// Follows the GL backend's rules: pixel centers at +0.5, nearest texture
+// sampling (bilinear for distance fields), the same SDF coverage and
+// SRC_ALPHA / ONE_MINUS_SRC_ALPHA blending.
+// Span fills and blends use SSE2 or NEON when the target has them.
+class SoftwareRenderBackend : public RenderBackend {
+public:
+    SoftwareRenderBackend();
+    ~SoftwareRenderBackend() override;
+    
+    bool initialize(int width, int height) override;
+    void cleanup() override;
+    void resize(int width, int height) override;
+    
+    void beginFrame() override;
+    void clear(float r, float g, float b, float a) override;
+    void setClipRect(const ClipRect* clip) override;
+    void drawQuads(const BatchVertex* vertices, int quadCount, TextureHandle texture) override;
+    void present() override;
+    
+    TextureHandle createAlphaTexture(const uint8_t* pixels, int width, int height) override;
+    TextureHandle createDistanceFieldTexture(const uint8_t* pixels, int width, int height) override;
+    void destroyTexture(TextureHandle texture) override;
+    
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    // Row-major, no padding; bytes are R, G, B, A in memory order
+    const uint32_t* getPixels() const { return m_pixels.data(); }
+    
+private:
+    struct Texture {
+        int width;
+        int height;
+        std::vector<uint8_t> alpha;
+        bool distanceField;
+    };
+    
+    int m_width;
+    int m_height;
+    std::vector<uint32_t> m_pixels;
+    uint32_t m_clearColor;
+    // Spans are cut to this rectangle, the whole target without a clip
+    int m_clipX0, m_clipY0;
+    int m_clipX1, m_clipY1;
+    // Handle N lives in slot N - 1; destroyed slots stay empty
+    std::vector<Texture> m_textures;
+    
+    TextureHandle addTexture(const uint8_t* pixels, int width, int height, bool distanceField);
+    const Texture* findTexture(TextureHandle texture) const;
+    void drawSolidQuad(int x0, int y0, int x1, int y1, uint32_t color);
+    void drawTexturedQuad(const BatchVertex* quad, int x0, int y0, int x1, int y1,
+                          uint32_t color, const Texture& texture);
+    void drawDistanceFieldQuad(const BatchVertex* quad, int x0, int y0, int x1, int y1,
+                               uint32_t color, const Texture& texture);
+    void drawShapeQuad(const BatchVertex* quad, int x0, int y0, int x1, int y1, uint32_t color);
+};
+
+#endif // SOFTWARE_RENDER_BACKEND_H
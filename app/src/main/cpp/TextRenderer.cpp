@@ -1,8 +1,66 @@
 #include "TextRenderer.h"
+#include "FontAsset.h"
 #include "Renderer.h"
+#include "Utf8.h"
 #include <cmath>
 #include <cstring>
 
+// Glyphs of font_bitmap in atlas order. Digits and Latin capitals come first
+// so that '0' + n and 'A' + n index them directly.
+enum FontGlyph : uint8_t {
+    GLYPH_DIGIT_0 = 0,
+    GLYPH_LATIN_A = 10,
+    GLYPH_SPACE = 36,
+    GLYPH_COLON,
+    GLYPH_PLUS,
+    GLYPH_MINUS,
+    GLYPH_SLASH,
+    GLYPH_PERIOD,
+    GLYPH_COMMA,
+    GLYPH_EXCLAMATION,
+    GLYPH_QUESTION,
+    GLYPH_LEFT_PAREN,
+    GLYPH_RIGHT_PAREN,
+    GLYPH_APOSTROPHE,
+    GLYPH_QUOTE,
+    GLYPH_PERCENT,
+    GLYPH_EQUALS,
+    GLYPH_UNDERSCORE,
+    GLYPH_HASH,
+    GLYPH_ASTERISK,
+    GLYPH_LESS,
+    GLYPH_GREATER,
+    GLYPH_SEMICOLON,
+    GLYPH_LEFT_GUILLEMET,
+    GLYPH_RIGHT_GUILLEMET,
+    GLYPH_ELLIPSIS,
+    GLYPH_TIMES,
+    // Cyrillic capitals without a Latin look-alike
+    GLYPH_CYRILLIC_BE,
+    GLYPH_CYRILLIC_GHE,
+    GLYPH_CYRILLIC_DE,
+    GLYPH_CYRILLIC_ZHE,
+    GLYPH_CYRILLIC_I,
+    GLYPH_CYRILLIC_SHORT_I,
+    GLYPH_CYRILLIC_EL,
+    GLYPH_CYRILLIC_PE,
+    GLYPH_CYRILLIC_U,
+    GLYPH_CYRILLIC_EF,
+    GLYPH_CYRILLIC_TSE,
+    GLYPH_CYRILLIC_CHE,
+    GLYPH_CYRILLIC_SHA,
+    GLYPH_CYRILLIC_SHCHA,
+    GLYPH_CYRILLIC_HARD_SIGN,
+    GLYPH_CYRILLIC_YERU,
+    GLYPH_CYRILLIC_SOFT_SIGN,
+    GLYPH_CYRILLIC_E,
+    GLYPH_CYRILLIC_YU,
+    GLYPH_CYRILLIC_YA,
+    GLYPH_CYRILLIC_YO,
+    GLYPH_COUNT,
+    GLYPH_NONE = 0xFF
+};
+
 // Simple 5x7 bitmap font for digits and basic characters
 // Each character is 5 pixels wide, 7 pixels tall
 static const unsigned char font_bitmap[][7] = {
@@ -54,12 +112,185 @@ static const unsigned char font_bitmap[][7] = {
     {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, // -
     // Slash
     {0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x10}, // /
+    // Punctuation
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, // .
+    {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}, // ,
+    {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}, // !
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}, // ?
+    {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, // (
+    {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, // )
+    {0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00}, // '
+    {0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00}, // "
+    {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // %
+    {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}, // =
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}, // _
+    {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A}, // #
+    {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00}, // *
+    {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}, // <
+    {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}, // >
+    {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08}, // ;
+    {0x00, 0x05, 0x0A, 0x14, 0x0A, 0x05, 0x00}, // U+00AB left guillemet
+    {0x00, 0x14, 0x0A, 0x05, 0x0A, 0x14, 0x00}, // U+00BB right guillemet
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15}, // U+2026 ellipsis
+    {0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00}, // U+00D7 multiplication sign
+    // Cyrillic
+    {0x1F, 0x10, 0x10, 0x1E, 0x11, 0x11, 0x1E}, // BE
+    {0x1F, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10}, // GHE
+    {0x06, 0x0A, 0x0A, 0x0A, 0x0A, 0x1F, 0x11}, // DE
+    {0x15, 0x15, 0x0E, 0x04, 0x0E, 0x15, 0x15}, // ZHE
+    {0x11, 0x11, 0x13, 0x15, 0x19, 0x11, 0x11}, // I
+    {0x0A, 0x04, 0x11, 0x13, 0x15, 0x19, 0x11}, // SHORT I
+    {0x07, 0x09, 0x09, 0x09, 0x09, 0x09, 0x11}, // EL
+    {0x1F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11}, // PE
+    {0x11, 0x11, 0x11, 0x0F, 0x01, 0x11, 0x0E}, // U
+    {0x04, 0x0E, 0x15, 0x15, 0x15, 0x0E, 0x04}, // EF
+    {0x12, 0x12, 0x12, 0x12, 0x12, 0x1F, 0x01}, // TSE
+    {0x11, 0x11, 0x11, 0x0F, 0x01, 0x01, 0x01}, // CHE
+    {0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x1F}, // SHA
+    {0x15, 0x15, 0x15, 0x15, 0x15, 0x1F, 0x01}, // SHCHA
+    {0x18, 0x08, 0x08, 0x0E, 0x09, 0x09, 0x0E}, // HARD SIGN
+    {0x11, 0x11, 0x11, 0x1D, 0x13, 0x13, 0x1D}, // YERU
+    {0x10, 0x10, 0x10, 0x1E, 0x11, 0x11, 0x1E}, // SOFT SIGN
+    {0x0E, 0x11, 0x01, 0x07, 0x01, 0x11, 0x0E}, // E
+    {0x12, 0x15, 0x15, 0x1D, 0x15, 0x15, 0x12}, // YU
+    {0x0F, 0x11, 0x11, 0x0F, 0x05, 0x09, 0x11}, // YA
+    {0x0A, 0x00, 0x1F, 0x10, 0x1E, 0x10, 0x1F}, // YO
+};
+
+static_assert(sizeof(font_bitmap) / sizeof(font_bitmap[0]) == GLYPH_COUNT, "font_bitmap and FontGlyph disagree");
+
+// Codepoint -> glyph page table. The top level maps each block of
+// GLYPH_PAGE_SIZE codepoints of the BMP to one of a few leaf pages; blocks
+// without glyphs (and everything beyond the BMP) share the empty page 0.
+// The table is generated at compile time from the mappings below.
+static const int GLYPH_PAGE_BITS = 7;
+static const uint32_t GLYPH_PAGE_SIZE = 1u << GLYPH_PAGE_BITS;
+static const uint32_t GLYPH_PAGE_COUNT = 0x10000 >> GLYPH_PAGE_BITS;
+static const int GLYPH_MAX_LEAF_PAGES = 8;
+
+struct GlyphRange {
+    uint32_t first;
+    uint32_t last;
+    uint8_t glyph;      // glyph of first; the range maps onto consecutive glyphs
+};
+
+static constexpr GlyphRange s_glyphRanges[] = {
+    { '0', '9', GLYPH_DIGIT_0 },
+    { 'A', 'Z', GLYPH_LATIN_A },
+    { 'a', 'z', GLYPH_LATIN_A },
+    { ' ', ' ', GLYPH_SPACE },
+    { ':', ':', GLYPH_COLON },
+    { '+', '+', GLYPH_PLUS },
+    { '-', '-', GLYPH_MINUS },
+    { '/', '/', GLYPH_SLASH },
+    { '.', '.', GLYPH_PERIOD },
+    { ',', ',', GLYPH_COMMA },
+    { '!', '!', GLYPH_EXCLAMATION },
+    { '?', '?', GLYPH_QUESTION },
+    { '(', '(', GLYPH_LEFT_PAREN },
+    { ')', ')', GLYPH_RIGHT_PAREN },
+    { '\'', '\'', GLYPH_APOSTROPHE },
+    { '"', '"', GLYPH_QUOTE },
+    { '%', '%', GLYPH_PERCENT },
+    { '=', '=', GLYPH_EQUALS },
+    { '_', '_', GLYPH_UNDERSCORE },
+    { '#', '#', GLYPH_HASH },
+    { '*', '*', GLYPH_ASTERISK },
+    { '<', '<', GLYPH_LESS },
+    { '>', '>', GLYPH_GREATER },
+    { ';', ';', GLYPH_SEMICOLON },
+    { 0x00A0, 0x00A0, GLYPH_SPACE },          // no-break space
+    { 0x00AB, 0x00AB, GLYPH_LEFT_GUILLEMET },
+    { 0x00BB, 0x00BB, GLYPH_RIGHT_GUILLEMET },
+    { 0x00D7, 0x00D7, GLYPH_TIMES },
+    { 0x2013, 0x2013, GLYPH_MINUS },          // en dash
+    { 0x2014, 0x2014, GLYPH_MINUS },          // em dash
+    { 0x2019, 0x2019, GLYPH_APOSTROPHE },
+    { 0x2026, 0x2026, GLYPH_ELLIPSIS },
+    { 0x0401, 0x0401, GLYPH_CYRILLIC_YO },
+    { 0x0451, 0x0451, GLYPH_CYRILLIC_YO },
+};
+
+// U+0410..U+042F and, for lower case, U+0430..U+044F in alphabet order;
+// letters that look like Latin capitals (or the digit 3) reuse those glyphs
+static constexpr uint8_t s_cyrillicAlphabet[32] = {
+    GLYPH_LATIN_A + ('A' - 'A'), GLYPH_CYRILLIC_BE, GLYPH_LATIN_A + ('B' - 'A'), GLYPH_CYRILLIC_GHE,
+    GLYPH_CYRILLIC_DE, GLYPH_LATIN_A + ('E' - 'A'), GLYPH_CYRILLIC_ZHE, GLYPH_DIGIT_0 + 3,
+    GLYPH_CYRILLIC_I, GLYPH_CYRILLIC_SHORT_I, GLYPH_LATIN_A + ('K' - 'A'), GLYPH_CYRILLIC_EL,
+    GLYPH_LATIN_A + ('M' - 'A'), GLYPH_LATIN_A + ('H' - 'A'), GLYPH_LATIN_A + ('O' - 'A'), GLYPH_CYRILLIC_PE,
+    GLYPH_LATIN_A + ('P' - 'A'), GLYPH_LATIN_A + ('C' - 'A'), GLYPH_LATIN_A + ('T' - 'A'), GLYPH_CYRILLIC_U,
+    GLYPH_CYRILLIC_EF, GLYPH_LATIN_A + ('X' - 'A'), GLYPH_CYRILLIC_TSE, GLYPH_CYRILLIC_CHE,
+    GLYPH_CYRILLIC_SHA, GLYPH_CYRILLIC_SHCHA, GLYPH_CYRILLIC_HARD_SIGN, GLYPH_CYRILLIC_YERU,
+    GLYPH_CYRILLIC_SOFT_SIGN, GLYPH_CYRILLIC_E, GLYPH_CYRILLIC_YU, GLYPH_CYRILLIC_YA,
 };
 
+struct GlyphPageTable {
+    // One extra entry, always the empty page, for codepoints beyond the BMP
+    uint8_t pageOf[GLYPH_PAGE_COUNT + 1];
+    uint8_t pages[GLYPH_MAX_LEAF_PAGES][GLYPH_PAGE_SIZE];
+    int leafPageCount;
+};
+
+static constexpr void mapGlyph(GlyphPageTable& table, uint32_t codepoint, uint8_t glyph) {
+    uint32_t block = codepoint >> GLYPH_PAGE_BITS;
+    if (table.pageOf[block] == 0) {
+        // Page 0 stays empty; running out of pages fails the static_assert below
+        table.pageOf[block] = (uint8_t)table.leafPageCount++;
+    }
+    if (table.leafPageCount <= GLYPH_MAX_LEAF_PAGES) {
+        table.pages[table.pageOf[block]][codepoint & (GLYPH_PAGE_SIZE - 1)] = glyph;
+    }
+}
+
+static constexpr GlyphPageTable buildGlyphPageTable() {
+    GlyphPageTable table = {};
+    table.leafPageCount = 1;
+    for (int page = 0; page < GLYPH_MAX_LEAF_PAGES; ++page) {
+        for (uint32_t i = 0; i < GLYPH_PAGE_SIZE; ++i) {
+            table.pages[page][i] = GLYPH_NONE;
+        }
+    }
+    
+    for (const GlyphRange& range : s_glyphRanges) {
+        for (uint32_t codepoint = range.first; codepoint <= range.last; ++codepoint) {
+            mapGlyph(table, codepoint, (uint8_t)(range.glyph + (codepoint - range.first)));
+        }
+    }
+    for (uint32_t letter = 0; letter < 32; ++letter) {
+        mapGlyph(table, 0x0410 + letter, s_cyrillicAlphabet[letter]);
+        mapGlyph(table, 0x0430 + letter, s_cyrillicAlphabet[letter]);
+    }
+    return table;
+}
+
+static constexpr GlyphPageTable s_glyphPageTable = buildGlyphPageTable();
+static_assert(s_glyphPageTable.leafPageCount <= GLYPH_MAX_LEAF_PAGES, "raise GLYPH_MAX_LEAF_PAGES");
+
+// Run cache font ids
+static const uint32_t FONT_BITMAP_5X7 = 1;
+static const uint32_t FONT_DISTANCE_FIELD = 2;
+
+static void writeGlyphQuad(BatchVertex* quad, float x0, float y0, float x1, float y1,
+                           float u0, float v0, float u1, float v1, float distanceRamp) {
+    for (int j = 0; j < 4; ++j) {
+        quad[j].color[0] = quad[j].color[1] = quad[j].color[2] = quad[j].color[3] = 255;
+        quad[j].shape[0] = quad[j].shape[1] = quad[j].shape[3] = 0.0f;
+        quad[j].shape[2] = distanceRamp;
+    }
+    quad[0].x = x0; quad[0].y = y0; quad[0].u = u0; quad[0].v = v0;
+    quad[1].x = x1; quad[1].y = y0; quad[1].u = u1; quad[1].v = v0;
+    quad[2].x = x1; quad[2].y = y1; quad[2].u = u1; quad[2].v = v1;
+    quad[3].x = x0; quad[3].y = y1; quad[3].u = u0; quad[3].v = v1;
+}
+
 TextRenderer::TextRenderer()
     : m_renderer(nullptr)
+    , m_fontAsset(nullptr)
+    , m_atlasContextId(0)
+    , m_atlasTexture(0)
     , m_charWidth(5.0f)
     , m_charHeight(7.0f)
+    , m_fontId(FONT_BITMAP_5X7)
 {
 }
 
@@ -68,63 +299,235 @@ TextRenderer::~TextRenderer() {
 }
 
 bool TextRenderer::initialize(Renderer* renderer) {
-    m_renderer = renderer;
-    return m_renderer != nullptr;
+    if (!renderer) {
+        m_renderer = nullptr;
+        return false;
+    }
+    
+    // A new renderer may reuse the old one's address, so compare contexts too
+    if (renderer != m_renderer || renderer->getContextId() != m_atlasContextId) {
+        m_renderer = renderer;
+        m_atlasTexture = 0;
+        m_atlasContextId = renderer->getContextId();
+        buildAtlas();
+    }
+    return m_atlasTexture != 0;
 }
 
 void TextRenderer::cleanup() {
+    // The atlas texture is owned by the renderer and released with its GL context,
+    // which may already be gone here
+    m_atlasTexture = 0;
+    m_atlasContextId = 0;
     m_renderer = nullptr;
 }
 
+void TextRenderer::setFontAsset(const FontAsset* asset) {
+    if (asset && !asset->isOpen()) {
+        asset = nullptr;
+    }
+    if (asset == m_fontAsset) {
+        return;
+    }
+    
+    m_fontAsset = asset;
+    m_fontId = asset ? FONT_DISTANCE_FIELD : FONT_BITMAP_5X7;
+    // Cached runs of a previous asset would share its font id
+    m_runCache.clear();
+    
+    if (m_renderer) {
+        m_renderer->destroyTexture(m_atlasTexture);
+        m_atlasTexture = 0;
+        buildAtlas();
+    }
+}
+
+bool TextRenderer::buildAtlas() {
+    // The asset's atlas is uploaded straight from the mapping
+    if (m_fontAsset) {
+        const FontAssetHeader& header = m_fontAsset->getHeader();
+        m_atlasTexture = m_renderer->createDistanceFieldTexture(m_fontAsset->getAtlasPixels(),
+                                                                (int)header.atlasWidth, (int)header.atlasHeight);
+        return m_atlasTexture != 0;
+    }
+    
+    static_assert(GLYPH_COUNT <= (ATLAS_SIZE / ATLAS_CELL_SIZE) * ATLAS_COLUMNS, "glyph atlas too small");
+    
+    // Rasterize font_bitmap once: one byte of coverage per font pixel
+    std::vector<uint8_t> pixels(ATLAS_SIZE * ATLAS_SIZE, 0);
+    
+    for (int glyph = 0; glyph < GLYPH_COUNT; ++glyph) {
+        int originX = (glyph % ATLAS_COLUMNS) * ATLAS_CELL_SIZE + 1;
+        int originY = (glyph / ATLAS_COLUMNS) * ATLAS_CELL_SIZE + 1;
+        
+        for (int row = 0; row < 7; ++row) {
+            unsigned char rowData = font_bitmap[glyph][row];
+            for (int col = 0; col < 5; ++col) {
+                if (rowData & (1 << (4 - col))) {
+                    pixels[(originY + row) * ATLAS_SIZE + originX + col] = 255;
+                }
+            }
+        }
+    }
+    
+    m_atlasTexture = m_renderer->createAlphaTexture(pixels.data(), ATLAS_SIZE, ATLAS_SIZE);
+    return m_atlasTexture != 0;
+}
+
 void TextRenderer::drawText(float x, float y, const std::string& text, float r, float g, float b, float a, float scale) {
     if (!m_renderer) return;
     
-    float currentX = x;
-    for (size_t i = 0; i < text.length(); ++i) {
-        char c = text[i];
-        if (c == ' ') {
-            currentX += m_charWidth * scale * 1.2f;
-            continue;
+    drawTextRun(x, y, findOrLayoutRun(text.data(), text.size(), scale), r, g, b, a);
+}
+
+void TextRenderer::drawText(float x, float y, const char* text, float r, float g, float b, float a, float scale) {
+    if (!m_renderer || !text) return;
+    
+    drawTextRun(x, y, findOrLayoutRun(text, std::strlen(text), scale), r, g, b, a);
+}
+
+void TextRenderer::drawTextRun(float x, float y, const TextRun& run, float r, float g, float b, float a) {
+    if (!m_renderer || m_atlasTexture == 0 || run.quads.empty()) return;
+    
+    m_renderer->drawQuadRun(run.quads.data(), run.getQuadCount(), m_atlasTexture, x, y, r, g, b, a);
+}
+
+const TextRun& TextRenderer::getTextRun(const std::string& text, float scale) const {
+    return findOrLayoutRun(text.data(), text.size(), scale);
+}
+
+const TextRun& TextRenderer::getTextRun(const char* text, float scale) const {
+    return findOrLayoutRun(text ? text : "", text ? std::strlen(text) : 0, scale);
+}
+
+const TextRun& TextRenderer::findOrLayoutRun(const char* text, size_t length, float scale) const {
+    const TextRun* cached = m_runCache.find(text, length, scale, m_fontId);
+    if (cached) {
+        return *cached;
+    }
+    
+    TextRun* run = m_runCache.insert(text, length, scale, m_fontId);
+    layoutRun(text, length, scale, *run);
+    return *run;
+}
+
+void TextRenderer::layoutRun(const char* text, size_t length, float scale, TextRun& run) const {
+    run.quads.clear();
+    run.quads.reserve(length * 4);
+    
+    // Unknown characters leave a gap
+    float currentX = 0.0f;
+    size_t offset = 0;
+    while (offset < length) {
+        BatchVertex quad[4];
+        if (buildCodepointQuad(decodeUtf8(text, length, offset), currentX, scale, quad)) {
+            run.quads.insert(run.quads.end(), quad, quad + 4);
         }
-        drawChar(c, currentX, y, r, g, b, a, scale);
-        currentX += m_charWidth * scale * 1.2f;
     }
+    
+    run.width = currentX;
+    run.height = m_charHeight * scale;
 }
 
-void TextRenderer::drawNumber(float x, float y, int number, float r, float g, float b, float a, float scale) {
-    if (number < 0) {
-        drawChar('-', x, y, r, g, b, a, scale);
-        x += m_charWidth * scale * 1.2f;
-        number = -number;
+float TextRenderer::getAssetScale(float scale) const {
+    return m_charHeight * scale / m_fontAsset->getHeader().capHeight;
+}
+
+bool TextRenderer::buildCodepointQuad(uint32_t codepoint, float& penX, float scale, BatchVertex* quad) const {
+    const FontAssetGlyph* glyph = m_fontAsset ? m_fontAsset->findGlyph(codepoint) : nullptr;
+    if (!glyph) {
+        bool drawn = !m_fontAsset && buildGlyphQuad(getGlyphIndex(codepoint), penX, scale, quad);
+        penX += getAdvance(scale);
+        return drawn;
+    }
+    
+    const FontAssetHeader& header = m_fontAsset->getHeader();
+    const float assetScale = getAssetScale(scale);
+    float x = penX;
+    penX += glyph->advance * assetScale;
+    if (glyph->width == 0 || glyph->height == 0) {
+        return false;
     }
     
-    std::string numStr = std::to_string(number);
-    drawText(x, y, numStr, r, g, b, a, scale);
+    // Cap height spans 0..m_charHeight * scale, like the bitmap font
+    float x0 = x + glyph->bearingX * assetScale;
+    float y0 = m_charHeight * scale - glyph->bearingY * assetScale;
+    float u0 = (float)glyph->atlasX / (float)header.atlasWidth;
+    float v0 = (float)glyph->atlasY / (float)header.atlasHeight;
+    // Distance falls by 0.5 over distanceRange atlas pixels
+    float ramp = 0.5f / (header.distanceRange * assetScale);
+    writeGlyphQuad(quad, x0, y0, x0 + (float)glyph->width * assetScale, y0 + (float)glyph->height * assetScale,
+                   u0, v0, u0 + (float)glyph->width / (float)header.atlasWidth,
+                   v0 + (float)glyph->height / (float)header.atlasHeight, ramp);
+    return true;
 }
 
-void TextRenderer::drawTime(float x, float y, int seconds, float r, float g, float b, float a, float scale) {
-    int minutes = seconds / 60;
-    int secs = seconds % 60;
+float TextRenderer::getCodepointAdvance(uint32_t codepoint, float scale) const {
+    const FontAssetGlyph* glyph = m_fontAsset ? m_fontAsset->findGlyph(codepoint) : nullptr;
+    return glyph ? glyph->advance * getAssetScale(scale) : getAdvance(scale);
+}
+
+bool TextRenderer::buildGlyphQuad(int glyph, float x, float scale, BatchVertex* quad) const {
+    // Space has an atlas cell but no pixels
+    if (glyph < 0 || glyph >= GLYPH_COUNT || glyph == GLYPH_SPACE) {
+        return false;
+    }
+    
+    // The texel grid maps 1:1 onto font pixels
+    const float texel = 1.0f / (float)ATLAS_SIZE;
+    float u0 = (float)((glyph % ATLAS_COLUMNS) * ATLAS_CELL_SIZE + 1) * texel;
+    float v0 = (float)((glyph / ATLAS_COLUMNS) * ATLAS_CELL_SIZE + 1) * texel;
+    writeGlyphQuad(quad, x, 0.0f, x + m_charWidth * scale, m_charHeight * scale,
+                   u0, v0, u0 + m_charWidth * texel, v0 + m_charHeight * texel, 0.0f);
+    return true;
+}
+
+void TextRenderer::drawGlyphs(float x, float y, const GlyphString& text, float r, float g, float b, float a, float scale) {
+    if (!m_renderer || m_atlasTexture == 0 || text.empty()) return;
+    
+    BatchVertex* quads = m_renderer->getFrameArena().allocateArray<BatchVertex>((size_t)text.length() * 4);
+    int quadCount = 0;
+    float penX = 0.0f;
     
-    drawNumber(x, y, minutes, r, g, b, a, scale);
-    x += m_charWidth * scale * 2.0f;
-    drawChar(':', x, y, r, g, b, a, scale);
-    x += m_charWidth * scale * 1.5f;
-    if (secs < 10) {
-        drawNumber(x, y, 0, r, g, b, a, scale);
-        x += m_charWidth * scale * 1.2f;
+    for (int i = 0; i < text.length(); ++i) {
+        if (buildCodepointQuad(text.codepoints()[i], penX, scale, quads + quadCount * 4)) {
+            quadCount++;
+        }
+    }
+    
+    if (quadCount > 0) {
+        m_renderer->drawQuadRun(quads, quadCount, m_atlasTexture, x, y, r, g, b, a);
     }
-    drawNumber(x, y, secs, r, g, b, a, scale);
+}
+
+void TextRenderer::drawNumber(float x, float y, int number, float r, float g, float b, float a, float scale) {
+    GlyphString text;
+    text.appendInt(number);
+    drawGlyphs(x, y, text, r, g, b, a, scale);
+}
+
+void TextRenderer::drawTime(float x, float y, int seconds, float r, float g, float b, float a, float scale) {
+    GlyphString text;
+    text.appendTime(seconds);
+    drawGlyphs(x, y, text, r, g, b, a, scale);
 }
 
 float TextRenderer::getTextWidth(const std::string& text, float scale) const {
+    return findOrLayoutRun(text.data(), text.size(), scale).width;
+}
+
+float TextRenderer::getTextWidth(const char* text, float scale) const {
+    return getTextRun(text, scale).width;
+}
+
+float TextRenderer::getTextWidth(const GlyphString& text, float scale) const {
+    if (!m_fontAsset) {
+        return getAdvance(scale) * (float)text.length();
+    }
+    
     float width = 0.0f;
-    for (size_t i = 0; i < text.length(); ++i) {
-        if (text[i] == ' ') {
-            width += m_charWidth * scale * 1.2f;
-        } else {
-            width += m_charWidth * scale * 1.2f;
-        }
+    for (int i = 0; i < text.length(); ++i) {
+        width += getCodepointAdvance(text.codepoints()[i], scale);
     }
     return width;
 }
@@ -133,43 +536,9 @@ float TextRenderer::getTextHeight(float scale) const {
     return m_charHeight * scale;
 }
 
-void TextRenderer::drawChar(char c, float x, float y, float r, float g, float b, float a, float scale) {
-    int charIndex = -1;
-    
-    if (c >= '0' && c <= '9') {
-        charIndex = c - '0';
-    } else if (c >= 'A' && c <= 'Z') {
-        charIndex = 10 + (c - 'A');
-    } else if (c >= 'a' && c <= 'z') {
-        charIndex = 10 + (c - 'a');
-    } else if (c == ' ') {
-        charIndex = 36;
-    } else if (c == ':') {
-        charIndex = 37;
-    } else if (c == '+') {
-        charIndex = 38;
-    } else if (c == '-') {
-        charIndex = 39;
-    } else if (c == '/') {
-        charIndex = 40;
-    }
-    
-    if (charIndex < 0 || charIndex >= 41) {
-        return;
-    }
-    
-    const unsigned char* bitmap = font_bitmap[charIndex];
-    float pixelSize = scale;
-    
-    for (int row = 0; row < 7; ++row) {
-        unsigned char rowData = bitmap[row];
-        for (int col = 0; col < 5; ++col) {
-            if (rowData & (1 << (4 - col))) {
-                float px = x + col * pixelSize;
-                float py = y + row * pixelSize;
-                m_renderer->drawRect(px, py, pixelSize, pixelSize, r, g, b, a);
-            }
-        }
-    }
+int TextRenderer::getGlyphIndex(uint32_t codepoint) {
+    uint32_t block = codepoint >> GLYPH_PAGE_BITS;
+    block = block < GLYPH_PAGE_COUNT ? block : GLYPH_PAGE_COUNT;
+    uint8_t glyph = s_glyphPageTable.pages[s_glyphPageTable.pageOf[block]][codepoint & (GLYPH_PAGE_SIZE - 1)];
+    return glyph == GLYPH_NONE ? -1 : (int)glyph;
 }
-
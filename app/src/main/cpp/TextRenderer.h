@@ -1,9 +1,13 @@
 #ifndef TEXT_RENDERER_H
 #define TEXT_RENDERER_H
 
+#include "GlyphString.h"
+#include "TextRunCache.h"
 #include <string>
 #include <vector>
+#include <cstdint>
 
+class FontAsset;
 class Renderer;
 
 class TextRenderer {
@@ -11,23 +15,71 @@ public:
     TextRenderer();
     ~TextRenderer();
     
+    // Cheap when called again with the same renderer; the glyph atlas is
+    // rebuilt only when the renderer (or its GL context) changes
     bool initialize(Renderer* renderer);
     void cleanup();
     
+    // Draws with a baked distance-field font instead of the built-in 5x7
+    // bitmap font, at the same cap height; nullptr switches back. The asset is
+    // not owned and must stay open while it is set.
+    void setFontAsset(const FontAsset* asset);
+    
     void drawText(float x, float y, const std::string& text, float r, float g, float b, float a, float scale = 1.0f);
+    void drawText(float x, float y, const char* text, float r, float g, float b, float a, float scale = 1.0f);
     void drawNumber(float x, float y, int number, float r, float g, float b, float a, float scale = 1.0f);
     void drawTime(float x, float y, int seconds, float r, float g, float b, float a, float scale = 1.0f);
     
     float getTextWidth(const std::string& text, float scale = 1.0f) const;
+    float getTextWidth(const char* text, float scale = 1.0f) const;
+    float getTextWidth(const GlyphString& text, float scale = 1.0f) const;
     float getTextHeight(float scale = 1.0f) const;
     
+    // Measured and laid out once per text and scale, then reused from the run
+    // cache. The reference is valid until the next lookup of another text.
+    const TextRun& getTextRun(const std::string& text, float scale = 1.0f) const;
+    const TextRun& getTextRun(const char* text, float scale = 1.0f) const;
+    void drawTextRun(float x, float y, const TextRun& run, float r, float g, float b, float a);
+    
+    // Labels whose content changes every frame: laid out into frame arena
+    // scratch on each call instead of going through the run cache
+    void drawGlyphs(float x, float y, const GlyphString& text, float r, float g, float b, float a, float scale = 1.0f);
+    
+    const TextRunCacheStats& getRunCacheStats() const { return m_runCache.getStats(); }
+    
+    // Index of a code point's glyph in the atlas, or -1 when the font has
+    // none. Constant time: two table loads, no branches on the character.
+    static int getGlyphIndex(uint32_t codepoint);
+    
 private:
+    // Atlas grid: every glyph sits in its own cell with a blank border so
+    // nearest sampling at fractional scales never picks up a neighbour
+    static const int ATLAS_CELL_SIZE = 8;
+    static const int ATLAS_COLUMNS = 16;
+    static const int ATLAS_SIZE = 128;
+    
     Renderer* m_renderer;
+    const FontAsset* m_fontAsset;
+    unsigned int m_atlasContextId;
+    unsigned int m_atlasTexture;
     float m_charWidth;
     float m_charHeight;
+    // Identifies the glyph set in run cache keys
+    uint32_t m_fontId;
+    mutable TextRunCache m_runCache;
     
-    void drawChar(char c, float x, float y, float r, float g, float b, float a, float scale);
-    void getCharVertices(char c, float x, float y, float scale, float* vertices);
+    bool buildAtlas();
+    const TextRun& findOrLayoutRun(const char* text, size_t length, float scale) const;
+    void layoutRun(const char* text, size_t length, float scale, TextRun& run) const;
+    // Writes the white quad of a code point's glyph at the pen position and
+    // advances the pen; false when the glyph draws nothing
+    bool buildCodepointQuad(uint32_t codepoint, float& penX, float scale, BatchVertex* quad) const;
+    float getCodepointAdvance(uint32_t codepoint, float scale) const;
+    // Bitmap font glyph at (x, 0)
+    bool buildGlyphQuad(int glyph, float x, float scale, BatchVertex* quad) const;
+    float getAdvance(float scale) const { return m_charWidth * scale * 1.2f; }
+    // Font asset pixels to screen pixels: the cap height maps onto m_charHeight
+    float getAssetScale(float scale) const;
 };
 
 #endif // TEXT_RENDERER_H
@@ -0,0 +1,79 @@
+#include "TextRunCache.h"
+#include <cstring>
+#include <iterator>
+
+TextRunCache::TextRunCache(size_t capacity)
+    : m_capacity(capacity > 0 ? capacity : 1)
+{
+    m_index.reserve(m_capacity);
+}
+
+uint64_t TextRunCache::hashKey(const char* text, size_t length, float scale, uint32_t font) {
+    // FNV-1a over the bytes, then the scale's bit pattern and the font
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ (uint8_t)text[i]) * 1099511628211ULL;
+    }
+    
+    uint32_t scaleBits;
+    std::memcpy(&scaleBits, &scale, sizeof(scaleBits));
+    hash = (hash ^ scaleBits) * 1099511628211ULL;
+    hash = (hash ^ font) * 1099511628211ULL;
+    return hash;
+}
+
+const TextRun* TextRunCache::find(const char* text, size_t length, float scale, uint32_t font) {
+    uint64_t hash = hashKey(text, length, scale, font);
+    std::unordered_map<uint64_t, EntryList::iterator>::iterator it = m_index.find(hash);
+    if (it == m_index.end()) {
+        m_stats.misses++;
+        return nullptr;
+    }
+    
+    Entry& entry = *it->second;
+    // A 64-bit collision is treated as a miss; insert then replaces the entry
+    if (entry.scale != scale || entry.font != font || entry.text.size() != length ||
+        std::memcmp(entry.text.data(), text, length) != 0) {
+        m_stats.misses++;
+        return nullptr;
+    }
+    
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    m_stats.hits++;
+    return &entry.run;
+}
+
+TextRun* TextRunCache::insert(const char* text, size_t length, float scale, uint32_t font) {
+    uint64_t hash = hashKey(text, length, scale, font);
+    
+    EntryList::iterator slot;
+    std::unordered_map<uint64_t, EntryList::iterator>::iterator existing = m_index.find(hash);
+    if (existing != m_index.end()) {
+        slot = existing->second;
+        m_index.erase(existing);
+    } else if (m_index.size() >= m_capacity) {
+        // Recycle the least recently used entry together with its buffers
+        slot = std::prev(m_entries.end());
+        m_index.erase(slot->hash);
+        m_stats.evictions++;
+    } else {
+        m_entries.push_back(Entry());
+        slot = std::prev(m_entries.end());
+    }
+    
+    m_entries.splice(m_entries.begin(), m_entries, slot);
+    slot->hash = hash;
+    slot->text.assign(text, length);
+    slot->scale = scale;
+    slot->font = font;
+    slot->run.quads.clear();
+    slot->run.width = 0.0f;
+    slot->run.height = 0.0f;
+    m_index[hash] = slot;
+    return &slot->run;
+}
+
+void TextRunCache::clear() {
+    m_index.clear();
+    m_entries.clear();
+}
@@ -0,0 +1,71 @@
+#ifndef TEXT_RUN_CACHE_H
+#define TEXT_RUN_CACHE_H
+
+#include "RenderBackend.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Laid-out text: glyph quads relative to the run's top-left corner, in white.
+// Renderer::drawQuadRun places and colors them while copying into the batch.
+struct TextRun {
+    std::vector<BatchVertex> quads;
+    float width;
+    float height;
+    
+    TextRun() : width(0.0f), height(0.0f) {}
+    int getQuadCount() const { return (int)(quads.size() / 4); }
+};
+
+struct TextRunCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    
+    TextRunCacheStats() : hits(0), misses(0), evictions(0) {}
+};
+
+// LRU cache of text runs keyed by string content, scale and font. Lookups
+// hash the bytes in place and allocate nothing; only a miss that needs a new
+// entry touches the heap, and an evicted entry's buffers are reused.
+class TextRunCache {
+public:
+    static const size_t DEFAULT_CAPACITY = 256;
+    
+    explicit TextRunCache(size_t capacity = DEFAULT_CAPACITY);
+    
+    // The cached run, or nullptr. A hit makes the entry the most recently used.
+    // Pointers stay valid until the entry is evicted or the cache cleared.
+    const TextRun* find(const char* text, size_t length, float scale, uint32_t font);
+    // An empty run for the key, to be filled in by the caller; evicts the least
+    // recently used entry when the cache is full
+    TextRun* insert(const char* text, size_t length, float scale, uint32_t font);
+    
+    void clear();
+    size_t size() const { return m_index.size(); }
+    size_t getCapacity() const { return m_capacity; }
+    
+    const TextRunCacheStats& getStats() const { return m_stats; }
+    
+private:
+    struct Entry {
+        uint64_t hash;
+        std::string text;
+        float scale;
+        uint32_t font;
+        TextRun run;
+    };
+    typedef std::list<Entry> EntryList;
+    
+    size_t m_capacity;
+    EntryList m_entries; // most recently used first
+    std::unordered_map<uint64_t, EntryList::iterator> m_index;
+    TextRunCacheStats m_stats;
+    
+    static uint64_t hashKey(const char* text, size_t length, float scale, uint32_t font);
+};
+
+#endif // TEXT_RUN_CACHE_H
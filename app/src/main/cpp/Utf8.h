@@ -0,0 +1,63 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstddef>
+#include <cstdint>
+
+static const uint32_t UTF8_REPLACEMENT_CHARACTER = 0xFFFD;
+
+// Decodes the code point starting at text[offset] and advances offset past
+// it. ASCII takes the first branch only. Malformed or truncated sequences,
+// overlong forms and surrogates yield U+FFFD and consume a single byte, so
+// decoding always makes progress.
+inline uint32_t decodeUtf8(const char* text, size_t length, size_t& offset) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(text) + offset;
+    uint8_t lead = bytes[0];
+    if (lead < 0x80) {
+        offset += 1;
+        return lead;
+    }
+    
+    size_t available = length - offset;
+    uint32_t codepoint;
+    size_t count;
+    uint32_t minimum;
+    if ((lead & 0xE0) == 0xC0) {
+        codepoint = lead & 0x1F;
+        count = 2;
+        minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        codepoint = lead & 0x0F;
+        count = 3;
+        minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        codepoint = lead & 0x07;
+        count = 4;
+        minimum = 0x10000;
+    } else {
+        offset += 1;
+        return UTF8_REPLACEMENT_CHARACTER;
+    }
+    
+    if (available < count) {
+        offset += 1;
+        return UTF8_REPLACEMENT_CHARACTER;
+    }
+    for (size_t i = 1; i < count; ++i) {
+        if ((bytes[i] & 0xC0) != 0x80) {
+            offset += 1;
+            return UTF8_REPLACEMENT_CHARACTER;
+        }
+        codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+    }
+    
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        offset += 1;
+        return UTF8_REPLACEMENT_CHARACTER;
+    }
+    
+    offset += count;
+    return codepoint;
+}
+
+#endif // UTF8_H
@@ -0,0 +1,226 @@
+#include "WidgetStore.h"
+#include "Renderer.h"
+#include "TextRenderer.h"
+#include "Scene.h"
+
+static const float WIDGET_CORNER_RADIUS = 8.0f;
+static const uint32_t WIDGET_SLOT_MASK = 0xFFFF;
+
+WidgetStore::WidgetStore()
+    : m_liveCount(0)
+{
+}
+
+WidgetHandle WidgetStore::create(SceneNode* node) {
+    int slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = (int)m_flags.size();
+        m_flags.push_back(0);
+        m_nodes.push_back(nullptr);
+        m_x.push_back(0.0f);
+        m_y.push_back(0.0f);
+        m_width.push_back(0.0f);
+        m_height.push_back(0.0f);
+        m_colors.push_back(WidgetColor());
+        m_pressedColors.push_back(WidgetColor());
+        m_textColors.push_back(WidgetColor());
+        m_textScales.push_back(0.0f);
+        m_highlights.push_back(0.0f);
+        m_labels.push_back(-1);
+        m_generations.push_back(1);
+    }
+    
+    m_flags[slot] = FLAG_LIVE;
+    m_nodes[slot] = node;
+    m_x[slot] = 0.0f;
+    m_y[slot] = 0.0f;
+    m_width[slot] = 100.0f;
+    m_height[slot] = 50.0f;
+    m_colors[slot] = WidgetColor{ 0.3f, 0.3f, 0.3f, 1.0f };
+    m_pressedColors[slot] = WidgetColor{ 0.5f, 0.5f, 0.5f, 1.0f };
+    m_textColors[slot] = WidgetColor{ 1.0f, 1.0f, 1.0f, 1.0f };
+    m_textScales[slot] = 1.0f;
+    m_highlights[slot] = 0.0f;
+    m_labels[slot] = -1;
+    m_liveCount++;
+    invalidate(slot);
+    return (WidgetHandle)m_generations[slot] << 16 | (WidgetHandle)slot;
+}
+
+void WidgetStore::destroy(WidgetHandle widget) {
+    int slot = slotOf(widget);
+    if (slot < 0) {
+        return;
+    }
+    
+    invalidate(slot);
+    m_flags[slot] = 0;
+    m_nodes[slot] = nullptr;
+    // Generation 0 would let a stale handle compare equal to WIDGET_NONE's
+    m_generations[slot] = m_generations[slot] == 0xFFFF ? 1 : m_generations[slot] + 1;
+    m_freeSlots.push_back(slot);
+    m_liveCount--;
+}
+
+int WidgetStore::slotOf(WidgetHandle widget) const {
+    size_t slot = widget & WIDGET_SLOT_MASK;
+    if (slot >= m_flags.size() || !(m_flags[slot] & FLAG_LIVE) || m_generations[slot] != widget >> 16) {
+        return -1;
+    }
+    return (int)slot;
+}
+
+void WidgetStore::setBounds(WidgetHandle widget, float x, float y, float width, float height) {
+    int slot = slotOf(widget);
+    if (slot < 0 || (x == m_x[slot] && y == m_y[slot] && width == m_width[slot] && height == m_height[slot])) {
+        return;
+    }
+    
+    m_x[slot] = x;
+    m_y[slot] = y;
+    m_width[slot] = width;
+    m_height[slot] = height;
+    invalidate(slot);
+}
+
+void WidgetStore::setLabel(WidgetHandle widget, const std::string& text) {
+    int slot = slotOf(widget);
+    if (slot < 0) {
+        return;
+    }
+    
+    int label = -1;
+    if (!text.empty()) {
+        for (size_t i = 0; i < m_labelTexts.size(); ++i) {
+            if (m_labelTexts[i] == text) {
+                label = (int)i;
+                break;
+            }
+        }
+        if (label < 0) {
+            label = (int)m_labelTexts.size();
+            m_labelTexts.push_back(text);
+        }
+    }
+    m_labels[slot] = label;
+    invalidate(slot);
+}
+
+void WidgetStore::setColor(WidgetHandle widget, float r, float g, float b, float a) {
+    int slot = slotOf(widget);
+    if (slot >= 0) {
+        m_colors[slot] = WidgetColor{ r, g, b, a };
+        invalidate(slot);
+    }
+}
+
+void WidgetStore::setPressedColor(WidgetHandle widget, float r, float g, float b, float a) {
+    int slot = slotOf(widget);
+    if (slot >= 0) {
+        m_pressedColors[slot] = WidgetColor{ r, g, b, a };
+        invalidate(slot);
+    }
+}
+
+void WidgetStore::setTextColor(WidgetHandle widget, float r, float g, float b, float a) {
+    int slot = slotOf(widget);
+    if (slot >= 0) {
+        m_textColors[slot] = WidgetColor{ r, g, b, a };
+        invalidate(slot);
+    }
+}
+
+void WidgetStore::setTextScale(WidgetHandle widget, float scale) {
+    int slot = slotOf(widget);
+    if (slot >= 0) {
+        m_textScales[slot] = scale;
+        invalidate(slot);
+    }
+}
+
+void WidgetStore::setHighlight(WidgetHandle widget, float level) {
+    int slot = slotOf(widget);
+    if (slot >= 0 && m_highlights[slot] != level) {
+        m_highlights[slot] = level;
+        invalidate(slot);
+    }
+}
+
+float WidgetStore::getHighlight(WidgetHandle widget) const {
+    int slot = slotOf(widget);
+    return slot >= 0 ? m_highlights[slot] : 0.0f;
+}
+
+void WidgetStore::setHovered(WidgetHandle widget, bool hovered) {
+    int slot = slotOf(widget);
+    if (slot >= 0) {
+        setFlag(slot, FLAG_HOVERED, hovered);
+    }
+}
+
+bool WidgetStore::isHovered(WidgetHandle widget) const {
+    int slot = slotOf(widget);
+    return slot >= 0 && (m_flags[slot] & FLAG_HOVERED);
+}
+
+void WidgetStore::setFlag(int slot, uint8_t flag, bool set) {
+    uint8_t flags = set ? (uint8_t)(m_flags[slot] | flag) : (uint8_t)(m_flags[slot] & ~flag);
+    if (flags != m_flags[slot]) {
+        m_flags[slot] = flags;
+        invalidate(slot);
+    }
+}
+
+void WidgetStore::invalidate(int slot) {
+    if (m_nodes[slot]) {
+        m_nodes[slot]->invalidate();
+    }
+}
+
+void WidgetStore::render(Renderer* renderer, TextRenderer* textRenderer, const SceneNode* node) const {
+    if (!renderer) return;
+    
+    size_t count = m_flags.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (m_nodes[i] != node || !(m_flags[i] & FLAG_LIVE)) {
+            continue;
+        }
+        
+        // Hovered sits at least halfway to the pressed color
+        float level = m_highlights[i];
+        if ((m_flags[i] & FLAG_HOVERED) && level < 0.5f) {
+            level = 0.5f;
+        }
+        WidgetColor color = m_colors[i];
+        if (level >= 1.0f) {
+            color = m_pressedColors[i];
+        } else if (level > 0.0f) {
+            const WidgetColor& pressed = m_pressedColors[i];
+            color.r += (pressed.r - color.r) * level;
+            color.g += (pressed.g - color.g) * level;
+            color.b += (pressed.b - color.b) * level;
+            color.a += (pressed.a - color.a) * level;
+        }
+        renderer->drawRoundedRect(m_x[i], m_y[i], m_width[i], m_height[i], WIDGET_CORNER_RADIUS,
+                                  color.r, color.g, color.b, color.a);
+    }
+    
+    if (!textRenderer) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (m_nodes[i] != node || !(m_flags[i] & FLAG_LIVE) || m_labels[i] < 0) {
+            continue;
+        }
+        
+        // One cache lookup both measures and draws the label
+        const TextRun& run = textRenderer->getTextRun(m_labelTexts[m_labels[i]], m_textScales[i]);
+        float textX = m_x[i] + (m_width[i] - run.width) / 2.0f;
+        float textY = m_y[i] + (m_height[i] - run.height) / 2.0f;
+        const WidgetColor& text = m_textColors[i];
+        textRenderer->drawTextRun(textX, textY, run, text.r, text.g, text.b, text.a);
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef WIDGET_STORE_H
+#define WIDGET_STORE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Renderer;
+class TextRenderer;
+class SceneNode;
+
+// Stable handle to a widget: its slot in the low 16 bits, the slot's
+// generation above them, so a handle to a destroyed widget stays invalid
+// after the slot is reused
+typedef uint32_t WidgetHandle;
+static const WidgetHandle WIDGET_NONE = 0;
+
+struct WidgetColor {
+    float r, g, b, a;
+};
+
+// Buttons kept as parallel arrays, one entry per slot: drawing a node's
+// widgets walks the node and flag arrays without touching the rest.
+// Every widget belongs to the scene node that draws it; changing its look
+// invalidates that node.
+class WidgetStore {
+public:
+    WidgetStore();
+    
+    WidgetHandle create(SceneNode* node);
+    void destroy(WidgetHandle widget);
+    bool isValid(WidgetHandle widget) const { return slotOf(widget) >= 0; }
+    size_t getCount() const { return m_liveCount; }
+    
+    void setBounds(WidgetHandle widget, float x, float y, float width, float height);
+    // Labels are interned; widgets sharing a text share one label
+    void setLabel(WidgetHandle widget, const std::string& text);
+    void setColor(WidgetHandle widget, float r, float g, float b, float a);
+    void setPressedColor(WidgetHandle widget, float r, float g, float b, float a);
+    void setTextColor(WidgetHandle widget, float r, float g, float b, float a);
+    void setTextScale(WidgetHandle widget, float scale);
+    
+    // How far the background has moved to the pressed color: 0 at rest, 1
+    // pressed; animated in between
+    void setHighlight(WidgetHandle widget, float level);
+    float getHighlight(WidgetHandle widget) const;
+    // Touch resting on the widget before it counts as a press; shows at least
+    // half the highlight
+    void setHovered(WidgetHandle widget, bool hovered);
+    bool isHovered(WidgetHandle widget) const;
+    
+    // Draws all widgets of the node in one pass: backgrounds, then labels
+    void render(Renderer* renderer, TextRenderer* textRenderer, const SceneNode* node) const;
+    
+private:
+    enum {
+        FLAG_LIVE = 1 << 0,
+        FLAG_HOVERED = 1 << 1
+    };
+    
+    std::vector<uint8_t> m_flags;
+    std::vector<SceneNode*> m_nodes;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_width;
+    std::vector<float> m_height;
+    std::vector<WidgetColor> m_colors;
+    std::vector<WidgetColor> m_pressedColors;
+    std::vector<WidgetColor> m_textColors;
+    std::vector<float> m_textScales;
+    std::vector<float> m_highlights;
+    std::vector<int> m_labels;  // index into m_labelTexts, -1 without a label
+    std::vector<uint16_t> m_generations;
+    std::vector<int> m_freeSlots;
+    size_t m_liveCount;
+    
+    std::vector<std::string> m_labelTexts;
+    
+    int slotOf(WidgetHandle widget) const;
+    void setFlag(int slot, uint8_t flag, bool set);
+    void invalidate(int slot);
+};
+
+#endif // WIDGET_STORE_H
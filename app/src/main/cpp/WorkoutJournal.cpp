@@ -0,0 +1,848 @@
+#include "WorkoutJournal.h"
+#include "HistoryFile.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "WorkoutJournal", __VA_ARGS__))
+#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "WorkoutJournal", __VA_ARGS__))
+
+// Defaults: a group waits at most this long for company before its fdatasync
+static const int COMMIT_WINDOW_MS = 20;
+static const size_t COMPACTION_BYTES = 256 * 1024;
+// A group that failed to commit waits this long before the thread retries it
+// on its own; flush() retries at once
+static const int COMMIT_RETRY_MS = 1000;
+// Bigger records are corrupt, whatever their checksum says
+static const uint32_t MAX_PAYLOAD = 64 * 1024;
+static const uint32_t MAX_SETS = 1000;
+static const size_t RECORD_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+static const char* const LOG_FILE = "journal.log";
+static const char* const CHECKPOINT_FILE = "journal.chk";
+static const char* const ARCHIVE_FILE = "history.dat";
+static const char* const HISTORY_FILE = "history.wth";
+// Appended to files that recovery had to give up on; they are kept for inspection
+static const char* const DAMAGED_SUFFIX = ".bad";
+
+struct Crc32Table {
+    uint32_t entries[256];
+    
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+static uint32_t crc32(const uint8_t* data, size_t length) {
+    // Built once, thread-safely, by whichever thread checksums first
+    static const Crc32Table table;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static void putBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+static void putU32(std::vector<uint8_t>& out, uint32_t value) { putBytes(out, &value, sizeof(value)); }
+static void putI64(std::vector<uint8_t>& out, int64_t value) { putBytes(out, &value, sizeof(value)); }
+static void putF32(std::vector<uint8_t>& out, float value) { putBytes(out, &value, sizeof(value)); }
+
+static void putString(std::vector<uint8_t>& out, const std::string& value) {
+    putU32(out, (uint32_t)value.size());
+    putBytes(out, value.data(), value.size());
+}
+
+// Length, checksum, then the type byte and payload in body
+static void frameRecord(std::vector<uint8_t>& out, const std::vector<uint8_t>& body) {
+    putU32(out, (uint32_t)(body.size() - 1));
+    putU32(out, crc32(body.data(), body.size()));
+    putBytes(out, body.data(), body.size());
+}
+
+// Bounds-checked payload reads; a short payload leaves ok false
+struct PayloadReader {
+    const uint8_t* data;
+    size_t length;
+    size_t offset;
+    bool ok;
+    
+    PayloadReader(const uint8_t* d, size_t l) : data(d), length(l), offset(0), ok(true) {}
+    
+    void get(void* value, size_t size) {
+        if (!ok || length - offset < size) {
+            ok = false;
+            std::memset(value, 0, size);
+            return;
+        }
+        std::memcpy(value, data + offset, size);
+        offset += size;
+    }
+    uint32_t getU32() { uint32_t value; get(&value, sizeof(value)); return value; }
+    int64_t getI64() { int64_t value; get(&value, sizeof(value)); return value; }
+    float getF32() { float value; get(&value, sizeof(value)); return value; }
+    std::string getString() {
+        uint32_t size = getU32();
+        if (!ok || length - offset < size) {
+            ok = false;
+            return std::string();
+        }
+        std::string value((const char*)data + offset, size);
+        offset += size;
+        return value;
+    }
+};
+
+// Applies one record (type byte and payload); records that do not fit the
+// state, such as a set of a missing exercise, change nothing
+static bool applyRecord(const uint8_t* body, size_t length, std::vector<JournalWorkout>& finished,
+                        JournalWorkout& current) {
+    PayloadReader reader(body + 1, length - 1);
+    switch (body[0]) {
+        case JOURNAL_START_WORKOUT: {
+            int64_t startMs = reader.getI64();
+            std::string name = reader.getString();
+            if (!reader.ok) return false;
+            // Like the tracker, a new workout replaces one that never ended
+            current = JournalWorkout();
+            current.name = name;
+            current.startMs = startMs;
+            current.active = true;
+            return true;
+        }
+        case JOURNAL_ADD_EXERCISE: {
+            uint32_t sets = reader.getU32();
+            JournalExercise exercise;
+            exercise.defaultReps = (int)reader.getU32();
+            exercise.defaultWeight = reader.getF32();
+            exercise.restTime = (int)reader.getU32();
+            exercise.name = reader.getString();
+            if (!reader.ok || !current.active || sets > MAX_SETS) return false;
+            JournalSet set = { exercise.defaultReps, exercise.defaultWeight, false };
+            exercise.sets.assign(sets, set);
+            current.exercises.push_back(exercise);
+            return true;
+        }
+        case JOURNAL_ADD_SET: {
+            uint32_t index = reader.getU32();
+            JournalSet set = { (int)reader.getU32(), reader.getF32(), false };
+            if (!reader.ok || !current.active || index >= current.exercises.size() ||
+                current.exercises[index].sets.size() >= MAX_SETS) {
+                return false;
+            }
+            current.exercises[index].sets.push_back(set);
+            return true;
+        }
+        case JOURNAL_SET_REPS:
+        case JOURNAL_COMPLETE_SET: {
+            uint32_t index = reader.getU32();
+            uint32_t setIndex = reader.getU32();
+            uint32_t reps = body[0] == JOURNAL_SET_REPS ? reader.getU32() : 0;
+            if (!reader.ok || !current.active || index >= current.exercises.size() ||
+                setIndex >= current.exercises[index].sets.size()) {
+                return false;
+            }
+            JournalSet& set = current.exercises[index].sets[setIndex];
+            if (body[0] == JOURNAL_SET_REPS) {
+                set.reps = (int)reps;
+            } else {
+                set.completed = true;
+            }
+            return true;
+        }
+        case JOURNAL_END_WORKOUT: {
+            int64_t endMs = reader.getI64();
+            if (!reader.ok || !current.active) return false;
+            current.endMs = endMs;
+            current.active = false;
+            finished.push_back(JournalWorkout());
+            finished.back().name.swap(current.name);
+            finished.back().startMs = current.startMs;
+            finished.back().endMs = current.endMs;
+            finished.back().exercises.swap(current.exercises);
+            current = JournalWorkout();
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+// Replays framed records; returns the length of the intact prefix
+static size_t replayRecords(const uint8_t* data, size_t length, std::vector<JournalWorkout>& finished,
+                            JournalWorkout& current, size_t& records) {
+    size_t offset = 0;
+    while (length - offset >= RECORD_HEADER_SIZE + 1) {
+        uint32_t payloadLength;
+        uint32_t crc;
+        std::memcpy(&payloadLength, data + offset, sizeof(payloadLength));
+        std::memcpy(&crc, data + offset + sizeof(payloadLength), sizeof(crc));
+        const uint8_t* body = data + offset + RECORD_HEADER_SIZE;
+        if (payloadLength > MAX_PAYLOAD || length - offset - RECORD_HEADER_SIZE < payloadLength + 1 ||
+            crc32(body, payloadLength + 1) != crc) {
+            break;
+        }
+        
+        applyRecord(body, payloadLength + 1, finished, current);
+        records++;
+        offset += RECORD_HEADER_SIZE + payloadLength + 1;
+    }
+    return offset;
+}
+
+// The records that rebuild the workout: sets one by one, so edits collapse
+static void encodeWorkout(const JournalWorkout& workout, std::vector<uint8_t>& out) {
+    std::vector<uint8_t> body;
+    body.push_back(JOURNAL_START_WORKOUT);
+    putI64(body, workout.startMs);
+    putString(body, workout.name);
+    frameRecord(out, body);
+    
+    for (size_t i = 0; i < workout.exercises.size(); ++i) {
+        const JournalExercise& exercise = workout.exercises[i];
+        body.assign(1, JOURNAL_ADD_EXERCISE);
+        putU32(body, 0);
+        putU32(body, (uint32_t)exercise.defaultReps);
+        putF32(body, exercise.defaultWeight);
+        putU32(body, (uint32_t)exercise.restTime);
+        putString(body, exercise.name);
+        frameRecord(out, body);
+        
+        for (size_t j = 0; j < exercise.sets.size(); ++j) {
+            body.assign(1, JOURNAL_ADD_SET);
+            putU32(body, (uint32_t)i);
+            putU32(body, (uint32_t)exercise.sets[j].reps);
+            putF32(body, exercise.sets[j].weight);
+            frameRecord(out, body);
+            if (exercise.sets[j].completed) {
+                body.assign(1, JOURNAL_COMPLETE_SET);
+                putU32(body, (uint32_t)i);
+                putU32(body, (uint32_t)j);
+                frameRecord(out, body);
+            }
+        }
+    }
+    
+    if (!workout.active) {
+        body.assign(1, JOURNAL_END_WORKOUT);
+        putI64(body, workout.endMs);
+        frameRecord(out, body);
+    }
+}
+
+static bool writeAll(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = ::write(fd, data, length);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+static bool readFile(const std::string& path, std::vector<uint8_t>& data) {
+    data.clear();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0;
+    if (ok) {
+        data.resize((size_t)info.st_size);
+        size_t offset = 0;
+        while (ok && offset < data.size()) {
+            ssize_t count = ::read(fd, data.data() + offset, data.size() - offset);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            ok = count > 0;
+            offset += ok ? (size_t)count : 0;
+        }
+    }
+    ::close(fd);
+    return ok;
+}
+
+// Renames are durable only once the directory entry is
+static void syncDirectory(const std::string& directory) {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+}
+
+// Writes a whole file next to path and renames it over path
+static bool replaceFile(const std::string& directory, const std::string& path, const std::vector<uint8_t>& data) {
+    std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = writeAll(fd, data.data(), data.size()) && fdatasync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    ok = ok && ::rename(temporary.c_str(), path.c_str()) == 0;
+    if (ok) {
+        syncDirectory(directory);
+    }
+    return ok;
+}
+
+// Renames a file out of the journal's way, keeping its contents
+static bool setAside(const std::string& directory, const std::string& path) {
+    if (::access(path.c_str(), F_OK) != 0) {
+        return true;
+    }
+    if (::rename(path.c_str(), (path + DAMAGED_SUFFIX).c_str()) != 0) {
+        return false;
+    }
+    syncDirectory(directory);
+    return true;
+}
+
+static bool readCheckpoint(const std::string& path, JournalCheckpointHeader& header, std::vector<uint8_t>& state) {
+    std::memset(&header, 0, sizeof(header));
+    std::vector<uint8_t> data;
+    if (!readFile(path, data) || data.size() < sizeof(header)) {
+        return false;
+    }
+    
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != JOURNAL_CHECKPOINT_MAGIC || header.version != JOURNAL_VERSION ||
+        data.size() != sizeof(header) + header.stateLength ||
+        crc32(data.data() + sizeof(header), header.stateLength) != header.stateCrc) {
+        std::memset(&header, 0, sizeof(header));
+        return false;
+    }
+    state.assign(data.begin() + sizeof(header), data.end());
+    return true;
+}
+
+WorkoutJournal::WorkoutJournal()
+    : m_logFd(-1)
+    , m_archiveFd(-1)
+    , m_commitWindowMs(COMMIT_WINDOW_MS)
+    , m_compactionBytes(COMPACTION_BYTES)
+    , m_generation(0)
+    , m_archivedWorkouts(0)
+    , m_archiveBytes(0)
+    , m_logBytes(0)
+    , m_historyStale(false)
+    , m_logDirty(false)
+    , m_appended(0)
+    , m_durable(0)
+    , m_failedCommits(0)
+    , m_flushRequested(false)
+    , m_stopping(false)
+{
+}
+
+WorkoutJournal::~WorkoutJournal() {
+    close();
+}
+
+std::string WorkoutJournal::getPath(const char* name) const {
+    return m_directory + "/" + name;
+}
+
+bool WorkoutJournal::open(const std::string& directory, JournalRecovery& recovery) {
+    close();
+    recovery = JournalRecovery();
+    m_directory = directory;
+    if (::mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+        LOGE("Cannot create journal directory %s", directory.c_str());
+        return false;
+    }
+    
+    // The checkpoint: where the archive ends and the workout then in progress
+    JournalCheckpointHeader checkpoint;
+    std::vector<uint8_t> data;
+    bool checkpointed = readCheckpoint(getPath(CHECKPOINT_FILE), checkpoint, data);
+    if (checkpointed) {
+        replayRecords(data.data(), data.size(), m_state.finished, m_state.current, recovery.recordsReplayed);
+    }
+    m_generation = checkpoint.generation;
+    m_archivedWorkouts = checkpoint.archivedWorkouts;
+    m_archiveBytes = checkpoint.archiveBytes;
+    
+    // Archive bytes past the checkpoint are from a compaction that never
+    // finished; the log still holds them
+    m_archiveFd = ::open(getPath(ARCHIVE_FILE).c_str(), O_RDWR | O_CREAT, 0600);
+    struct stat info;
+    if (m_archiveFd < 0 || fstat(m_archiveFd, &info) != 0) {
+        LOGE("Cannot open journal archive");
+        close();
+        return false;
+    }
+    uint64_t archiveLength = sizeof(JournalFileHeader) + m_archiveBytes;
+    bool recount = false;
+    if (!checkpointed && (::access(getPath(CHECKPOINT_FILE).c_str(), F_OK) == 0 ||
+                          (uint64_t)info.st_size > sizeof(JournalFileHeader))) {
+        // A checkpoint is damaged or lost: neither the archive's committed
+        // length nor the state the log continues is known. Both files are
+        // kept, and the journal starts over from the archive's whole workouts.
+        LOGE("Invalid or missing journal checkpoint, recovering from the archive");
+        if (!setAside(m_directory, getPath(CHECKPOINT_FILE)) || !setAside(m_directory, getPath(LOG_FILE))) {
+            LOGE("Cannot set the journal checkpoint aside");
+            close();
+            return false;
+        }
+        checkpoint.magic = JOURNAL_CHECKPOINT_MAGIC;
+        checkpoint.version = JOURNAL_VERSION;
+        checkpoint.stateCrc = crc32(nullptr, 0);
+        recount = true;
+    } else if (m_archiveBytes > 0 && (uint64_t)info.st_size < archiveLength) {
+        LOGE("Journal archive is shorter than its checkpoint, recounting it");
+        recount = true;
+    }
+    if (recount) {
+        // Keep the whole workouts that are left and make the checkpoint agree
+        std::vector<uint8_t> archive;
+        std::vector<JournalWorkout> workouts;
+        JournalWorkout partial;
+        size_t records = 0;
+        if (readFile(getPath(ARCHIVE_FILE), archive) && archive.size() > sizeof(JournalFileHeader)) {
+            replayRecords(archive.data() + sizeof(JournalFileHeader), archive.size() - sizeof(JournalFileHeader),
+                          workouts, partial, records);
+        }
+        // The archive holds exactly these records, so their length is its own
+        std::vector<uint8_t> whole;
+        for (size_t i = 0; i < workouts.size(); ++i) {
+            encodeWorkout(workouts[i], whole);
+        }
+        // Whatever follows them is cut below; a copy of the archive keeps it
+        if (archive.size() > sizeof(JournalFileHeader) + whole.size() &&
+            !replaceFile(m_directory, getPath(ARCHIVE_FILE) + DAMAGED_SUFFIX, archive)) {
+            LOGE("Cannot keep a copy of the journal archive");
+            close();
+            return false;
+        }
+        m_archiveBytes = whole.size();
+        m_archivedWorkouts = (uint32_t)workouts.size();
+        archiveLength = sizeof(JournalFileHeader) + m_archiveBytes;
+        
+        checkpoint.archivedWorkouts = m_archivedWorkouts;
+        checkpoint.archiveBytes = m_archiveBytes;
+        std::vector<uint8_t> file;
+        putBytes(file, &checkpoint, sizeof(checkpoint));
+        putBytes(file, data.data(), data.size());
+        if (!replaceFile(m_directory, getPath(CHECKPOINT_FILE), file)) {
+            LOGE("Cannot correct journal checkpoint");
+        }
+    }
+    if ((uint64_t)info.st_size != archiveLength || info.st_size == 0) {
+        JournalFileHeader header = { JOURNAL_ARCHIVE_MAGIC, JOURNAL_VERSION, 0, 0 };
+        if (ftruncate(m_archiveFd, (off_t)archiveLength) != 0 || pwrite(m_archiveFd, &header, sizeof(header), 0) !=
+            (ssize_t)sizeof(header) || fdatasync(m_archiveFd) != 0) {
+            LOGE("Cannot prepare journal archive");
+            close();
+            return false;
+        }
+    }
+    
+    // The log continues the checkpoint only if it has the same generation; an
+    // older one was folded into the checkpoint before the crash
+    bool replayed = false;
+    if (readFile(getPath(LOG_FILE), data) && data.size() >= sizeof(JournalFileHeader)) {
+        JournalFileHeader header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.magic == JOURNAL_LOG_MAGIC && header.version == JOURNAL_VERSION && header.generation == m_generation) {
+            size_t intact = replayRecords(data.data() + sizeof(header), data.size() - sizeof(header),
+                                          m_state.finished, m_state.current, recovery.recordsReplayed);
+            recovery.tornBytes = data.size() - sizeof(header) - intact;
+            m_logFd = ::open(getPath(LOG_FILE).c_str(), O_WRONLY | O_APPEND);
+            if (m_logFd >= 0 && recovery.tornBytes > 0) {
+                LOGI("Cutting %zu bytes of torn journal tail", recovery.tornBytes);
+                if (ftruncate(m_logFd, (off_t)(sizeof(header) + intact)) != 0 || fdatasync(m_logFd) != 0) {
+                    LOGE("Cannot cut torn journal tail");
+                }
+            }
+            m_logBytes = intact;
+            replayed = m_logFd >= 0;
+        }
+    }
+    if (!replayed && !startLog(m_generation)) {
+        LOGE("Cannot start journal log");
+        close();
+        return false;
+    }
+    
+    // A crash between a checkpoint and its history rewrite leaves it behind
+    HistoryFile history;
+    m_historyStale = m_archivedWorkouts > 0 &&
+                     (!history.openFile(getHistoryPath(directory).c_str()) || history.getWorkoutCount() != m_archivedWorkouts);
+    history.close();
+    
+    recovery.archivedWorkouts = m_archivedWorkouts;
+    recovery.finished = m_state.finished;
+    recovery.current = m_state.current;
+    
+    m_pending.clear();
+    m_appended = 0;
+    m_durable = 0;
+    m_failedCommits = 0;
+    m_retryAt = Clock::time_point();
+    m_logDirty = false;
+    m_flushRequested = false;
+    m_stopping = false;
+    m_stats = JournalStats();
+    m_thread = std::thread(&WorkoutJournal::run, this);
+    
+    LOGI("Journal recovered: %u archived workouts, %zu since, %zu records replayed%s", m_archivedWorkouts,
+         recovery.finished.size(), recovery.recordsReplayed, recovery.current.active ? ", workout in progress" : "");
+    return true;
+}
+
+void WorkoutJournal::close() {
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+    
+    if (m_logFd >= 0) {
+        ::close(m_logFd);
+    }
+    if (m_archiveFd >= 0) {
+        ::close(m_archiveFd);
+    }
+    m_logFd = -1;
+    m_archiveFd = -1;
+    m_generation = 0;
+    m_archivedWorkouts = 0;
+    m_archiveBytes = 0;
+    m_logBytes = 0;
+    m_state = State();
+    m_pending.clear();
+}
+
+bool WorkoutJournal::startLog(uint32_t generation) {
+    std::vector<uint8_t> header;
+    JournalFileHeader fileHeader = { JOURNAL_LOG_MAGIC, JOURNAL_VERSION, generation, 0 };
+    putBytes(header, &fileHeader, sizeof(fileHeader));
+    if (!replaceFile(m_directory, getPath(LOG_FILE), header)) {
+        return false;
+    }
+    
+    int fd = ::open(getPath(LOG_FILE).c_str(), O_WRONLY | O_APPEND);
+    if (fd < 0) {
+        return false;
+    }
+    if (m_logFd >= 0) {
+        ::close(m_logFd);
+    }
+    m_logFd = fd;
+    m_logBytes = 0;
+    m_logDirty = false;
+    return true;
+}
+
+void WorkoutJournal::beginRecord(JournalRecordType type) {
+    m_record.assign(1, (uint8_t)type);
+}
+
+void WorkoutJournal::endRecord() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) {
+        return;
+    }
+    
+    if (m_pending.empty()) {
+        m_pendingSince = Clock::now();
+    }
+    frameRecord(m_pending, m_record);
+    // The checkpoint state always matches the queued records
+    applyRecord(m_record.data(), m_record.size(), m_state.finished, m_state.current);
+    m_appended++;
+    m_stats.records++;
+    m_wake.notify_one();
+}
+
+void WorkoutJournal::startWorkout(const std::string& name, int64_t startMs) {
+    beginRecord(JOURNAL_START_WORKOUT);
+    putI64(m_record, startMs);
+    putString(m_record, name);
+    endRecord();
+}
+
+void WorkoutJournal::addExercise(const std::string& name, int sets, int reps, float weight, int restTime) {
+    beginRecord(JOURNAL_ADD_EXERCISE);
+    putU32(m_record, (uint32_t)sets);
+    putU32(m_record, (uint32_t)reps);
+    putF32(m_record, weight);
+    putU32(m_record, (uint32_t)restTime);
+    putString(m_record, name);
+    endRecord();
+}
+
+void WorkoutJournal::addSet(int exercise, int reps, float weight) {
+    beginRecord(JOURNAL_ADD_SET);
+    putU32(m_record, (uint32_t)exercise);
+    putU32(m_record, (uint32_t)reps);
+    putF32(m_record, weight);
+    endRecord();
+}
+
+void WorkoutJournal::setReps(int exercise, int set, int reps) {
+    beginRecord(JOURNAL_SET_REPS);
+    putU32(m_record, (uint32_t)exercise);
+    putU32(m_record, (uint32_t)set);
+    putU32(m_record, (uint32_t)reps);
+    endRecord();
+}
+
+void WorkoutJournal::completeSet(int exercise, int set) {
+    beginRecord(JOURNAL_COMPLETE_SET);
+    putU32(m_record, (uint32_t)exercise);
+    putU32(m_record, (uint32_t)set);
+    endRecord();
+}
+
+void WorkoutJournal::endWorkout(int64_t endMs) {
+    beginRecord(JOURNAL_END_WORKOUT);
+    putI64(m_record, endMs);
+    endRecord();
+}
+
+bool WorkoutJournal::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) {
+        return m_pending.empty();
+    }
+    
+    uint64_t target = m_appended;
+    uint64_t failures = m_failedCommits;
+    m_flushRequested = true;
+    m_wake.notify_one();
+    m_committed.wait(lock, [this, target, failures] { return m_durable >= target || m_failedCommits != failures; });
+    return m_durable >= target;
+}
+
+JournalStats WorkoutJournal::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void WorkoutJournal::run() {
+    std::vector<uint8_t> batch;
+    std::vector<uint8_t> archive;
+    std::vector<uint8_t> state;
+    if (m_historyStale) {
+        writeHistory();
+    }
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+        if (m_pending.empty()) {
+            break;
+        }
+        
+        // Later records join the group until its window closes or someone
+        // waits; after a failure, until the retry is due
+        Clock::time_point deadline = std::max(m_pendingSince + std::chrono::milliseconds(m_commitWindowMs), m_retryAt);
+        m_wake.wait_until(lock, deadline, [this] { return m_stopping || m_flushRequested; });
+        batch.swap(m_pending);
+        m_pending.clear();
+        uint64_t target = m_appended;
+        Clock::time_point since = m_pendingSince;
+        m_flushRequested = false;
+        
+        // A checkpoint holds the state after the batch, so the batch itself
+        // is not written anywhere else
+        bool compact = m_compactionBytes > 0 && m_logBytes + batch.size() >= m_compactionBytes;
+        size_t archivedNow = 0;
+        if (compact) {
+            archive.clear();
+            state.clear();
+            archivedNow = m_state.finished.size();
+            for (size_t i = 0; i < archivedNow; ++i) {
+                encodeWorkout(m_state.finished[i], archive);
+            }
+            if (m_state.current.active) {
+                encodeWorkout(m_state.current, state);
+            }
+        }
+        lock.unlock();
+        
+        bool ok = false;
+        if (compact) {
+            ok = writeCheckpoint(archive, m_archivedWorkouts + (uint32_t)archivedNow, state);
+            if (!ok) {
+                LOGE("Journal checkpoint failed, staying on the log");
+            }
+        }
+        if (!ok) {
+            ok = appendToLog(batch);
+            compact = false;
+        }
+        
+        lock.lock();
+        if (compact) {
+            // Appends only add to the end, so these are the archived ones
+            m_state.finished.erase(m_state.finished.begin(), m_state.finished.begin() + archivedNow);
+            m_stats.compactions++;
+        }
+        if (ok) {
+            m_durable = target;
+            m_retryAt = Clock::time_point();
+            m_stats.commits++;
+            m_stats.bytes += batch.size();
+            double commitMs = std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+            m_stats.maxCommitMs = commitMs > m_stats.maxCommitMs ? commitMs : m_stats.maxCommitMs;
+        } else if (m_stopping) {
+            // Nobody is left to retry for
+            LOGE("Journal commit failed, dropping %zu bytes on close", batch.size() + m_pending.size());
+            m_stats.errors++;
+            m_pending.clear();
+        } else {
+            // The group goes back in front of anything queued meanwhile
+            LOGE("Journal commit failed, retrying in %d ms", COMMIT_RETRY_MS);
+            m_stats.errors++;
+            m_failedCommits++;
+            batch.insert(batch.end(), m_pending.begin(), m_pending.end());
+            batch.swap(m_pending);
+            m_pendingSince = since;
+            m_retryAt = Clock::now() + std::chrono::milliseconds(COMMIT_RETRY_MS);
+        }
+        m_committed.notify_all();
+        batch.clear();
+        
+        // Off the lock and after the waiters are released: only readers of
+        // the history wait for this
+        if (compact && archivedNow > 0) {
+            lock.unlock();
+            writeHistory();
+            lock.lock();
+        }
+    }
+}
+
+bool WorkoutJournal::appendToLog(const std::vector<uint8_t>& batch) {
+    // No log after a checkpoint whose new log failed to start: records must
+    // not go to the old one, which recovery ignores
+    if (m_logFd < 0 && !startLog(m_generation)) {
+        return false;
+    }
+    // Whatever a failed attempt left behind would stop replay before the
+    // records that follow it
+    if (m_logDirty) {
+        if (ftruncate(m_logFd, (off_t)(sizeof(JournalFileHeader) + m_logBytes)) != 0) {
+            return false;
+        }
+        m_logDirty = false;
+    }
+    if (!writeAll(m_logFd, batch.data(), batch.size()) || fdatasync(m_logFd) != 0) {
+        m_logDirty = true;
+        return false;
+    }
+    m_logBytes += batch.size();
+    return true;
+}
+
+void WorkoutJournal::writeHistory() {
+    std::vector<JournalWorkout> workouts;
+    std::vector<uint8_t> image;
+    workouts.reserve(m_archivedWorkouts);
+    bool ok = readArchive(m_directory, [&workouts](const JournalWorkout& workout) { workouts.push_back(workout); }) &&
+              HistoryFile::buildImage(workouts, image) && replaceFile(m_directory, getHistoryPath(m_directory), image);
+    if (!ok) {
+        LOGE("Cannot write workout history");
+    }
+    m_historyStale = !ok;
+}
+
+bool WorkoutJournal::writeCheckpoint(const std::vector<uint8_t>& archive, uint32_t archivedWorkouts,
+                                     const std::vector<uint8_t>& state) {
+    // Archive first: until the checkpoint names its new length, the appended
+    // bytes are ignored
+    uint64_t archiveBytes = m_archiveBytes + archive.size();
+    if (!archive.empty()) {
+        off_t offset = (off_t)(sizeof(JournalFileHeader) + m_archiveBytes);
+        bool ok = ftruncate(m_archiveFd, offset) == 0 && lseek(m_archiveFd, offset, SEEK_SET) == offset &&
+                  writeAll(m_archiveFd, archive.data(), archive.size()) && fdatasync(m_archiveFd) == 0;
+        if (!ok) {
+            return false;
+        }
+    }
+    
+    JournalCheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = JOURNAL_CHECKPOINT_MAGIC;
+    header.version = JOURNAL_VERSION;
+    header.generation = m_generation + 1;
+    header.archivedWorkouts = archivedWorkouts;
+    header.archiveBytes = archiveBytes;
+    header.stateLength = (uint32_t)state.size();
+    header.stateCrc = crc32(state.data(), state.size());
+    std::vector<uint8_t> file;
+    putBytes(file, &header, sizeof(header));
+    putBytes(file, state.data(), state.size());
+    if (!replaceFile(m_directory, getPath(CHECKPOINT_FILE), file)) {
+        return false;
+    }
+    
+    // Committed: the old log is superseded even if the new one fails to
+    // start. Until one does, commits fail instead of going to the old log.
+    m_generation = header.generation;
+    m_archivedWorkouts = archivedWorkouts;
+    m_archiveBytes = archiveBytes;
+    if (!startLog(m_generation)) {
+        LOGE("Cannot start journal log after checkpoint");
+        ::close(m_logFd);
+        m_logFd = -1;
+    }
+    return true;
+}
+
+std::string WorkoutJournal::getHistoryPath(const std::string& directory) {
+    return directory + "/" + HISTORY_FILE;
+}
+
+bool WorkoutJournal::readArchive(const std::string& directory,
+                                 const std::function<void(const JournalWorkout&)>& visit) {
+    JournalCheckpointHeader checkpoint;
+    std::vector<uint8_t> data;
+    if (!readCheckpoint(directory + "/" + CHECKPOINT_FILE, checkpoint, data)) {
+        // Never checkpointed: nothing archived yet
+        return ::access((directory + "/" + CHECKPOINT_FILE).c_str(), F_OK) != 0;
+    }
+    if (!readFile(directory + "/" + ARCHIVE_FILE, data) ||
+        data.size() < sizeof(JournalFileHeader) + checkpoint.archiveBytes) {
+        return false;
+    }
+    
+    std::vector<JournalWorkout> finished;
+    JournalWorkout current;
+    size_t records = 0;
+    size_t intact = replayRecords(data.data() + sizeof(JournalFileHeader), (size_t)checkpoint.archiveBytes,
+                                  finished, current, records);
+    for (size_t i = 0; i < finished.size(); ++i) {
+        visit(finished[i]);
+    }
+    return intact == checkpoint.archiveBytes;
+}
@@ -0,0 +1,206 @@
+#ifndef WORKOUT_JOURNAL_H
+#define WORKOUT_JOURNAL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Write-ahead log of workout edits. Every change is appended as a typed
+// record to journal.log:
+//
+//   JournalFileHeader
+//   { u32 payloadLength, u32 crc32(type + payload), u8 type, payload }...
+//
+// Records are queued in memory and committed by a background thread in
+// groups: the first record of a group waits at most the commit window before
+// one write() and fdatasync() make the whole group durable. A group that fails
+// to commit is cut from the log again and stays queued for a retry. Recovery
+// replays the log and cuts it at the first torn or corrupt record.
+//
+// Once the log outgrows the compaction threshold, a checkpoint replaces it:
+// finished workouts move to the history.dat archive as plain records, the
+// workout in progress is written compactly to journal.chk, and a fresh log
+// starts. Startup reads only the checkpoint and the short log; the archive is
+// replayed only when the checkpoint is damaged or lost. The checkpoint and log
+// are then renamed to *.bad and the journal restarts from the archive's whole
+// workouts. After each checkpoint the commit thread rewrites history.wth, the
+// archive in the columnar form readers map directly (HistoryFile.h).
+//
+// Payload values are little-endian; strings are a u32 length and the bytes.
+enum JournalRecordType {
+    JOURNAL_START_WORKOUT = 1,  // i64 start ms since epoch, string name
+    JOURNAL_ADD_EXERCISE,       // u32 sets, u32 reps, f32 weight, u32 rest seconds, string name
+    JOURNAL_ADD_SET,            // u32 exercise, u32 reps, f32 weight
+    JOURNAL_SET_REPS,           // u32 exercise, u32 set, u32 reps
+    JOURNAL_COMPLETE_SET,       // u32 exercise, u32 set
+    JOURNAL_END_WORKOUT         // i64 end ms since epoch
+};
+
+static const uint32_t JOURNAL_LOG_MAGIC = 0x4C4A5457;         // "WTJL"
+static const uint32_t JOURNAL_CHECKPOINT_MAGIC = 0x4B434A57;  // "WJCK"
+static const uint32_t JOURNAL_ARCHIVE_MAGIC = 0x52414A57;     // "WJAR"
+static const uint32_t JOURNAL_VERSION = 1;
+
+// Log and archive files start with this
+struct JournalFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t generation;        // log: the checkpoint it continues; archive: 0
+    uint32_t reserved;
+};
+
+// journal.chk, followed by stateLength bytes of records rebuilding the
+// workout in progress. Replaced atomically by rename.
+struct JournalCheckpointHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t generation;        // bumped by every checkpoint
+    uint32_t archivedWorkouts;
+    uint64_t archiveBytes;      // committed length of history.dat
+    uint32_t stateLength;
+    uint32_t stateCrc;
+};
+
+// Workout as the journal knows it: exercises by name, so records stay valid
+// whatever ids the exercise catalog hands out next time
+struct JournalSet {
+    int reps;
+    float weight;
+    bool completed;
+};
+
+struct JournalExercise {
+    std::string name;
+    int defaultReps;
+    float defaultWeight;
+    int restTime;
+    std::vector<JournalSet> sets;
+};
+
+struct JournalWorkout {
+    std::string name;
+    int64_t startMs;
+    int64_t endMs;
+    bool active;
+    std::vector<JournalExercise> exercises;
+    
+    JournalWorkout() : startMs(0), endMs(0), active(false) {}
+};
+
+struct JournalRecovery {
+    uint32_t archivedWorkouts;              // in history.dat, not loaded
+    std::vector<JournalWorkout> finished;   // ended since the last checkpoint, oldest first
+    JournalWorkout current;                 // active when a workout was in progress
+    size_t recordsReplayed;
+    size_t tornBytes;                       // cut from the end of the log
+    
+    JournalRecovery() : archivedWorkouts(0), recordsReplayed(0), tornBytes(0) {}
+};
+
+struct JournalStats {
+    uint64_t records;
+    uint64_t commits;           // fdatasync calls for groups
+    uint64_t bytes;
+    uint64_t compactions;
+    double maxCommitMs;         // first record queued to its group being durable
+    uint64_t errors;
+    
+    JournalStats() : records(0), commits(0), bytes(0), compactions(0), maxCommitMs(0.0), errors(0) {}
+};
+
+class WorkoutJournal {
+public:
+    WorkoutJournal();
+    ~WorkoutJournal();
+    
+    WorkoutJournal(const WorkoutJournal&) = delete;
+    WorkoutJournal& operator=(const WorkoutJournal&) = delete;
+    
+    // Creates the directory if needed, recovers its state and starts the
+    // commit thread
+    bool open(const std::string& directory, JournalRecovery& recovery);
+    // Commits everything still queued and stops the commit thread
+    void close();
+    bool isOpen() const { return m_archiveFd >= 0; }
+    
+    // Take effect before open()
+    void setCommitWindowMs(int windowMs) { m_commitWindowMs = windowMs; }
+    // 0 never compacts
+    void setCompactionBytes(size_t bytes) { m_compactionBytes = bytes; }
+    
+    void startWorkout(const std::string& name, int64_t startMs);
+    void addExercise(const std::string& name, int sets, int reps, float weight, int restTime);
+    void addSet(int exercise, int reps, float weight);
+    void setReps(int exercise, int set, int reps);
+    void completeSet(int exercise, int set);
+    void endWorkout(int64_t endMs);
+    
+    // Returns once everything appended so far is on disk, or false once a
+    // commit attempt for it failed; the records stay queued either way
+    bool flush();
+    JournalStats getStats() const;
+    
+    // Every archived workout, oldest first
+    static bool readArchive(const std::string& directory, const std::function<void(const JournalWorkout&)>& visit);
+    // Columnar copy of the archive, for HistoryFile
+    static std::string getHistoryPath(const std::string& directory);
+    
+private:
+    typedef std::chrono::steady_clock Clock;
+    
+    // What the files hold once everything queued is committed, kept so a
+    // checkpoint never needs the tracker
+    struct State {
+        std::vector<JournalWorkout> finished;
+        JournalWorkout current;
+    };
+    
+    std::string m_directory;
+    int m_logFd;
+    int m_archiveFd;
+    int m_commitWindowMs;
+    size_t m_compactionBytes;
+    uint32_t m_generation;
+    uint32_t m_archivedWorkouts;
+    uint64_t m_archiveBytes;
+    size_t m_logBytes;
+    bool m_historyStale;        // history.wth lags the archive
+    bool m_logDirty;            // a failed commit may have left bytes past m_logBytes
+    std::vector<uint8_t> m_record;  // type and payload being appended
+    
+    // Shared with the commit thread
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_committed;
+    State m_state;
+    std::vector<uint8_t> m_pending;
+    Clock::time_point m_pendingSince;
+    uint64_t m_appended;
+    uint64_t m_durable;
+    uint64_t m_failedCommits;
+    Clock::time_point m_retryAt;
+    bool m_flushRequested;
+    bool m_stopping;
+    JournalStats m_stats;
+    std::thread m_thread;
+    
+    // Appends come from one thread, which builds each record in m_record
+    void beginRecord(JournalRecordType type);
+    void endRecord();
+    
+    void run();
+    bool appendToLog(const std::vector<uint8_t>& batch);
+    bool writeCheckpoint(const std::vector<uint8_t>& archive, uint32_t archivedWorkouts,
+                         const std::vector<uint8_t>& state);
+    bool startLog(uint32_t generation);
+    void writeHistory();
+    std::string getPath(const char* name) const;
+};
+
+#endif // WORKOUT_JOURNAL_H
@@ -1,117 +1,355 @@
 #include "WorkoutTracker.h"
 #include "Renderer.h"
 #include "TextRenderer.h"
-#include "Button.h"
+#include "WidgetStore.h"
 #include "Layout.h"
+#include "LayoutTree.h"
+#include "HitTestIndex.h"
+#include "Scroller.h"
+#include "Animator.h"
+#include "ExerciseSearch.h"
+#include "ExerciseCatalog.h"
+#include "WorkoutJournal.h"
+#include "Scene.h"
+#include "FrameProfiler.h"
 #include <android/log.h>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <cmath>
 
 #define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "WorkoutTracker", __VA_ARGS__))
+#define LOGE(...) ((void)__android_log_print(ANDROID_LOG_ERROR, "WorkoutTracker", __VA_ARGS__))
+
+// Debug overlay frame-time graph
+static const float PROFILER_PANEL_X = 10.0f;
+static const float PROFILER_PANEL_Y = 10.0f;
+static const float PROFILER_PANEL_HEIGHT = 300.0f;
+static const float PROFILER_GRAPH_HEIGHT = 200.0f;
+static const int PROFILER_GRAPH_FRAMES = 120;
+static const float PROFILER_GRAPH_MAX_US = 33333.0f; // two 60 Hz frames fill the graph
+static const float PROFILER_BUDGET_US = 16667.0f;
+static const int DEBUG_OVERLAY_QUADS = 1024; // profiler graph and seven lines of counters, with room
+
+// Exercise list: rows laid out and drawn beyond each edge of the viewport, and
+// how far a touch moves before it scrolls instead of tapping
+static const int LIST_OVERSCAN_ROWS = 1;
+static const float LIST_TOUCH_SLOP = 24.0f;
+static const float LIST_ROW_PITCH = Layout::EXERCISE_ITEM_HEIGHT + Layout::SPACING_SMALL;
+static const int LIST_REVEAL_MS = 250;
+// Picker rows: the first matches of the query, as many as fit the modal
+static const int SELECTION_ITEM_SLOTS = 16;
+
+// Catalog until one is loaded: 3 sets of 10 unless noted, Plank in seconds
+static const ExerciseDefaults DEFAULT_EXERCISES[] = {
+    { "Push-ups", 3, 10, 0.0f, 60 }, { "Squats", 3, 15, 0.0f, 60 }, { "Plank", 3, 30, 0.0f, 60 },
+    { "Bench Press", 3, 10, 0.0f, 60 }, { "Deadlift", 3, 10, 0.0f, 60 }, { "Overhead Press", 3, 10, 0.0f, 60 },
+    { "Barbell Row", 3, 10, 0.0f, 60 }, { "Pull-ups", 3, 10, 0.0f, 60 }, { "Chin-ups", 3, 10, 0.0f, 60 },
+    { "Dips", 3, 10, 0.0f, 60 }, { "Lunges", 3, 10, 0.0f, 60 }, { "Romanian Deadlift", 3, 10, 0.0f, 60 },
+    { "Front Squat", 3, 10, 0.0f, 60 }, { "Hip Thrust", 3, 10, 0.0f, 60 }, { "Leg Press", 3, 10, 0.0f, 60 },
+    { "Leg Curl", 3, 10, 0.0f, 60 }, { "Leg Extension", 3, 10, 0.0f, 60 }, { "Calf Raise", 3, 10, 0.0f, 60 },
+    { "Lat Pulldown", 3, 10, 0.0f, 60 }, { "Seated Cable Row", 3, 10, 0.0f, 60 },
+    { "Incline Bench Press", 3, 10, 0.0f, 60 }, { "Dumbbell Fly", 3, 10, 0.0f, 60 },
+    { "Lateral Raise", 3, 10, 0.0f, 60 }, { "Face Pull", 3, 10, 0.0f, 60 }, { "Biceps Curl", 3, 10, 0.0f, 60 },
+    { "Hammer Curl", 3, 10, 0.0f, 60 }, { "Triceps Pushdown", 3, 10, 0.0f, 60 },
+    { "Skull Crusher", 3, 10, 0.0f, 60 }, { "Kettlebell Swing", 3, 10, 0.0f, 60 },
+    { "Goblet Squat", 3, 10, 0.0f, 60 }, { "Burpees", 3, 10, 0.0f, 60 }, { "Mountain Climbers", 3, 10, 0.0f, 60 },
+    { "Crunches", 3, 10, 0.0f, 60 }, { "Hanging Leg Raise", 3, 10, 0.0f, 60 },
+    { "Russian Twist", 3, 10, 0.0f, 60 }, { "Farmer Carry", 3, 10, 0.0f, 60 },
+};
+
+// Animation keys: the kind above the 32 bits of the widget it drives
+static const AnimationKey ANIM_BUTTON_HIGHLIGHT = 1ull << 32;
+static const AnimationKey ANIM_LIST_SCROLL = 2ull << 32;
+
+// Touch target ids: what was hit in the high bits, the card slot or picker
+// item index in the low 16
+enum HitKind {
+    HIT_START_BUTTON = 1,
+    HIT_HISTORY_BUTTON,
+    HIT_CHOOSE_BUTTON,
+    HIT_END_BUTTON,
+    HIT_LIST,
+    HIT_CARD,
+    HIT_CARD_ADD_SET,
+    HIT_CARD_REPS_UP,
+    HIT_CARD_REPS_DOWN,
+    HIT_SELECTION_BACKDROP,
+    HIT_SELECTION_MODAL,
+    HIT_SELECTION_ITEM,
+    HIT_PROFILER_PANEL
+};
+
+// Stacking of touch targets, bottom to top. The picker's backdrop covers the
+// whole screen, so nothing beneath it can be hit while it is shown.
+enum HitLayer {
+    HIT_LAYER_SCREEN,
+    HIT_LAYER_CONTROL,
+    HIT_LAYER_MODAL_BACKDROP,
+    HIT_LAYER_MODAL,
+    HIT_LAYER_MODAL_CONTROL,
+    HIT_LAYER_DEBUG
+};
+
+static int makeHitId(HitKind kind, int index) {
+    return (int)kind << 16 | index;
+}
+
+// Journal timestamps
+static int64_t toEpochMs(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+static std::chrono::system_clock::time_point fromEpochMs(int64_t ms) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+}
+
+// Recounted volumes are summed in another order
+static bool volumesMatch(double running, double recounted) {
+    return std::fabs(running - recounted) <= 1e-6 * std::max(1.0, std::fabs(recounted));
+}
+
+void Exercise::addSet(const Set& set) {
+    // A completed set appended to completed ones keeps them all completed
+    if (set.completed && m_firstIncomplete == getSetCount()) {
+        m_firstIncomplete++;
+    }
+    if (set.completed) {
+        m_completedSets++;
+        m_volume += (double)set.reps * set.weight;
+    }
+    m_sets.push_back(set);
+}
+
+void Exercise::setReps(int set, int reps) {
+    if (set < 0 || set >= getSetCount()) {
+        return;
+    }
+    Set& target = m_sets[set];
+    if (target.completed) {
+        m_volume += (double)(reps - target.reps) * target.weight;
+    }
+    target.reps = reps;
+}
+
+void Exercise::completeSet(int set) {
+    if (set < 0 || set >= getSetCount() || m_sets[set].completed) {
+        return;
+    }
+    m_sets[set].completed = true;
+    m_completedSets++;
+    m_volume += (double)m_sets[set].reps * m_sets[set].weight;
+    // Sets are never uncompleted, so this only moves forward: amortized O(1)
+    while (m_firstIncomplete < getSetCount() && m_sets[m_firstIncomplete].completed) {
+        m_firstIncomplete++;
+    }
+}
+
+bool Exercise::verifyStats() const {
+    int completed = 0;
+    int firstIncomplete = getSetCount();
+    double volume = 0.0;
+    for (int i = 0; i < getSetCount(); ++i) {
+        if (m_sets[i].completed) {
+            completed++;
+            volume += (double)m_sets[i].reps * m_sets[i].weight;
+        } else if (firstIncomplete == getSetCount()) {
+            firstIncomplete = i;
+        }
+    }
+    return completed == m_completedSets && firstIncomplete == m_firstIncomplete && volumesMatch(m_volume, volume);
+}
+
+void Workout::addExercise(const Exercise& exercise) {
+    m_exercises.push_back(exercise);
+    m_totalSets += exercise.getSetCount();
+    m_completedSets += exercise.getCompletedSets();
+    m_volume += exercise.getVolume();
+}
+
+void Workout::clearExercises() {
+    m_exercises.clear();
+    m_totalSets = 0;
+    m_completedSets = 0;
+    m_volume = 0.0;
+}
+
+void Workout::addSet(int exercise, const Set& set) {
+    if (exercise >= 0 && exercise < getExerciseCount()) {
+        Exercise& target = m_exercises[exercise];
+        int completed = target.getCompletedSets();
+        double volume = target.getVolume();
+        target.addSet(set);
+        m_totalSets++;
+        m_completedSets += target.getCompletedSets() - completed;
+        m_volume += target.getVolume() - volume;
+    }
+}
+
+void Workout::setReps(int exercise, int set, int reps) {
+    if (exercise >= 0 && exercise < getExerciseCount()) {
+        Exercise& target = m_exercises[exercise];
+        double volume = target.getVolume();
+        target.setReps(set, reps);
+        m_volume += target.getVolume() - volume;
+    }
+}
+
+void Workout::completeSet(int exercise, int set) {
+    if (exercise >= 0 && exercise < getExerciseCount()) {
+        Exercise& target = m_exercises[exercise];
+        int completed = target.getCompletedSets();
+        double volume = target.getVolume();
+        target.completeSet(set);
+        m_completedSets += target.getCompletedSets() - completed;
+        m_volume += target.getVolume() - volume;
+    }
+}
+
+int Workout::getDurationSeconds(std::chrono::system_clock::time_point now) const {
+    auto end = isActive ? now : endTime;
+    return (int)std::chrono::duration_cast<std::chrono::seconds>(end - startTime).count();
+}
+
+bool Workout::verifyStats() const {
+    int totalSets = 0;
+    int completedSets = 0;
+    double volume = 0.0;
+    bool ok = true;
+    for (const Exercise& exercise : m_exercises) {
+        ok = exercise.verifyStats() && ok;
+        totalSets += exercise.getSetCount();
+        completedSets += exercise.getCompletedSets();
+        volume += exercise.getVolume();
+    }
+    return ok && totalSets == m_totalSets && completedSets == m_completedSets && volumesMatch(m_volume, volume);
+}
 
 WorkoutTracker::WorkoutTracker()
-    : m_currentExerciseIndex(0)
+    : m_archivedWorkoutCount(0)
+    , m_journal(nullptr)
+    , m_currentExerciseIndex(0)
     , m_currentSetIndex(0)
     , m_screenWidth(0.0f)
     , m_screenHeight(0.0f)
     , m_bottomInset(0.0f)
     , m_textRenderer(nullptr)
-    , m_startButton(nullptr)
-    , m_historyButton(nullptr)
-    , m_endButton(nullptr)
-    , m_chooseExerciseButton(nullptr)
-    , m_addSetButton(nullptr)
-    , m_repsIncrementButton(nullptr)
-    , m_repsDecrementButton(nullptr)
+    , m_widgets(nullptr)
+    , m_startButton(WIDGET_NONE)
+    , m_historyButton(WIDGET_NONE)
+    , m_endButton(WIDGET_NONE)
+    , m_chooseExerciseButton(WIDGET_NONE)
     , m_debugMode(false)
+    , m_verifyStats(false)
     , m_showingExerciseList(false)
+    , m_builtInCatalog(nullptr)
+    , m_catalog(nullptr)
     , m_lastTouchX(0.0f)
     , m_lastTouchY(0.0f)
-    , m_buttonPressTime()
-    , m_lastPressedButton(nullptr)
-    , m_buttonPressPending(false)
+    , m_animator(nullptr)
+    , m_touchButton(WIDGET_NONE)
+    , m_listScroller(nullptr)
+    , m_listTouchActive(false)
+    , m_listTouchStartY(0.0f)
+    , m_listTapTarget(HIT_TEST_NONE)
+    , m_scene(nullptr)
+    , m_mainScreenNode(nullptr)
+    , m_mainButtonsNode(nullptr)
+    , m_workoutScreenNode(nullptr)
+    , m_workoutChromeNode(nullptr)
+    , m_timerNode(nullptr)
+    , m_workoutButtonsNode(nullptr)
+    , m_exerciseListNode(nullptr)
+    , m_selectionListNode(nullptr)
+    , m_debugNode(nullptr)
+    , m_displayedSeconds(-1)
+    , m_layout(nullptr)
+    , m_mainScreenLayout(nullptr)
+    , m_workoutScreenLayout(nullptr)
+    , m_selectionScreenLayout(nullptr)
+    , m_titleLayout(nullptr)
+    , m_startLayout(nullptr)
+    , m_historyLayout(nullptr)
+    , m_headerLayout(nullptr)
+    , m_chooseLayout(nullptr)
+    , m_listLayout(nullptr)
+    , m_endLayout(nullptr)
+    , m_modalLayout(nullptr)
+    , m_searchFieldLayout(nullptr)
+    , m_profilerPanelLayout(nullptr)
+    , m_profiler(nullptr)
 {
     m_currentWorkout.isActive = false;
     m_textRenderer = new TextRenderer();
     
-    m_startButton = new Button();
-    m_startButton->setText("START WORKOUT");
-    m_startButton->setColor(0.2f, 0.6f, 0.3f, 1.0f);
-    m_startButton->setPressedColor(0.3f, 0.7f, 0.4f, 1.0f);
-    m_startButton->setTextScale(8.0f);
-    
-    m_historyButton = new Button();
-    m_historyButton->setText("HISTORY");
-    m_historyButton->setColor(0.4f, 0.4f, 0.4f, 1.0f);
-    m_historyButton->setPressedColor(0.5f, 0.5f, 0.5f, 1.0f);
-    m_historyButton->setTextScale(8.0f);
-    
-    m_endButton = new Button();
-    m_endButton->setText("END WORKOUT");
-    m_endButton->setColor(0.6f, 0.2f, 0.2f, 1.0f);
-    m_endButton->setPressedColor(0.7f, 0.3f, 0.3f, 1.0f);
-    m_endButton->setTextScale(8.0f);
-    
-    m_chooseExerciseButton = new Button();
-    m_chooseExerciseButton->setText("CHOOSE EXERCISE");
-    m_chooseExerciseButton->setColor(0.3f, 0.5f, 0.7f, 1.0f);
-    m_chooseExerciseButton->setPressedColor(0.4f, 0.6f, 0.8f, 1.0f);
-    m_chooseExerciseButton->setTextScale(7.0f);
-    
-    m_addSetButton = new Button();
-    m_addSetButton->setText("Add Set");
-    m_addSetButton->setColor(0.2f, 0.6f, 0.3f, 1.0f);
-    m_addSetButton->setPressedColor(0.3f, 0.7f, 0.4f, 1.0f);
-    m_addSetButton->setTextColor(1.0f, 1.0f, 1.0f, 1.0f);
-    m_addSetButton->setTextScale(4.0f);
-    
-    m_repsIncrementButton = new Button();
-    m_repsIncrementButton->setText(REPS_INCR_BUT_TEXT);
-    m_repsIncrementButton->setColor(0.3f, 0.5f, 0.7f, 1.0f);
-    m_repsIncrementButton->setPressedColor(0.4f, 0.6f, 0.8f, 1.0f);
-    m_repsIncrementButton->setTextColor(1.0f, 1.0f, 1.0f, 1.0f);
-    m_repsIncrementButton->setTextScale(4.0f);
-    
-    m_repsDecrementButton = new Button();
-    m_repsDecrementButton->setText(REPS_DECR_BUT_TEXT);
-    m_repsDecrementButton->setColor(0.5f, 0.3f, 0.3f, 1.0f);
-    m_repsDecrementButton->setPressedColor(0.6f, 0.4f, 0.4f, 1.0f);
-    m_repsDecrementButton->setTextColor(1.0f, 1.0f, 1.0f, 1.0f);
-    m_repsDecrementButton->setTextScale(4.0f);
-    
-    // Populate available exercises
-    m_availableExercises.push_back("Push-ups");
-    m_availableExercises.push_back("Squats");
-    m_availableExercises.push_back("Plank");
-
+    m_builtInCatalog = new ExerciseCatalog();
+    m_builtInCatalog->openDefaults(DEFAULT_EXERCISES, sizeof(DEFAULT_EXERCISES) / sizeof(DEFAULT_EXERCISES[0]));
+    m_catalog = m_builtInCatalog;
+    m_exerciseSearch = new ExerciseSearch();
+    indexCatalog();
+    
+    m_listScroller = new Scroller();
+    m_animator = new Animator();
+    m_widgets = new WidgetStore();
+    m_scene = new Scene();
+    buildScene();
+    
+    m_startButton = m_widgets->create(m_mainButtonsNode);
+    m_widgets->setLabel(m_startButton, "START WORKOUT");
+    m_widgets->setColor(m_startButton, 0.2f, 0.6f, 0.3f, 1.0f);
+    m_widgets->setPressedColor(m_startButton, 0.3f, 0.7f, 0.4f, 1.0f);
+    m_widgets->setTextScale(m_startButton, 8.0f);
+    
+    m_historyButton = m_widgets->create(m_mainButtonsNode);
+    m_widgets->setLabel(m_historyButton, "HISTORY");
+    m_widgets->setColor(m_historyButton, 0.4f, 0.4f, 0.4f, 1.0f);
+    m_widgets->setPressedColor(m_historyButton, 0.5f, 0.5f, 0.5f, 1.0f);
+    m_widgets->setTextScale(m_historyButton, 8.0f);
+    
+    m_chooseExerciseButton = m_widgets->create(m_workoutButtonsNode);
+    m_widgets->setLabel(m_chooseExerciseButton, "CHOOSE EXERCISE");
+    m_widgets->setColor(m_chooseExerciseButton, 0.3f, 0.5f, 0.7f, 1.0f);
+    m_widgets->setPressedColor(m_chooseExerciseButton, 0.4f, 0.6f, 0.8f, 1.0f);
+    m_widgets->setTextScale(m_chooseExerciseButton, 7.0f);
+    
+    m_endButton = m_widgets->create(m_workoutButtonsNode);
+    m_widgets->setLabel(m_endButton, "END WORKOUT");
+    m_widgets->setColor(m_endButton, 0.6f, 0.2f, 0.2f, 1.0f);
+    m_widgets->setPressedColor(m_endButton, 0.7f, 0.3f, 0.3f, 1.0f);
+    m_widgets->setTextScale(m_endButton, 8.0f);
+    
+    m_layout = new LayoutTree();
+    buildLayout();
+    updateSceneVisibility();
+    
     (void)m_debugMode;
 }
 
 WorkoutTracker::~WorkoutTracker() {
-    // Cleanup buttons
-    if (m_startButton) delete m_startButton;
-    if (m_historyButton) delete m_historyButton;
-    if (m_endButton) delete m_endButton;
-    if (m_chooseExerciseButton) delete m_chooseExerciseButton;
-    if (m_addSetButton) delete m_addSetButton;
-    if (m_repsIncrementButton) delete m_repsIncrementButton;
-    if (m_repsDecrementButton) delete m_repsDecrementButton;
+    if (m_scene) delete m_scene;
+    if (m_layout) delete m_layout;
+    if (m_animator) delete m_animator;
+    if (m_exerciseSearch) delete m_exerciseSearch;
+    if (m_builtInCatalog) delete m_builtInCatalog;
+    if (m_listScroller) delete m_listScroller;
+    if (m_widgets) delete m_widgets;
     if (m_textRenderer) delete m_textRenderer;
 }
 
 void WorkoutTracker::update() {
-    // Update workout timer, etc.
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
     
-    // Handle delayed button state reset
-    if (m_buttonPressPending && m_lastPressedButton) {
-        auto now = std::chrono::system_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_buttonPressTime);
-        
-        if (elapsed.count() >= BUT_LIT_DELAY_MS) { // 0.5 seconds
-            m_lastPressedButton->setPressed(false);
-            m_buttonPressPending = false;
-            m_lastPressedButton = nullptr;
-        }
+    // Fading highlights and list transitions invalidate what they change
+    m_animator->update(now);
+    
+    // A fling moves the visible cards; the layout pass repaints the ones that moved
+    if (m_listScroller->update(now)) {
+        m_scene->requestRedraw();
+    }
+    
+    // Only the timer label changes when the clock ticks
+    if (m_currentWorkout.isActive && m_timerNode && getElapsedSeconds() != m_displayedSeconds) {
+        m_timerNode->invalidate();
     }
 }
 
@@ -120,218 +358,494 @@ void WorkoutTracker::render(Renderer* renderer) {
         return;
     }
     
-    m_screenWidth = (float)renderer->getWidth();
-    m_screenHeight = (float)renderer->getHeight();
+    float width = (float)renderer->getWidth();
+    float height = (float)renderer->getHeight();
+    if (width != m_screenWidth || height != m_screenHeight) {
+        m_screenWidth = width;
+        m_screenHeight = height;
+        // Every node's geometry depends on the screen size
+        m_scene->invalidateAll();
+    }
     
     // Initialize text renderer if needed
     if (m_textRenderer && !m_textRenderer->initialize(renderer)) {
         // Text renderer initialization failed, but continue without text
     }
     
-    // Update button positions based on screen size
-    updateButtonLayouts();
+    // Only nodes invalidated since the last frame are laid out again
+    {
+        ProfileScope layoutScope(m_profiler, FrameProfiler::PHASE_LAYOUT);
+        updateLayout();
+    }
+    
+    // The overlay shows live counters, so it is rebuilt on every frame that gets drawn
+    if (m_debugMode && m_debugNode) {
+        m_debugNode->invalidate();
+    }
     
     // Clear screen with dark background
     renderer->clear(0.1f, 0.1f, 0.15f, 1.0f);
     
-    if (m_currentWorkout.isActive) {
-        renderWorkoutScreen(renderer);
-    } else {
-        renderMainScreen(renderer);
+    // Rebuild dirty nodes, replay the rest from their cached geometry
+    m_scene->render(renderer);
+}
+
+bool WorkoutTracker::needsRedraw() const {
+    return m_scene->needsRedraw();
+}
+
+void WorkoutTracker::requestRedraw() {
+    m_scene->requestRedraw();
+}
+
+void WorkoutTracker::invalidateScene() {
+    m_scene->invalidateAll();
+}
+
+const SceneStats& WorkoutTracker::getSceneStats() const {
+    return m_scene->getFrameStats();
+}
+
+const TextRunCacheStats& WorkoutTracker::getTextRunStats() const {
+    return m_textRenderer->getRunCacheStats();
+}
+
+void WorkoutTracker::setProfiler(FrameProfiler* profiler) {
+    m_profiler = profiler;
+    updateSceneVisibility();
+}
+
+void WorkoutTracker::toggleDebugMode() {
+    m_debugMode = !m_debugMode;
+    updateSceneVisibility();
+    LOGI("Debug overlay %s", m_debugMode ? "on" : "off");
+}
+
+void WorkoutTracker::setFontAsset(const FontAsset* asset) {
+    m_textRenderer->setFontAsset(asset);
+    // Cached node geometry references the old atlas and glyph metrics
+    invalidateScene();
+}
+
+void WorkoutTracker::setBottomInset(int inset) {
+    if ((float)inset == m_bottomInset) {
+        return;
     }
     
-    if (m_debugMode) {
-        renderDebugOverlay(renderer);
-    }
+    m_bottomInset = (float)inset;
+    // Moves the End Workout button and shrinks the list; their nodes repaint
+    // when the next layout pass changes their rectangles
+    m_endLayout->setMargin(Layout::MARGIN_LARGE, 0.0f, Layout::MARGIN_LARGE, Layout::MARGIN_LARGE + m_bottomInset);
+    m_scene->requestRedraw();
 }
 
-void WorkoutTracker::updateButtonLayouts() {
-    if (!m_startButton || !m_historyButton || !m_endButton || !m_chooseExerciseButton) return;
+void WorkoutTracker::buildScene() {
+    SceneNode* root = m_scene->getRoot();
     
-    if (!m_currentWorkout.isActive) {
-        // Main screen layout with proper spacing
-        float buttonWidth = m_screenWidth - (Layout::MARGIN_LARGE * 2);
-        float buttonY = Layout::centerY(Layout::BUTTON_HEIGHT_LARGE * 2 + Layout::SPACING_MEDIUM, m_screenHeight);
-        
-        m_startButton->setBounds(Layout::MARGIN_LARGE, buttonY, buttonWidth, Layout::BUTTON_HEIGHT_LARGE);
-        
-        float historyButtonY = buttonY + Layout::BUTTON_HEIGHT_LARGE + Layout::SPACING_MEDIUM;
-        m_historyButton->setBounds(Layout::MARGIN_LARGE, historyButtonY, buttonWidth, Layout::BUTTON_HEIGHT_LARGE);
-    } else {
-        // Workout screen layout - account for bottom navigation bar inset
-        float endButtonY = m_screenHeight - m_bottomInset - Layout::MARGIN_LARGE - Layout::BUTTON_HEIGHT;
-        float buttonWidth = m_screenWidth - (Layout::MARGIN_LARGE * 2);
-        m_endButton->setBounds(Layout::MARGIN_LARGE, endButtonY, buttonWidth, Layout::BUTTON_HEIGHT);
+    // Main screen: title, then its buttons
+    m_mainScreenNode = root->addChild([this](Renderer* r) { renderMainScreen(r); });
+    m_mainButtonsNode = m_mainScreenNode->addChild([this](Renderer* r) {
+        m_widgets->render(r, m_textRenderer, m_mainButtonsNode);
+    });
+    
+    // Workout screen: the exercise list and its cards, clipped to the list,
+    // then the header, timer and buttons
+    m_workoutScreenNode = root->addChild(SceneNode::BuildFunc());
+    m_exerciseListNode = m_workoutScreenNode->addChild([this](Renderer* r) { renderExerciseList(r); });
+    m_workoutChromeNode = m_workoutScreenNode->addChild([this](Renderer* r) { renderWorkoutScreen(r); });
+    m_timerNode = m_workoutScreenNode->addChild([this](Renderer* r) { renderWorkoutTimer(r); });
+    m_workoutButtonsNode = m_workoutScreenNode->addChild([this](Renderer* r) {
+        m_widgets->render(r, m_textRenderer, m_workoutButtonsNode);
+    });
+    
+    // Modal exercise picker and debug overlay on top
+    m_selectionListNode = root->addChild([this](Renderer* r) { renderExerciseSelectionList(r); });
+    m_debugNode = root->addChild([this](Renderer* r) { renderDebugOverlay(r); });
+    // Its counters change length from frame to frame
+    m_debugNode->reserveQuads(DEBUG_OVERLAY_QUADS);
+}
+
+void WorkoutTracker::updateSceneVisibility() {
+    bool active = m_currentWorkout.isActive;
+    m_mainScreenNode->setVisible(!active);
+    m_workoutScreenNode->setVisible(active && !m_showingExerciseList);
+    m_selectionListNode->setVisible(active && m_showingExerciseList);
+    m_debugNode->setVisible(m_debugMode);
+    
+    // The workout screen stays touchable under the picker; its backdrop blocks it
+    m_mainScreenLayout->setHitEnabled(!active);
+    m_workoutScreenLayout->setHitEnabled(active);
+    m_selectionScreenLayout->setHitEnabled(active && m_showingExerciseList);
+    m_profilerPanelLayout->setHitEnabled(m_debugMode && m_profiler);
+}
+
+void WorkoutTracker::syncVisibleRows() {
+    // Rows are placed in the list's content box, offset by the scroll position
+    LayoutRect viewport = m_listLayout->getContentRect();
+    int count = m_currentWorkout.getExerciseCount();
+    m_listScroller->setExtent(count > 0 ? count * LIST_ROW_PITCH - Layout::SPACING_SMALL : 0.0f, viewport.height);
+    float offset = m_listScroller->getOffset();
+    
+    // Enough slots for every row that can touch the viewport, plus overscan;
+    // a new pool size changes which slot shows which row
+    size_t slotCount = (size_t)(viewport.height / LIST_ROW_PITCH) + 2 + 2 * LIST_OVERSCAN_ROWS;
+    if (m_rowSlots.size() < slotCount) {
+        while (m_rowSlots.size() < slotCount) {
+            addRowSlot();
+        }
+        resetRowSlots();
+    }
+    
+    int first = (int)std::floor(offset / LIST_ROW_PITCH) - LIST_OVERSCAN_ROWS;
+    int last = (int)std::floor((offset + viewport.height) / LIST_ROW_PITCH) + LIST_OVERSCAN_ROWS;
+    first = first > 0 ? first : 0;
+    last = last < count - 1 ? last : count - 1;
+    
+    int size = (int)m_rowSlots.size();
+    for (int slot = 0; slot < size; ++slot) {
+        // The row of the visible range that maps onto this slot, if any
+        int row = first + ((slot - first % size) + size) % size;
+        if (row > last) {
+            row = -1;
+        }
         
-        // Position Choose Exercise button below header
-        float chooseButtonY = Layout::HEADER_HEIGHT + Layout::SPACING_MEDIUM;
-        m_chooseExerciseButton->setBounds(Layout::MARGIN_LARGE, chooseButtonY, buttonWidth, Layout::BUTTON_HEIGHT);
+        ExerciseRowSlot& rowSlot = m_rowSlots[slot];
+        if (rowSlot.exerciseIndex != row) {
+            // The slot's buttons belong to the row it showed
+            const WidgetHandle buttons[] = {
+                rowSlot.addSetButton, rowSlot.repsIncrementButton, rowSlot.repsDecrementButton
+            };
+            for (WidgetHandle button : buttons) {
+                m_animator->cancel(ANIM_BUTTON_HIGHLIGHT | button);
+                m_widgets->setHighlight(button, 0.0f);
+            }
+            rowSlot.exerciseIndex = row;
+            rowSlot.node->invalidate();
+            rowSlot.node->setVisible(row >= 0);
+        }
+        if (row >= 0) {
+            rowSlot.layout.card->setMargin(0.0f, row * LIST_ROW_PITCH - offset, 0.0f, 0.0f);
+        }
+    }
+}
+
+void WorkoutTracker::addRowSlot() {
+    int slot = (int)m_rowSlots.size();
+    ExerciseRowSlot rowSlot;
+    rowSlot.node = m_exerciseListNode->addChild([this, slot](Renderer* r) { renderExerciseCard(r, slot); });
+    rowSlot.node->setVisible(false);
+    
+    rowSlot.addSetButton = m_widgets->create(rowSlot.node);
+    m_widgets->setLabel(rowSlot.addSetButton, "Add Set");
+    m_widgets->setColor(rowSlot.addSetButton, 0.2f, 0.6f, 0.3f, 1.0f);
+    m_widgets->setPressedColor(rowSlot.addSetButton, 0.3f, 0.7f, 0.4f, 1.0f);
+    m_widgets->setTextScale(rowSlot.addSetButton, 4.0f);
+    
+    rowSlot.repsIncrementButton = m_widgets->create(rowSlot.node);
+    m_widgets->setLabel(rowSlot.repsIncrementButton, REPS_INCR_BUT_TEXT);
+    m_widgets->setColor(rowSlot.repsIncrementButton, 0.3f, 0.5f, 0.7f, 1.0f);
+    m_widgets->setPressedColor(rowSlot.repsIncrementButton, 0.4f, 0.6f, 0.8f, 1.0f);
+    m_widgets->setTextScale(rowSlot.repsIncrementButton, 4.0f);
+    
+    rowSlot.repsDecrementButton = m_widgets->create(rowSlot.node);
+    m_widgets->setLabel(rowSlot.repsDecrementButton, REPS_DECR_BUT_TEXT);
+    m_widgets->setColor(rowSlot.repsDecrementButton, 0.5f, 0.3f, 0.3f, 1.0f);
+    m_widgets->setPressedColor(rowSlot.repsDecrementButton, 0.6f, 0.4f, 0.4f, 1.0f);
+    m_widgets->setTextScale(rowSlot.repsDecrementButton, 4.0f);
+    
+    rowSlot.layout = addExerciseCardLayout(slot);
+    rowSlot.layout.card->setHitEnabled(false);
+    rowSlot.exerciseIndex = -1;
+    m_rowSlots.push_back(rowSlot);
+}
+
+void WorkoutTracker::resetRowSlots() {
+    // Forces every slot to be bound again, e.g. when the rows show another workout
+    for (ExerciseRowSlot& rowSlot : m_rowSlots) {
+        rowSlot.exerciseIndex = -2;
+    }
+    m_scene->requestRedraw();
+}
+
+void WorkoutTracker::invalidateExerciseCard(int exerciseIndex) {
+    if (exerciseIndex < 0 || m_rowSlots.empty()) {
+        return;
+    }
+    // Off-screen rows have no slot and nothing to repaint
+    ExerciseRowSlot& rowSlot = m_rowSlots[exerciseIndex % m_rowSlots.size()];
+    if (rowSlot.exerciseIndex == exerciseIndex) {
+        rowSlot.node->invalidate();
+    }
+}
+
+static void placeButton(WidgetStore* widgets, WidgetHandle button, const LayoutRect& rect) {
+    widgets->setBounds(button, rect.x, rect.y, rect.width, rect.height);
+}
+
+void WorkoutTracker::buildLayout() {
+    // The root spans the screen; every screen overlays it completely
+    LayoutNode* root = m_layout->getRoot();
+    
+    // Main screen: title bar, buttons centered on the screen
+    m_mainScreenLayout = root->addChild();
+    m_titleLayout = m_mainScreenLayout->addChild();
+    m_titleLayout->setMargin(Layout::MARGIN_SMALL, Layout::MARGIN_MEDIUM, Layout::MARGIN_SMALL, 0.0f);
+    m_titleLayout->setHeight(LAYOUT_SIZE_FIXED, Layout::TITLE_HEIGHT);
+    m_titleLayout->setOnChanged([this](const LayoutRect&) { m_mainScreenNode->invalidate(); });
+    
+    LayoutNode* mainButtons = m_mainScreenLayout->addChild();
+    mainButtons->setDirection(LAYOUT_COLUMN);
+    mainButtons->setJustify(LAYOUT_ALIGN_CENTER);
+    mainButtons->setSpacing(Layout::SPACING_MEDIUM);
+    m_startLayout = addButtonLayout(mainButtons, m_startButton, Layout::BUTTON_HEIGHT_LARGE);
+    m_startLayout->setHitTarget(makeHitId(HIT_START_BUTTON, 0), HIT_LAYER_CONTROL);
+    m_historyLayout = addButtonLayout(mainButtons, m_historyButton, Layout::BUTTON_HEIGHT_LARGE);
+    m_historyLayout->setHitTarget(makeHitId(HIT_HISTORY_BUTTON, 0), HIT_LAYER_CONTROL);
+    
+    // Workout screen: header, Choose Exercise, the card list taking the space
+    // left, End Workout above the navigation bar inset
+    m_workoutScreenLayout = root->addChild();
+    m_workoutScreenLayout->setDirection(LAYOUT_COLUMN);
+    m_headerLayout = m_workoutScreenLayout->addChild();
+    m_headerLayout->setHeight(LAYOUT_SIZE_FIXED, Layout::HEADER_HEIGHT);
+    m_headerLayout->setOnChanged([this](const LayoutRect&) {
+        m_workoutChromeNode->invalidate();
+        m_timerNode->invalidate();
+    });
+    
+    m_chooseLayout = addButtonLayout(m_workoutScreenLayout, m_chooseExerciseButton, Layout::BUTTON_HEIGHT);
+    m_chooseLayout->setMargin(Layout::MARGIN_LARGE, Layout::SPACING_MEDIUM, Layout::MARGIN_LARGE, 0.0f);
+    m_chooseLayout->setHitTarget(makeHitId(HIT_CHOOSE_BUTTON, 0), HIT_LAYER_CONTROL);
+    
+    // Card slots overlay the list, each placed at its row by syncVisibleRows
+    m_listLayout = m_workoutScreenLayout->addChild();
+    m_listLayout->setMargin(Layout::MARGIN_SMALL, Layout::SPACING_SMALL, Layout::MARGIN_SMALL, Layout::SPACING_MEDIUM);
+    m_listLayout->setPadding(Layout::MARGIN_SMALL, Layout::PADDING_SMALL, Layout::MARGIN_SMALL, Layout::PADDING_SMALL);
+    m_listLayout->setHitTarget(makeHitId(HIT_LIST, 0), HIT_LAYER_SCREEN);
+    m_listLayout->setOnChanged([this](const LayoutRect& rect) {
+        m_exerciseListNode->invalidate();
+        // Cards scrolled past the list's edges are cut off, and dropped
+        // without drawing once entirely outside
+        m_exerciseListNode->setClipRect(rect.x, rect.y, rect.width, rect.height);
+    });
+    
+    m_endLayout = addButtonLayout(m_workoutScreenLayout, m_endButton, Layout::BUTTON_HEIGHT);
+    m_endLayout->setMargin(Layout::MARGIN_LARGE, 0.0f, Layout::MARGIN_LARGE, Layout::MARGIN_LARGE + m_bottomInset);
+    m_endLayout->setHitTarget(makeHitId(HIT_END_BUTTON, 0), HIT_LAYER_CONTROL);
+    
+    // Exercise picker: vertically centered modal listing the exercises below its title
+    m_selectionScreenLayout = root->addChild();
+    m_selectionScreenLayout->setDirection(LAYOUT_COLUMN);
+    m_selectionScreenLayout->setJustify(LAYOUT_ALIGN_CENTER);
+    m_selectionScreenLayout->setHitTarget(makeHitId(HIT_SELECTION_BACKDROP, 0), HIT_LAYER_MODAL_BACKDROP);
+    m_modalLayout = m_selectionScreenLayout->addChild();
+    m_modalLayout->setDirection(LAYOUT_COLUMN);
+    m_modalLayout->setMargin(Layout::MARGIN_LARGE, 0.0f, Layout::MARGIN_LARGE, 0.0f);
+    m_modalLayout->setHeight(LAYOUT_SIZE_FRACTION, Layout::SELECTION_MODAL_HEIGHT_FRACTION);
+    m_modalLayout->setPadding(Layout::PADDING_MEDIUM, Layout::SELECTION_LIST_TOP, Layout::PADDING_MEDIUM, Layout::PADDING_MEDIUM);
+    m_modalLayout->setSpacing(Layout::SPACING_SMALL);
+    m_modalLayout->setHitTarget(makeHitId(HIT_SELECTION_MODAL, 0), HIT_LAYER_MODAL);
+    m_modalLayout->setOnChanged([this](const LayoutRect&) {
+        updateSelectionItems();
+    });
+    m_searchFieldLayout = m_modalLayout->addChild();
+    m_searchFieldLayout->setHeight(LAYOUT_SIZE_FIXED, Layout::SEARCH_FIELD_HEIGHT);
+    for (int i = 0; i < SELECTION_ITEM_SLOTS; ++i) {
+        LayoutNode* item = m_modalLayout->addChild();
+        item->setHeight(LAYOUT_SIZE_FIXED, Layout::SELECTION_ITEM_HEIGHT);
+        item->setHitTarget(makeHitId(HIT_SELECTION_ITEM, i), HIT_LAYER_MODAL_CONTROL);
+        m_selectionItemLayouts.push_back(item);
+    }
+    
+    // Debug overlay profiler panel
+    m_profilerPanelLayout = root->addChild();
+    m_profilerPanelLayout->setMargin(PROFILER_PANEL_X, PROFILER_PANEL_Y, PROFILER_PANEL_X, 0.0f);
+    m_profilerPanelLayout->setHeight(LAYOUT_SIZE_FIXED, PROFILER_PANEL_HEIGHT);
+    m_profilerPanelLayout->setHitTarget(makeHitId(HIT_PROFILER_PANEL, 0), HIT_LAYER_DEBUG);
+}
+
+LayoutNode* WorkoutTracker::addButtonLayout(LayoutNode* parent, WidgetHandle button, float height) {
+    LayoutNode* node = parent->addChild();
+    node->setMargin(Layout::MARGIN_LARGE, 0.0f, Layout::MARGIN_LARGE, 0.0f);
+    node->setHeight(LAYOUT_SIZE_FIXED, height);
+    // Buttons repaint their node when their bounds change
+    node->setOnChanged([this, button](const LayoutRect& rect) { placeButton(m_widgets, button, rect); });
+    return node;
+}
+
+WorkoutTracker::ExerciseCardLayout WorkoutTracker::addExerciseCardLayout(int slotIndex) {
+    ExerciseCardLayout layout;
+    layout.card = m_listLayout->addChild();
+    layout.card->setHeight(LAYOUT_SIZE_FIXED, Layout::EXERCISE_ITEM_HEIGHT);
+    layout.card->setPadding(Layout::PADDING_MEDIUM, Layout::PADDING_SMALL, Layout::PADDING_MEDIUM, Layout::PADDING_SMALL);
+    layout.card->setOnChanged([this, slotIndex](const LayoutRect&) { m_rowSlots[slotIndex].node->invalidate(); });
+    layout.card->setHitTarget(makeHitId(HIT_CARD, slotIndex), HIT_LAYER_SCREEN);
+    
+    layout.addSet = layout.card->addChild();
+    layout.addSet->setWidth(LAYOUT_SIZE_FIXED, Layout::ADD_SET_BUTTON_WIDTH);
+    layout.addSet->setHeight(LAYOUT_SIZE_FIXED, Layout::ADD_SET_BUTTON_HEIGHT);
+    layout.addSet->setMargin(Layout::CARD_ADD_SET_X, Layout::CARD_ADD_SET_Y, 0.0f, 0.0f);
+    layout.addSet->setHitTarget(makeHitId(HIT_CARD_ADD_SET, slotIndex), HIT_LAYER_CONTROL);
+    layout.addSet->setOnChanged([this, slotIndex](const LayoutRect& rect) {
+        placeButton(m_widgets, m_rowSlots[slotIndex].addSetButton, rect);
+    });
+    
+    LayoutNode* repsButtons = layout.card->addChild();
+    repsButtons->setDirection(LAYOUT_ROW);
+    repsButtons->setWidth(LAYOUT_SIZE_CONTENT);
+    repsButtons->setHeight(LAYOUT_SIZE_CONTENT);
+    repsButtons->setSpacing(Layout::SPACING_SMALL);
+    repsButtons->setMargin(Layout::CARD_REPS_BUTTONS_X, Layout::CARD_REPS_BUTTONS_Y, 0.0f, 0.0f);
+    layout.repsIncrement = repsButtons->addChild();
+    layout.repsIncrement->setHitTarget(makeHitId(HIT_CARD_REPS_UP, slotIndex), HIT_LAYER_CONTROL);
+    layout.repsIncrement->setOnChanged([this, slotIndex](const LayoutRect& rect) {
+        placeButton(m_widgets, m_rowSlots[slotIndex].repsIncrementButton, rect);
+    });
+    layout.repsDecrement = repsButtons->addChild();
+    layout.repsDecrement->setHitTarget(makeHitId(HIT_CARD_REPS_DOWN, slotIndex), HIT_LAYER_CONTROL);
+    layout.repsDecrement->setOnChanged([this, slotIndex](const LayoutRect& rect) {
+        placeButton(m_widgets, m_rowSlots[slotIndex].repsDecrementButton, rect);
+    });
+    for (LayoutNode* button : { layout.repsIncrement, layout.repsDecrement }) {
+        button->setWidth(LAYOUT_SIZE_FIXED, Layout::REPS_BUTTON_SIZE);
+        button->setHeight(LAYOUT_SIZE_FIXED, Layout::REPS_BUTTON_SIZE);
+    }
+    
+    // Set progress along the bottom of the content box
+    layout.progress = layout.card->addChild();
+    layout.progress->setHeight(LAYOUT_SIZE_FIXED, Layout::PROGRESS_BAR_HEIGHT);
+    layout.progress->setAlign(LAYOUT_ALIGN_START, LAYOUT_ALIGN_END);
+    return layout;
+}
+
+void WorkoutTracker::updateLayout() {
+    // The visible rows depend on the list's size, so bind them after a first
+    // pass and place the cards in a second one that visits only those cards
+    m_layout->update(m_screenWidth, m_screenHeight);
+    syncVisibleRows();
+    m_layout->update(m_screenWidth, m_screenHeight);
+    updateRowHitTargets();
+}
+
+void WorkoutTracker::updateRowHitTargets() {
+    // Overscan and partly scrolled out rows reach past the list, over the
+    // buttons around it: cards take touches only while they show in the
+    // list, their buttons only while they lie wholly inside it
+    const LayoutRect& list = m_listLayout->getRect();
+    for (ExerciseRowSlot& rowSlot : m_rowSlots) {
+        const ExerciseCardLayout& layout = rowSlot.layout;
+        layout.card->setHitEnabled(rowSlot.exerciseIndex >= 0 && list.intersects(layout.card->getRect()));
+        for (LayoutNode* button : { layout.addSet, layout.repsIncrement, layout.repsDecrement }) {
+            button->setHitEnabled(list.contains(button->getRect()));
+        }
     }
 }
 
 void WorkoutTracker::renderMainScreen(Renderer* renderer) {
-    // Title with proper margins
-    float titleY = Layout::MARGIN_MEDIUM;
-    float titleWidth = m_screenWidth - (Layout::MARGIN_SMALL * 2);
-    renderer->drawRect(Layout::MARGIN_SMALL, titleY, titleWidth, Layout::TITLE_HEIGHT, 0.2f, 0.4f, 0.6f, 1.0f);
+    // Title bar
+    const LayoutRect& title = m_titleLayout->getRect();
+    renderer->drawRect(title.x, title.y, title.width, title.height, 0.2f, 0.4f, 0.6f, 1.0f);
     if (m_textRenderer) {
         float titleTextWidth = m_textRenderer->getTextWidth("WORKOUT TRACKER", 1.5f);
         float titleTextX = Layout::centerTextX("WORKOUT TRACKER", titleTextWidth, m_screenWidth);
-        m_textRenderer->drawText(titleTextX, titleY + Layout::PADDING_MEDIUM, "WORKOUT TRACKER", 1.0f, 1.0f, 1.0f, 1.0f, 4.5f);
-    }
-    
-    // Render buttons
-    if (m_startButton) {
-        m_startButton->render(renderer, m_textRenderer);
-    }
-    if (m_historyButton) {
-        m_historyButton->render(renderer, m_textRenderer);
+        m_textRenderer->drawText(titleTextX, title.y + Layout::PADDING_MEDIUM, "WORKOUT TRACKER", 1.0f, 1.0f, 1.0f, 1.0f, 4.5f);
     }
 }
 
 void WorkoutTracker::renderWorkoutScreen(Renderer* renderer) {
-    // If showing exercise selection list, render it and return
-    if (m_showingExerciseList) {
-        renderExerciseSelectionList(renderer);
-        return;
-    }
+    // Header with workout name; the timer and buttons are drawn after it
+    const LayoutRect& header = m_headerLayout->getRect();
+    renderer->drawRect(header.x, header.y, header.width, header.height, 0.2f, 0.3f, 0.5f, 1.0f);
     
-    // Header with workout name and timer
-    renderer->drawRect(0.0f, 0.0f, m_screenWidth, Layout::HEADER_HEIGHT, 0.2f, 0.3f, 0.5f, 1.0f);
+    if (m_textRenderer) {
+        // Workout name
+        float nameX = Layout::MARGIN_MEDIUM;
+        m_textRenderer->drawText(nameX, Layout::PADDING_SMALL + 40.0f, m_currentWorkout.name, 0.9f, 0.9f, 0.9f, 1.0f, 6.0f);
+    }
+}
+
+void WorkoutTracker::renderWorkoutTimer(Renderer* renderer) {
+    (void)renderer;
     
     // Timer display
     int elapsed = getElapsedSeconds();
+    m_displayedSeconds = elapsed;
     if (m_textRenderer) {
         float timerTextWidth = m_textRenderer->getTextWidth("00:00", 2.0f);
         float timerX = Layout::centerTextX("00:00", timerTextWidth, m_screenWidth);
         m_textRenderer->drawTime(timerX, Layout::PADDING_LARGE + 90.0f, elapsed, 1.0f, 1.0f, 1.0f, 1.0f, 6.0f);
-        
-        // Workout name
-        float nameX = Layout::MARGIN_MEDIUM;
-        m_textRenderer->drawText(nameX, Layout::PADDING_SMALL + 40.0f, m_currentWorkout.name, 0.9f, 0.9f, 0.9f, 1.0f, 6.0f);
-    }
-    
-    // Choose Exercise button
-    if (m_chooseExerciseButton) {
-        m_chooseExerciseButton->render(renderer, m_textRenderer);
-    }
-    
-    // Exercise list area with proper spacing - account for Choose Exercise button and bottom navigation bar inset
-    float listY = Layout::HEADER_HEIGHT + Layout::SPACING_MEDIUM + Layout::BUTTON_HEIGHT + Layout::SPACING_SMALL;
-    float listHeight = m_screenHeight - listY - m_bottomInset - Layout::BUTTON_HEIGHT - Layout::MARGIN_LARGE - Layout::SPACING_MEDIUM;
-    float listWidth = m_screenWidth - (Layout::MARGIN_SMALL * 2);
-    renderer->drawRect(Layout::MARGIN_SMALL, listY, listWidth, listHeight, 0.15f, 0.15f, 0.2f, 1.0f);
-    
-    // Render exercises
-    renderExerciseList(renderer);
-    
-    // End workout button at bottom
-    if (m_endButton) {
-        m_endButton->render(renderer, m_textRenderer);
     }
 }
 
 void WorkoutTracker::renderExerciseList(Renderer* renderer) {
-    if (m_currentWorkout.exercises.empty()) {
+    // Exercise list area between the Choose Exercise and End Workout buttons
+    const LayoutRect& list = m_listLayout->getRect();
+    renderer->drawRect(list.x, list.y, list.width, list.height, 0.15f, 0.15f, 0.2f, 1.0f);
+    
+    // Exercise cards are child nodes
+    if (m_currentWorkout.getExerciseCount() == 0) {
         if (m_textRenderer) {
             float noExTextWidth = m_textRenderer->getTextWidth("NO EXERCISES", 1.0f);
             float noExTextX = Layout::centerTextX("NO EXERCISES", noExTextWidth, m_screenWidth);
             m_textRenderer->drawText(noExTextX, Layout::centerY(0, m_screenHeight), "NO EXERCISES", 0.7f, 0.7f, 0.7f, 1.0f, 1.0f);
         }
+    }
+}
+
+void WorkoutTracker::renderExerciseCard(Renderer* renderer, int slotIndex) {
+    int exerciseIndex = m_rowSlots[slotIndex].exerciseIndex;
+    if (exerciseIndex < 0 || exerciseIndex >= m_currentWorkout.getExerciseCount()) {
         return;
     }
     
-    // Account for Choose Exercise button position
-    float listStartY = Layout::HEADER_HEIGHT + Layout::SPACING_MEDIUM + Layout::BUTTON_HEIGHT + Layout::SPACING_SMALL + Layout::PADDING_SMALL;
-    float itemX = Layout::MARGIN_MEDIUM;
-    float itemWidth = m_screenWidth - (Layout::MARGIN_MEDIUM * 2);
+    size_t i = (size_t)exerciseIndex;
+    const Exercise& exercise = m_currentWorkout.getExercise((int)i);
+    const ExerciseCardLayout& layout = m_rowSlots[slotIndex].layout;
+    const LayoutRect& card = layout.card->getRect();
+    LayoutRect content = layout.card->getContentRect();
     
-    for (size_t i = 0; i < m_currentWorkout.exercises.size(); ++i) {
-        const Exercise& exercise = m_currentWorkout.exercises[i];
-        float y = listStartY + i * (Layout::EXERCISE_ITEM_HEIGHT + Layout::SPACING_SMALL);
+    // Exercise card with padding
+    float alpha = (i == static_cast<size_t>(m_currentExerciseIndex)) ? 1.0f : 0.7f;
+    renderer->drawRect(card.x, card.y, card.width, card.height, 0.3f, 0.3f, 0.35f, alpha);
+    
+    if (m_textRenderer) {
+        float textX = content.x;
+        float currentY = content.y + 30.0f;
         
-        // Exercise card with padding
-        float alpha = (i == static_cast<size_t>(m_currentExerciseIndex)) ? 1.0f : 0.7f;
-        renderer->drawRect(itemX, y, itemWidth, Layout::EXERCISE_ITEM_HEIGHT, 0.3f, 0.3f, 0.35f, alpha);
+        // Exercise name
+        m_textRenderer->drawText(textX, currentY, m_catalog->getName(exercise.id), 1.0f, 1.0f, 1.0f, alpha, 5.0f);
+        currentY += 50.0f;
         
-        if (m_textRenderer) {
-            float textX = itemX + Layout::PADDING_MEDIUM;
-            float currentY = y + Layout::PADDING_SMALL + 30.0f;
-            
-            // Exercise name
-            m_textRenderer->drawText(textX, currentY, exercise.name, 1.0f, 1.0f, 1.0f, alpha, 5.0f);
-            currentY += 50.0f;
-            
-            // Sets counter and Add Set button
-            int completedSets = getCompletedSetsCount((int)i);
-            int totalSets = (int)exercise.sets.size();
-            std::string setsCounter = std::to_string(completedSets) + "/" + std::to_string(totalSets) + " sets";
-            m_textRenderer->drawText(textX, currentY, setsCounter, 0.9f, 0.9f, 0.9f, alpha, 4.5f);
-            
-            // Add Set button using Button class
-            if (m_addSetButton) {
-                float addSetButtonX = textX + 500.0f;
-                float addSetButtonY = currentY - 65.0f;
-                m_addSetButton->setBounds(addSetButtonX, addSetButtonY, Layout::ADD_SET_BUTTON_WIDTH, Layout::ADD_SET_BUTTON_HEIGHT);
-                m_addSetButton->render(renderer, m_textRenderer);
-            }
-            
-            currentY += 50.0f;
-            
-            // Reps field with increment/decrement buttons
-            // Find first incomplete set or use first set's reps
-            int currentReps = exercise.defaultReps;
-            if (!exercise.sets.empty()) {
-                // Find first incomplete set
-                bool foundIncomplete = false;
-                for (size_t j = 0; j < exercise.sets.size(); ++j) {
-                    if (!exercise.sets[j].completed) {
-                        currentReps = exercise.sets[j].reps;
-                        foundIncomplete = true;
-                        break;
-                    }
-                }
-                if (!foundIncomplete && !exercise.sets.empty()) {
-                    currentReps = exercise.sets[0].reps;
-                }
-            }
-            
-            std::string repsLabel = "Reps: " + std::to_string(currentReps);
-            m_textRenderer->drawText(textX, currentY, repsLabel, 0.9f, 0.9f, 0.9f, alpha, 4.5f);
-            
-            // Increment button (↑) using Button class
-            if (m_repsIncrementButton) {
-                float incButtonX = textX + 250.0f;
-                float incButtonY = currentY - 70.0f;
-                m_repsIncrementButton->setBounds(incButtonX, incButtonY, Layout::REPS_BUTTON_SIZE, Layout::REPS_BUTTON_SIZE);
-                m_repsIncrementButton->render(renderer, m_textRenderer);
-            }
-            
-            // Decrement button (↓) using Button class
-            if (m_repsDecrementButton) {
-                float incButtonX = textX + 250.0f;
-                float incButtonY = currentY - 70.0f;
-                float decButtonX = incButtonX + Layout::REPS_BUTTON_SIZE + Layout::SPACING_SMALL;
-                m_repsDecrementButton->setBounds(decButtonX, incButtonY, Layout::REPS_BUTTON_SIZE, Layout::REPS_BUTTON_SIZE);
-                m_repsDecrementButton->render(renderer, m_textRenderer);
-            }
-            
-            // Weight display if applicable
-            if (exercise.defaultWeight > 0.0f) {
-                currentY += 45.0f;
-                std::string weightStr = std::to_string((int)exercise.defaultWeight) + "kg";
-                m_textRenderer->drawText(textX, currentY, weightStr, 0.7f, 0.7f, 0.7f, alpha, 4.0f);
-            }
-        }
+        // Sets counter and Add Set button
+        GlyphString setsCounter;
+        setsCounter.appendInt(exercise.getCompletedSets()).appendChar('/').appendInt(exercise.getSetCount()).append(" sets");
+        m_textRenderer->drawGlyphs(textX, currentY, setsCounter, 0.9f, 0.9f, 0.9f, alpha, 4.5f);
+        
+        currentY += 50.0f;
+        
+        // Reps field with increment/decrement buttons: the set they change
+        int currentSet = exercise.getCurrentSet();
+        int currentReps = currentSet >= 0 ? exercise.getSets()[currentSet].reps : exercise.defaultReps;
         
-        // Progress indicator (sets completed) with padding
-        float progressX = itemX + Layout::PADDING_MEDIUM;
-        int totalSets = (int)exercise.sets.size();
-        float progressRatio = totalSets > 0 ? (float)getCompletedSetsCount((int)i) / (float)totalSets : 0.0f;
-        float progressWidth = (itemWidth - Layout::PADDING_MEDIUM * 2) * progressRatio;
-        float progressY = y + Layout::EXERCISE_ITEM_HEIGHT - Layout::PADDING_SMALL - 8.0f;
-        renderer->drawRect(progressX, progressY, progressWidth, 8.0f, 0.2f, 0.7f, 0.3f, 1.0f);
+        GlyphString repsLabel;
+        repsLabel.append("Reps: ").appendInt(currentReps);
+        m_textRenderer->drawGlyphs(textX, currentY, repsLabel, 0.9f, 0.9f, 0.9f, alpha, 4.5f);
+        
+        // Weight display if applicable
+        if (exercise.defaultWeight > 0.0f) {
+            currentY += 45.0f;
+            GlyphString weightStr;
+            weightStr.appendWeight(exercise.defaultWeight);
+            m_textRenderer->drawGlyphs(textX, currentY, weightStr, 0.7f, 0.7f, 0.7f, alpha, 4.0f);
+        }
     }
+    
+    // Progress indicator (sets completed) along the bottom of the card
+    const LayoutRect& progress = layout.progress->getRect();
+    renderer->drawRect(progress.x, progress.y, progress.width * exercise.getProgress(), progress.height, 0.2f, 0.7f, 0.3f, 1.0f);
+    
+    // Add Set and the reps buttons: this row's own widgets
+    m_widgets->render(renderer, m_textRenderer, m_rowSlots[slotIndex].node);
 }
 
 void WorkoutTracker::renderExerciseSelectionList(Renderer* renderer) {
@@ -339,288 +853,492 @@ void WorkoutTracker::renderExerciseSelectionList(Renderer* renderer) {
     renderer->drawRect(0.0f, 0.0f, m_screenWidth, m_screenHeight, 0.0f, 0.0f, 0.0f, 0.7f);
     
     // Draw modal background
-    float modalWidth = m_screenWidth - (Layout::MARGIN_LARGE * 2);
-    float modalHeight = m_screenHeight * 0.6f;
-    float modalX = Layout::MARGIN_LARGE;
-    float modalY = Layout::centerY(modalHeight, m_screenHeight);
-    
-    renderer->drawRect(modalX, modalY, modalWidth, modalHeight, 0.2f, 0.2f, 0.25f, 1.0f);
+    const LayoutRect& modal = m_modalLayout->getRect();
+    renderer->drawRect(modal.x, modal.y, modal.width, modal.height, 0.2f, 0.2f, 0.25f, 1.0f);
     
     // Draw title
     if (m_textRenderer) {
-        float titleY = modalY + Layout::PADDING_LARGE;
+        float titleY = modal.y + Layout::PADDING_LARGE;
         float titleTextWidth = m_textRenderer->getTextWidth(SELECT_EXERCISE, 1.2f);
         float titleTextX = Layout::centerTextX(SELECT_EXERCISE, titleTextWidth, m_screenWidth);
         m_textRenderer->drawText(titleTextX - 200.0f, titleY + 10.0f,SELECT_EXERCISE, 1.0f, 1.0f, 1.0f, 1.0f, 6.0f);
     }
     
-    // Draw exercise list
-    float listStartY = modalY + Layout::PADDING_LARGE * 2 + 60.0f;
-    float itemX = modalX + Layout::PADDING_MEDIUM;
-    float itemWidth = modalWidth - (Layout::PADDING_MEDIUM * 2);
-    float itemHeight = 120.0f;
-    float itemSpacing = Layout::SPACING_SMALL;
+    // Search field: the query, or a hint while it is empty, and the match count
+    const LayoutRect& field = m_searchFieldLayout->getRect();
+    renderer->drawRect(field.x, field.y, field.width, field.height, 0.12f, 0.12f, 0.16f, 1.0f);
+    if (m_textRenderer) {
+        float textX = field.x + Layout::PADDING_MEDIUM;
+        float textY = field.y + Layout::PADDING_MEDIUM + 30.0f;
+        const std::string& query = m_exerciseSearch->getQuery();
+        if (query.empty()) {
+            m_textRenderer->drawText(textX, textY, SEARCH_PLACEHOLDER, 0.5f, 0.5f, 0.55f, 1.0f, 4.0f);
+        } else {
+            m_textRenderer->drawText(textX, textY, query, 1.0f, 1.0f, 1.0f, 1.0f, 4.0f);
+        }
+        
+        GlyphString count;
+        count.appendInt((long long)m_exerciseSearch->getResultCount());
+        float countX = field.x + field.width - Layout::PADDING_MEDIUM - m_textRenderer->getTextWidth(count, 4.0f);
+        m_textRenderer->drawGlyphs(countX, textY, count, 0.7f, 0.7f, 0.75f, 1.0f, 4.0f);
+    }
     
-    for (size_t i = 0; i < m_availableExercises.size(); ++i) {
-        float itemY = listStartY + i * (itemHeight + itemSpacing);
+    // Draw the matches that fit
+    float listBottom = modal.y + modal.height - Layout::PADDING_MEDIUM;
+    size_t resultCount = m_exerciseSearch->getResultCount();
+    for (size_t i = 0; i < m_selectionItemLayouts.size() && i < resultCount; ++i) {
+        const LayoutRect& item = m_selectionItemLayouts[i]->getRect();
         
         // Make sure items fit in modal
-        if (itemY + itemHeight > modalY + modalHeight - Layout::PADDING_MEDIUM) {
+        if (item.y + item.height > listBottom) {
             break;
         }
         
         // Draw exercise item background
-        renderer->drawRect(itemX, itemY, itemWidth, itemHeight, 0.35f, 0.35f, 0.4f, 1.0f);
+        renderer->drawRect(item.x, item.y, item.width, item.height, 0.35f, 0.35f, 0.4f, 1.0f);
         
         // Draw exercise name
         if (m_textRenderer) {
-            float textX = itemX + Layout::PADDING_MEDIUM;
-            m_textRenderer->drawText(textX, itemY + Layout::PADDING_MEDIUM + 40.0f, m_availableExercises[i], 1.0f, 1.0f, 1.0f, 1.0f, 5.0f);
+            float textX = item.x + Layout::PADDING_MEDIUM;
+            const char* name = m_catalog->getName((ExerciseId)m_exerciseSearch->getResult(i));
+            m_textRenderer->drawText(textX, item.y + Layout::PADDING_MEDIUM + 40.0f, name, 1.0f, 1.0f, 1.0f, 1.0f, 5.0f);
         }
     }
 }
 
 void WorkoutTracker::showExerciseSelectionList() {
+    // Every opening starts from the whole catalog
+    setSearchQuery(std::string());
     m_showingExerciseList = true;
+    updateSceneVisibility();
+}
+
+void WorkoutTracker::setExerciseCatalog(ExerciseCatalog* catalog) {
+    m_catalog = catalog && catalog->isOpen() ? catalog : m_builtInCatalog;
+    indexCatalog();
+    updateSelectionItems();
+}
+
+void WorkoutTracker::indexCatalog() {
+    // Search entries are the stored ids; interned names are not offered
+    std::vector<std::string> names;
+    names.reserve(m_catalog->getStoredCount());
+    for (ExerciseId id = 0; id < m_catalog->getStoredCount(); ++id) {
+        names.push_back(m_catalog->getName(id));
+    }
+    m_exerciseSearch->setCatalog(names);
+}
+
+void WorkoutTracker::onTextInput(char c) {
+    if (m_showingExerciseList) {
+        setSearchQuery(m_exerciseSearch->getQuery() + c);
+    }
+}
+
+void WorkoutTracker::onTextDelete() {
+    const std::string& query = m_exerciseSearch->getQuery();
+    if (m_showingExerciseList && !query.empty()) {
+        setSearchQuery(query.substr(0, query.size() - 1));
+    }
+}
+
+void WorkoutTracker::setSearchQuery(const std::string& query) {
+    if (query == m_exerciseSearch->getQuery()) {
+        return;
+    }
+    m_exerciseSearch->setQuery(query);
+    updateSelectionItems();
+}
+
+void WorkoutTracker::updateSelectionItems() {
+    // Rows without a match, or that do not fit, are neither drawn nor touchable
+    const LayoutRect& modal = m_modalLayout->getRect();
+    float listBottom = modal.y + modal.height - Layout::PADDING_MEDIUM;
+    size_t resultCount = m_exerciseSearch->getResultCount();
+    for (size_t i = 0; i < m_selectionItemLayouts.size(); ++i) {
+        const LayoutRect& item = m_selectionItemLayouts[i]->getRect();
+        m_selectionItemLayouts[i]->setHitEnabled(i < resultCount && item.y + item.height <= listBottom);
+    }
+    m_selectionListNode->invalidate();
 }
 
 void WorkoutTracker::hideExerciseSelectionList() {
     m_showingExerciseList = false;
+    updateSceneVisibility();
 }
 
 void WorkoutTracker::addSetToExercise(int exerciseIndex) {
-    if (exerciseIndex >= 0 && exerciseIndex < (int)m_currentWorkout.exercises.size()) {
-        Exercise& exercise = m_currentWorkout.exercises[exerciseIndex];
-        exercise.sets.push_back(Set(exercise.defaultReps, exercise.defaultWeight));
-        LOGI("Added set to exercise: %s (total sets: %d)", exercise.name.c_str(), (int)exercise.sets.size());
+    if (exerciseIndex >= 0 && exerciseIndex < m_currentWorkout.getExerciseCount()) {
+        const Exercise& exercise = m_currentWorkout.getExercise(exerciseIndex);
+        m_currentWorkout.addSet(exerciseIndex, Set(exercise.defaultReps, exercise.defaultWeight));
+        if (m_journal) {
+            m_journal->addSet(exerciseIndex, exercise.defaultReps, exercise.defaultWeight);
+        }
+        invalidateExerciseCard(exerciseIndex);
+        verifyStats();
+        LOGI("Added set to exercise: %s (total sets: %d)", m_catalog->getName(exercise.id), exercise.getSetCount());
     }
 }
 
 void WorkoutTracker::markSetCompleted(int exerciseIndex, int setIndex) {
-    if (exerciseIndex >= 0 && exerciseIndex < (int)m_currentWorkout.exercises.size()) {
-        Exercise& exercise = m_currentWorkout.exercises[exerciseIndex];
-        if (setIndex >= 0 && setIndex < (int)exercise.sets.size()) {
-            exercise.sets[setIndex].completed = true;
-            LOGI("Marked set %d as completed for exercise: %s", setIndex + 1, exercise.name.c_str());
+    if (exerciseIndex >= 0 && exerciseIndex < m_currentWorkout.getExerciseCount()) {
+        const Exercise& exercise = m_currentWorkout.getExercise(exerciseIndex);
+        if (setIndex >= 0 && setIndex < exercise.getSetCount()) {
+            m_currentWorkout.completeSet(exerciseIndex, setIndex);
+            if (m_journal) {
+                m_journal->completeSet(exerciseIndex, setIndex);
+            }
+            invalidateExerciseCard(exerciseIndex);
+            verifyStats();
+            LOGI("Marked set %d as completed for exercise: %s", setIndex + 1, m_catalog->getName(exercise.id));
         }
     }
 }
 
-int WorkoutTracker::getCompletedSetsCount(int exerciseIndex) const {
-    if (exerciseIndex >= 0 && exerciseIndex < (int)m_currentWorkout.exercises.size()) {
-        const Exercise& exercise = m_currentWorkout.exercises[exerciseIndex];
-        int completed = 0;
-        for (size_t i = 0; i < exercise.sets.size(); ++i) {
-            if (exercise.sets[i].completed) {
-                completed++;
-            }
-        }
-        return completed;
+void WorkoutTracker::verifyStats() const {
+    if (m_verifyStats && !m_currentWorkout.verifyStats()) {
+        LOGE("Workout statistics differ from a recount: %d/%d sets, volume %.1f", m_currentWorkout.getCompletedSets(),
+             m_currentWorkout.getTotalSets(), m_currentWorkout.getVolume());
     }
-    return 0;
 }
 
 void WorkoutTracker::renderDebugOverlay(Renderer* renderer) {
     if (!m_textRenderer) return;
     
+    renderProfilerGraph(renderer);
+    
+    // Draw batching counters of the previous frame
+    const RenderStats& stats = renderer->getFrameStats();
+    GlyphString statsStr;
+    statsStr.append("Draws: ").appendInt(stats.drawCalls).append(" Verts: ").appendInt(stats.vertices)
+            .append(" Culled: ").appendInt(stats.culledVertices);
+    m_textRenderer->drawGlyphs(10.0f, m_screenHeight - 80.0f, statsStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
+    
+    const SceneStats& sceneStats = m_scene->getFrameStats();
+    GlyphString nodesStr;
+    nodesStr.append("Nodes rebuilt: ").appendInt(sceneStats.nodesRebuilt).append(" drawn: ").appendInt(sceneStats.nodesDrawn);
+    m_textRenderer->drawGlyphs(10.0f, m_screenHeight - 100.0f, nodesStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
+    
+    const TextRunCacheStats& runStats = m_textRenderer->getRunCacheStats();
+    GlyphString runsStr;
+    runsStr.append("Text runs: ").appendInt((long long)runStats.hits).append(" hits ").appendInt((long long)runStats.misses)
+           .append(" misses ").appendInt((long long)runStats.evictions).append(" evicted");
+    m_textRenderer->drawGlyphs(10.0f, m_screenHeight - 120.0f, runsStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
+    
+    const FrameArena& arena = renderer->getFrameArena();
+    GlyphString arenaStr;
+    arenaStr.append("Arena: ").appendInt((long long)(arena.getLastFrameBytes() / 1024)).append(" KB peak ")
+            .appendInt((long long)(arena.getPeakBytes() / 1024)).append(" KB");
+    m_textRenderer->drawGlyphs(10.0f, m_screenHeight - 140.0f, arenaStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
+    
+    const LayoutStats& layoutStats = m_layout->getStats();
+    GlyphString layoutStr;
+    layoutStr.append("Layout: ").appendInt(layoutStats.nodesMeasured).append(" measured ")
+             .appendInt(layoutStats.nodesArranged).append(" arranged");
+    m_textRenderer->drawGlyphs(10.0f, m_screenHeight - 160.0f, layoutStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
+    
     // Draw touch coordinates
-    std::string touchStr = "Touch: " + std::to_string((int)m_lastTouchX) + "," + std::to_string((int)m_lastTouchY);
-    m_textRenderer->drawText(10.0f, m_screenHeight - 60.0f, touchStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
+    GlyphString touchStr;
+    touchStr.append("Touch: ").appendInt((int)m_lastTouchX).appendChar(',').appendInt((int)m_lastTouchY);
+    m_textRenderer->drawGlyphs(10.0f, m_screenHeight - 60.0f, touchStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
     
     // Draw state info
-    std::string stateStr = m_currentWorkout.isActive ? "Active" : "Inactive";
-    m_textRenderer->drawText(10.0f, m_screenHeight - 40.0f, "State: " + stateStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
+    m_textRenderer->drawText(10.0f, m_screenHeight - 40.0f, m_currentWorkout.isActive ? "State: Active" : "State: Inactive",
+                             1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
     
     // Draw exercise count
-    std::string exCountStr = "Exercises: " + std::to_string(m_currentWorkout.exercises.size());
-    m_textRenderer->drawText(10.0f, m_screenHeight - 20.0f, exCountStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
+    GlyphString exCountStr;
+    exCountStr.append("Exercises: ").appendInt((long long)m_currentWorkout.getExerciseCount());
+    m_textRenderer->drawGlyphs(10.0f, m_screenHeight - 20.0f, exCountStr, 1.0f, 1.0f, 0.0f, 1.0f, 0.8f);
+}
+
+void WorkoutTracker::renderProfilerGraph(Renderer* renderer) {
+    if (!m_profiler) return;
+    
+    const LayoutRect& panel = m_profilerPanelLayout->getRect();
+    renderer->drawRect(panel.x, panel.y, panel.width, panel.height, 0.0f, 0.0f, 0.0f, 0.7f);
+    
+    // Percentiles over the whole ring buffer
+    uint32_t p50, p95, p99;
+    m_profiler->getPercentiles(p50, p95, p99);
+    GlyphString percentileStr;
+    percentileStr.append("P50 ").appendInt(p50).append(" P95 ").appendInt(p95).append(" P99 ").appendInt(p99).append(" US");
+    m_textRenderer->drawGlyphs(panel.x + 10.0f, panel.y + 10.0f, percentileStr, 1.0f, 1.0f, 1.0f, 1.0f, 4.0f);
+    m_textRenderer->drawText(panel.x + 10.0f, panel.y + panel.height - 30.0f,
+                             "TAP TO DUMP", 0.7f, 0.7f, 0.7f, 1.0f, 3.0f);
+    
+    // One bar per recent frame, newest on the right, collected in frame
+    // scratch and submitted together
+    float graphBottom = panel.y + 50.0f + PROFILER_GRAPH_HEIGHT;
+    float barWidth = panel.width / (float)PROFILER_GRAPH_FRAMES;
+    int frames = m_profiler->getFrameCount() < PROFILER_GRAPH_FRAMES ? m_profiler->getFrameCount() : PROFILER_GRAPH_FRAMES;
+    BatchVertex* bars = renderer->getFrameArena().allocateArray<BatchVertex>((size_t)frames * 4);
+    int barCount = 0;
+    for (int age = 0; age < frames; ++age) {
+        float totalUs = (float)m_profiler->getFrame(age).totalUs;
+        float barHeight = PROFILER_GRAPH_HEIGHT * (totalUs < PROFILER_GRAPH_MAX_US ? totalUs / PROFILER_GRAPH_MAX_US : 1.0f);
+        if (barHeight <= 0.0f) {
+            continue;
+        }
+        float barX = panel.x + panel.width - (age + 1) * barWidth;
+        if (totalUs <= PROFILER_BUDGET_US) {
+            Renderer::buildRectQuad(bars + barCount * 4, barX, graphBottom - barHeight, barWidth - 1.0f, barHeight, 0.2f, 0.8f, 0.3f, 1.0f);
+        } else {
+            Renderer::buildRectQuad(bars + barCount * 4, barX, graphBottom - barHeight, barWidth - 1.0f, barHeight, 0.9f, 0.3f, 0.2f, 1.0f);
+        }
+        barCount++;
+    }
+    renderer->drawQuads(bars, barCount);
+    
+    // 60 Hz budget line
+    float budgetY = graphBottom - PROFILER_GRAPH_HEIGHT * (PROFILER_BUDGET_US / PROFILER_GRAPH_MAX_US);
+    renderer->drawRect(panel.x, budgetY, panel.width, 2.0f, 1.0f, 1.0f, 0.0f, 1.0f);
 }
 
 void WorkoutTracker::onTouchDown(float x, float y) {
     m_lastTouchX = x;
     m_lastTouchY = y;
-    if (!m_currentWorkout.isActive) {
-        // Main screen - check for start workout button
-        if (m_startButton && m_startButton->containsPoint(x, y)) {
-            m_startButton->setPressed(true);
-            startWorkout("Workout " + std::to_string(m_workoutHistory.size() + 1));
-        } else if (m_historyButton && m_historyButton->containsPoint(x, y)) {
-            m_historyButton->setPressed(true);
+    // Hit tests use the rectangles the next frame would draw
+    updateLayout();
+    
+    int target = m_layout->hitTest(x, y);
+    if (target == HIT_TEST_NONE) {
+        return;
+    }
+    int index = target & 0xFFFF;
+    
+    // On the list a touch is a tap or a drag, decided when it moves or lifts.
+    // Cards scrolled past the list's edges cannot be touched there.
+    int kind = target >> 16;
+    if (kind == HIT_LIST || kind == HIT_CARD || kind == HIT_CARD_ADD_SET ||
+        kind == HIT_CARD_REPS_UP || kind == HIT_CARD_REPS_DOWN) {
+        if (!m_listLayout->getRect().contains(x, y)) {
+            return;
+        }
+        // A touch that stops a fling or a reveal only stops it
+        bool flinging = m_listScroller->isFlinging() || m_animator->isRunning(ANIM_LIST_SCROLL);
+        m_animator->cancel(ANIM_LIST_SCROLL);
+        m_listScroller->beginDrag(y, std::chrono::steady_clock::now());
+        m_listTouchActive = true;
+        m_listTouchStartY = y;
+        m_listTapTarget = flinging || kind == HIT_LIST ? HIT_TEST_NONE : target;
+        if (m_listTapTarget != HIT_TEST_NONE) {
+            m_widgets->setHovered(getListButton(m_listTapTarget), true);
+        }
+        return;
+    }
+    
+    switch (kind) {
+        case HIT_PROFILER_PANEL:
+            // Dumps the frame history instead of reaching the UI below
+            m_profiler->dumpCsvToOutputDirectory();
+            break;
+        case HIT_START_BUTTON:
+            pressButton(m_startButton);
+            startWorkout("Workout " + std::to_string(m_archivedWorkoutCount + m_workoutHistory.size() + 1));
+            break;
+        case HIT_HISTORY_BUTTON:
+            pressButton(m_historyButton);
             // TODO: Show history
+            break;
+        case HIT_END_BUTTON:
+            pressButton(m_endButton);
+            endWorkout();
+            break;
+        case HIT_CHOOSE_BUTTON:
+            pressButton(m_chooseExerciseButton);
+            showExerciseSelectionList();
+            break;
+        case HIT_SELECTION_BACKDROP:
+            // Outside the modal closes it
+            hideExerciseSelectionList();
+            break;
+        case HIT_SELECTION_MODAL:
+            break;
+        case HIT_SELECTION_ITEM: {
+            // Add selected exercise with its catalog defaults
+            addExercise((ExerciseId)m_exerciseSearch->getResult(index));
+            hideExerciseSelectionList();
+            revealExercise(m_currentWorkout.getExerciseCount() - 1);
+            break;
         }
-    } else {
-        // Workout screen
-        if (m_showingExerciseList) {
-            // Exercise selection list is showing
-            // Check if clicking on an exercise in the selection list
-            float modalWidth = m_screenWidth - (Layout::MARGIN_LARGE * 2);
-            float modalHeight = m_screenHeight * 0.6f;
-            float modalX = Layout::MARGIN_LARGE;
-            float modalY = Layout::centerY(modalHeight, m_screenHeight);
-            
-            float listStartY = modalY + Layout::PADDING_LARGE * 2 + 60.0f;
-            float itemX = modalX + Layout::PADDING_MEDIUM;
-            float itemWidth = modalWidth - (Layout::PADDING_MEDIUM * 2);
-            float itemHeight = 120.0f;
-            float itemSpacing = Layout::SPACING_SMALL;
-            
-            for (size_t i = 0; i < m_availableExercises.size(); ++i) {
-                float itemY = listStartY + i * (itemHeight + itemSpacing);
-                
-                // Make sure item is within modal bounds
-                if (itemY + itemHeight > modalY + modalHeight - Layout::PADDING_MEDIUM) {
-                    break;
-                }
-                
-                if (isPointInRect(x, y, itemX, itemY, itemWidth, itemHeight)) {
-                    // Add selected exercise with default values
-                    std::string exerciseName = m_availableExercises[i];
-                    if (exerciseName == "Push-ups") {
-                        addExercise(exerciseName, 3, 10, 0.0f);
-                    } else if (exerciseName == "Squats") {
-                        addExercise(exerciseName, 3, 15, 0.0f);
-                    } else if (exerciseName == "Plank") {
-                        addExercise(exerciseName, 3, 30, 0.0f);
-                    }
-                    hideExerciseSelectionList();
-                    break;
-                }
-            }
-            
-            // Check if clicking outside modal to close
-            if (!isPointInRect(x, y, modalX, modalY, modalWidth, modalHeight)) {
-                hideExerciseSelectionList();
-            }
-        } else {
-            // Normal workout screen
-            if (m_endButton && m_endButton->containsPoint(x, y)) {
-                m_endButton->setPressed(true);
-                endWorkout();
-            } else if (m_chooseExerciseButton && m_chooseExerciseButton->containsPoint(x, y)) {
-                m_chooseExerciseButton->setPressed(true);
-                showExerciseSelectionList();
-            } else {
-                // Check if tapping on an exercise in the workout
-                float listStartY = Layout::HEADER_HEIGHT + Layout::SPACING_MEDIUM + Layout::BUTTON_HEIGHT + Layout::SPACING_SMALL + Layout::PADDING_SMALL;
-                float itemX = Layout::MARGIN_MEDIUM;
-                float itemWidth = m_screenWidth - (Layout::MARGIN_MEDIUM * 2);
-                
-                for (size_t i = 0; i < m_currentWorkout.exercises.size(); ++i) {
-                    float itemY = listStartY + i * (Layout::EXERCISE_ITEM_HEIGHT + Layout::SPACING_SMALL);
-                    
-                    if (isPointInRect(x, y, itemX, itemY, itemWidth, Layout::EXERCISE_ITEM_HEIGHT)) {
-                        Exercise& exercise = m_currentWorkout.exercises[i];
-                        float textX = itemX + Layout::PADDING_MEDIUM;
-                        float currentY = itemY + Layout::PADDING_SMALL + 30.0f; // Start position (matches rendering)
-                        currentY += 50.0f; // After exercise name (now at sets counter position)
-                        
-                        // Check for Add Set button click using Button class
-                        // Button is positioned at sets counter line - 65.0f
-                        if (m_addSetButton) {
-                            float addSetButtonX = textX + 500.0f;
-                            float addSetButtonY = currentY - 65.0f; // Position above sets counter (matches rendering)
-                            m_addSetButton->setBounds(addSetButtonX, addSetButtonY, Layout::ADD_SET_BUTTON_WIDTH, Layout::ADD_SET_BUTTON_HEIGHT);
-                            
-                            if (m_addSetButton->containsPoint(x, y)) {
-                                m_addSetButton->setPressed(true);
-                                m_lastPressedButton = m_addSetButton;
-                                m_buttonPressTime = std::chrono::system_clock::now();
-                                m_buttonPressPending = false; // Will be set on touch up
-                                addSetToExercise((int)i);
-                                break;
-                            }
-                        }
-                        
-                        currentY += 50.0f; // After sets counter (now at reps position)
-                        
-                        // Check for Reps increment button (↑) using Button class
-                        if (m_repsIncrementButton) {
-                            float incButtonX = textX + 250.0f;
-                            float incButtonY = currentY - 70.0f; // Position for reps field (matches rendering)
-                            m_repsIncrementButton->setBounds(incButtonX, incButtonY, Layout::REPS_BUTTON_SIZE, Layout::REPS_BUTTON_SIZE);
-                            
-                            if (m_repsIncrementButton->containsPoint(x, y)) {
-                                m_repsIncrementButton->setPressed(true);
-                                m_lastPressedButton = m_repsIncrementButton;
-                                m_buttonPressTime = std::chrono::system_clock::now();
-                                m_buttonPressPending = false; // Will be set on touch up
-                                // Increment reps for first incomplete set or first set
-                                if (!exercise.sets.empty()) {
-                                    bool found = false;
-                                    for (size_t j = 0; j < exercise.sets.size(); ++j) {
-                                        if (!exercise.sets[j].completed) {
-                                            exercise.sets[j].reps++;
-                                            found = true;
-                                            break;
-                                        }
-                                    }
-                                    if (!found) {
-                                        exercise.sets[0].reps++;
-                                    }
-                                }
-                                break;
-                            }
-                        }
-                        
-                        // Check for Reps decrement button (↓) using Button class
-                        if (m_repsDecrementButton) {
-                            float incButtonX = textX + 250.0f;
-                            float incButtonY = currentY - 70.0f; // Position for reps field (matches rendering)
-                            float decButtonX = incButtonX + Layout::REPS_BUTTON_SIZE + Layout::SPACING_SMALL;
-                            m_repsDecrementButton->setBounds(decButtonX, incButtonY, Layout::REPS_BUTTON_SIZE, Layout::REPS_BUTTON_SIZE);
-                            
-                            if (m_repsDecrementButton->containsPoint(x, y)) {
-                                m_repsDecrementButton->setPressed(true);
-                                m_lastPressedButton = m_repsDecrementButton;
-                                m_buttonPressTime = std::chrono::system_clock::now();
-                                m_buttonPressPending = false; // Will be set on touch up
-                                // Decrement reps for first incomplete set or first set (minimum 1)
-                                if (!exercise.sets.empty()) {
-                                    bool found = false;
-                                    for (size_t j = 0; j < exercise.sets.size(); ++j) {
-                                        if (!exercise.sets[j].completed && exercise.sets[j].reps > 1) {
-                                            exercise.sets[j].reps--;
-                                            found = true;
-                                            break;
-                                        }
-                                    }
-                                    if (!found && exercise.sets[0].reps > 1) {
-                                        exercise.sets[0].reps--;
-                                    }
-                                }
-                                break;
-                            }
-                        }
-                        
-                        // Otherwise, just select the exercise
-                        m_currentExerciseIndex = i;
-                        m_currentSetIndex = 0;
-                        break;
-                    }
-                }
+    }
+}
+
+void WorkoutTracker::handleListTap(int target) {
+    int slot = target & 0xFFFF;
+    int index = m_rowSlots[slot].exerciseIndex;
+    if (index < 0) {
+        return;
+    }
+    
+    switch (target >> 16) {
+        case HIT_CARD_ADD_SET:
+            pressButton(m_rowSlots[slot].addSetButton);
+            addSetToExercise(index);
+            break;
+        case HIT_CARD_REPS_UP:
+            pressButton(m_rowSlots[slot].repsIncrementButton);
+            changeCurrentReps(index, 1);
+            break;
+        case HIT_CARD_REPS_DOWN:
+            pressButton(m_rowSlots[slot].repsDecrementButton);
+            changeCurrentReps(index, -1);
+            break;
+        case HIT_CARD:
+            // Select the exercise
+            if (index != m_currentExerciseIndex) {
+                invalidateExerciseCard(m_currentExerciseIndex);
+                invalidateExerciseCard(index);
             }
+            m_currentExerciseIndex = index;
+            m_currentSetIndex = 0;
+            break;
+    }
+}
+
+void WorkoutTracker::pressButton(WidgetHandle button) {
+    // Lights at once and stays lit while the touch is down; buttons pressed
+    // before keep fading on their own
+    if (m_touchButton != WIDGET_NONE && m_touchButton != button) {
+        releaseButton(m_touchButton);
+    }
+    m_animator->cancel(ANIM_BUTTON_HIGHLIGHT | button);
+    m_widgets->setHighlight(button, 1.0f);
+    m_touchButton = button;
+}
+
+void WorkoutTracker::releaseButton(WidgetHandle button) {
+    // Stays lit for BUT_LIT_DELAY_MS, then fades out
+    const float lit = 1.0f;
+    const float dark = 0.0f;
+    AnimationTimeline timeline(1, &lit);
+    timeline.hold(BUT_LIT_DELAY_MS).to(&dark, BUT_FADE_MS, EASE_OUT_QUAD);
+    m_animator->start(ANIM_BUTTON_HIGHLIGHT | button, timeline,
+                      [this, button](const float* values) { m_widgets->setHighlight(button, values[0]); },
+                      std::chrono::steady_clock::now());
+}
+
+void WorkoutTracker::revealExercise(int exerciseIndex) {
+    if (exerciseIndex < 0 || m_screenHeight <= 0.0f) {
+        return;
+    }
+    
+    // Scrolls just far enough for the whole card to show; the layout pass
+    // brings the list's extent up to date first
+    updateLayout();
+    float viewportHeight = m_listLayout->getContentRect().height;
+    float rowTop = exerciseIndex * LIST_ROW_PITCH;
+    float rowBottom = rowTop + Layout::EXERCISE_ITEM_HEIGHT;
+    float from = m_listScroller->getOffset();
+    float to = from;
+    if (rowBottom > from + viewportHeight) {
+        to = rowBottom - viewportHeight;
+    }
+    if (rowTop < to) {
+        to = rowTop;
+    }
+    if (to > m_listScroller->getMaxOffset()) {
+        to = m_listScroller->getMaxOffset();
+    }
+    if (to == from) {
+        return;
+    }
+    
+    m_animator->tween(ANIM_LIST_SCROLL, 1, &from, &to, LIST_REVEAL_MS, EASE_OUT_CUBIC,
+                      [this](const float* values) {
+                          m_listScroller->setOffset(values[0]);
+                          m_scene->requestRedraw();
+                      },
+                      std::chrono::steady_clock::now());
+}
+
+WidgetHandle WorkoutTracker::getListButton(int target) const {
+    const ExerciseRowSlot& rowSlot = m_rowSlots[target & 0xFFFF];
+    switch (target >> 16) {
+        case HIT_CARD_ADD_SET:
+            return rowSlot.addSetButton;
+        case HIT_CARD_REPS_UP:
+            return rowSlot.repsIncrementButton;
+        case HIT_CARD_REPS_DOWN:
+            return rowSlot.repsDecrementButton;
+    }
+    return WIDGET_NONE;
+}
+
+void WorkoutTracker::changeCurrentReps(int exerciseIndex, int delta) {
+    // Changes the set the card shows; reps never go below 1
+    const Exercise& exercise = m_currentWorkout.getExercise(exerciseIndex);
+    int set = exercise.getCurrentSet();
+    if (set >= 0 && exercise.getSets()[set].reps + delta >= 1) {
+        int reps = exercise.getSets()[set].reps + delta;
+        m_currentWorkout.setReps(exerciseIndex, set, reps);
+        if (m_journal) {
+            m_journal->setReps(exerciseIndex, set, reps);
         }
+        verifyStats();
     }
+    invalidateExerciseCard(exerciseIndex);
 }
 
 void WorkoutTracker::onTouchUp(float x, float y) {
     // Handle touch up events - initiate delayed button reset
-    (void)x; (void)y;
+    (void)x;
+    
+    if (m_listTouchActive) {
+        m_listTouchActive = false;
+        if (m_listTapTarget != HIT_TEST_NONE) {
+            m_listScroller->cancelDrag();
+            m_widgets->setHovered(getListButton(m_listTapTarget), false);
+            handleListTap(m_listTapTarget);
+            m_listTapTarget = HIT_TEST_NONE;
+        } else {
+            // Keeps scrolling with the release velocity, if fast enough
+            m_listScroller->dragTo(y, std::chrono::steady_clock::now());
+            m_listScroller->endDrag(std::chrono::steady_clock::now());
+            m_scene->requestRedraw();
+        }
+    }
     
-    if (m_lastPressedButton != nullptr) {
-        // Touch released, start the 0.5 second delay timer
-        m_buttonPressTime = std::chrono::system_clock::now();
-        m_buttonPressPending = true;
+    if (m_touchButton != WIDGET_NONE) {
+        releaseButton(m_touchButton);
+        m_touchButton = WIDGET_NONE;
     }
 }
 
 void WorkoutTracker::onTouchMove(float x, float y, float dx, float dy) {
-    // Handle swipe gestures, scrolling, etc.
-    (void)x; (void)y; (void)dx; (void)dy;
+    (void)x; (void)dx; (void)dy;
+    if (!m_listTouchActive) {
+        return;
+    }
+    
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (m_listTapTarget != HIT_TEST_NONE) {
+        if (std::fabs(y - m_listTouchStartY) <= LIST_TOUCH_SLOP) {
+            return;
+        }
+        // Past the slop the touch scrolls, starting from here so the list does not jump
+        m_widgets->setHovered(getListButton(m_listTapTarget), false);
+        m_listTapTarget = HIT_TEST_NONE;
+        m_listScroller->beginDrag(y, now);
+    }
+    if (m_listScroller->dragTo(y, now)) {
+        m_scene->requestRedraw();
+    }
 }
 
 void WorkoutTracker::onTouchCancel() {
-    // Handle touch cancellation
+    if (m_listTapTarget != HIT_TEST_NONE) {
+        m_widgets->setHovered(getListButton(m_listTapTarget), false);
+    }
+    m_listTouchActive = false;
+    m_listTapTarget = HIT_TEST_NONE;
+    m_listScroller->cancelDrag();
+    
+    if (m_touchButton != WIDGET_NONE) {
+        releaseButton(m_touchButton);
+        m_touchButton = WIDGET_NONE;
+    }
 }
 
 void WorkoutTracker::onBackPressed() {
@@ -637,14 +1355,69 @@ void WorkoutTracker::onBackPressed() {
 
 void WorkoutTracker::startWorkout(const std::string& name) {
     m_currentWorkout.name = name;
-    m_currentWorkout.exercises.clear();
+    m_currentWorkout.clearExercises();
     m_currentWorkout.startTime = std::chrono::system_clock::now();
     m_currentWorkout.isActive = true;
+    resetWorkoutScreen();
+    if (m_journal) {
+        m_journal->startWorkout(name, toEpochMs(m_currentWorkout.startTime));
+    }
+    
+    LOGI("Started workout: %s", name.c_str());
+}
+
+void WorkoutTracker::resetWorkoutScreen() {
     m_currentExerciseIndex = 0;
     m_currentSetIndex = 0;
     m_showingExerciseList = false;
     
-    LOGI("Started workout: %s", name.c_str());
+    // New name, new cards, fresh clock
+    m_animator->cancel(ANIM_LIST_SCROLL);
+    m_listScroller->setOffset(0.0f);
+    resetRowSlots();
+    m_workoutChromeNode->invalidate();
+    m_exerciseListNode->invalidate();
+    m_timerNode->invalidate();
+    updateSceneVisibility();
+}
+
+void WorkoutTracker::restoreWorkouts(const JournalRecovery& recovery) {
+    m_archivedWorkoutCount = recovery.archivedWorkouts;
+    m_workoutHistory.clear();
+    for (size_t i = 0; i < recovery.finished.size(); ++i) {
+        m_workoutHistory.push_back(makeWorkout(recovery.finished[i]));
+    }
+    
+    if (recovery.current.active) {
+        m_currentWorkout = makeWorkout(recovery.current);
+        resetWorkoutScreen();
+        verifyStats();
+        LOGI("Resumed workout: %s", m_currentWorkout.name.c_str());
+    }
+}
+
+Workout WorkoutTracker::makeWorkout(const JournalWorkout& recovered) {
+    Workout workout;
+    workout.name = recovered.name;
+    workout.startTime = fromEpochMs(recovered.startMs);
+    workout.endTime = fromEpochMs(recovered.endMs);
+    workout.isActive = recovered.active;
+    for (size_t i = 0; i < recovered.exercises.size(); ++i) {
+        const JournalExercise& source = recovered.exercises[i];
+        Exercise exercise;
+        exercise.id = m_catalog->intern(source.name, (int)source.sets.size(), source.defaultReps,
+                                        source.defaultWeight, source.restTime);
+        exercise.defaultReps = source.defaultReps;
+        exercise.defaultWeight = source.defaultWeight;
+        exercise.restTime = source.restTime;
+        for (size_t j = 0; j < source.sets.size(); ++j) {
+            Set set(source.sets[j].reps, source.sets[j].weight);
+            set.completed = source.sets[j].completed;
+            exercise.addSet(set);
+        }
+        workout.addExercise(exercise);
+    }
+    return workout;
 }
 
 void WorkoutTracker::endWorkout() {
@@ -652,30 +1425,62 @@ void WorkoutTracker::endWorkout() {
         m_currentWorkout.endTime = std::chrono::system_clock::now();
         m_currentWorkout.isActive = false;
         m_workoutHistory.push_back(m_currentWorkout);
+        updateSceneVisibility();
+        if (m_journal) {
+            m_journal->endWorkout(toEpochMs(m_currentWorkout.endTime));
+        }
         LOGI("Ended workout: %s", m_currentWorkout.name.c_str());
     }
 }
 
 void WorkoutTracker::addExercise(const std::string& name, int sets, int reps, float weight) {
+    // Names outside the catalog join it with these values as their defaults
+    addExercise(m_catalog->intern(name, sets, reps, weight, 60), sets, reps, weight);
+}
+
+void WorkoutTracker::addExercise(ExerciseId id) {
+    const ExerciseCatalogEntry* entry = m_catalog->getEntry(id);
+    if (entry) {
+        addExercise(id, entry->defaultSets, entry->defaultReps, entry->defaultWeight);
+    }
+}
+
+void WorkoutTracker::addExercise(ExerciseId id, int sets, int reps, float weight) {
+    const ExerciseCatalogEntry* entry = m_catalog->getEntry(id);
+    if (!entry) {
+        return;
+    }
+    
     Exercise exercise;
-    exercise.name = name;
+    exercise.id = id;
     exercise.defaultReps = reps;
     exercise.defaultWeight = weight;
-    exercise.restTime = 60; // Default 60 seconds rest
+    exercise.restTime = entry->restTime;
     
     // Initialize sets vector with specified number of sets
     for (int i = 0; i < sets; ++i) {
-        exercise.sets.push_back(Set(reps, weight));
+        exercise.addSet(Set(reps, weight));
+    }
+    
+    m_currentWorkout.addExercise(exercise);
+    verifyStats();
+    if (m_journal) {
+        m_journal->addExercise(m_catalog->getName(id), sets, reps, weight, exercise.restTime);
     }
     
-    m_currentWorkout.exercises.push_back(exercise);
-    LOGI("Added exercise: %s with %d sets", name.c_str(), sets);
+    // The list only draws its placeholder text while empty
+    if (m_currentWorkout.getExerciseCount() == 1) {
+        m_exerciseListNode->invalidate();
+    }
+    // The next layout pass gives the new row a card if it is in view
+    m_scene->requestRedraw();
+    LOGI("Added exercise: %s with %d sets", m_catalog->getName(id), sets);
 }
 
 void WorkoutTracker::completeSet(int exerciseIndex) {
-    if (exerciseIndex >= 0 && exerciseIndex < (int)m_currentWorkout.exercises.size()) {
-        // Mark set as complete
-        // This can be expanded to track individual set completion
+    // Completes the first set not done yet
+    if (exerciseIndex >= 0 && exerciseIndex < m_currentWorkout.getExerciseCount()) {
+        markSetCompleted(exerciseIndex, m_currentWorkout.getExercise(exerciseIndex).getFirstIncomplete());
     }
 }
 
@@ -684,13 +1489,29 @@ int WorkoutTracker::getElapsedSeconds() const {
         return 0;
     }
     
-    auto now = std::chrono::system_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::seconds>(
-        now - m_currentWorkout.startTime);
-    return (int)duration.count();
+    return m_currentWorkout.getDurationSeconds(std::chrono::system_clock::now());
 }
 
-bool WorkoutTracker::isPointInRect(float x, float y, float rectX, float rectY, float rectW, float rectH) {
-    return (x >= rectX && x <= rectX + rectW && y >= rectY && y <= rectY + rectH);
+int WorkoutTracker::getMillisUntilNextUpdate() const {
+    // Held highlights sleep until their fade starts, moving values need every frame
+    int next = m_animator->getMillisUntilNextFrame(std::chrono::steady_clock::now());
+    auto now = std::chrono::system_clock::now();
+    
+    // A fling animates on every frame; buffer swaps pace it at the display rate
+    if (m_listScroller->isFlinging()) {
+        return 0;
+    }
+    
+    if (m_currentWorkout.isActive) {
+        // Wake just past the next whole second so the timer shows the new value
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_currentWorkout.startTime);
+        int untilTick = 1000 - (int)(elapsed.count() % 1000) + 1;
+        if (next < 0 || untilTick < next) {
+            next = untilTick;
+        }
+    }
+    
+    return next;
 }
 
+
@@ -4,15 +4,32 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include "WidgetStore.h"
+#include "ExerciseCatalog.h"
 
 #define SELECT_EXERCISE         "SELECT EXERCISE"   // "ВЫБОР УПРАЖНЕНИЯ"
+#define SEARCH_PLACEHOLDER      "TYPE TO SEARCH"
 #define REPS_INCR_BUT_TEXT      "+"  /*"↑"*/
 #define REPS_DECR_BUT_TEXT      "-"  /*"↓"*/
 #define BUT_LIT_DELAY_MS        30
+#define BUT_FADE_MS             120
 
 class Renderer;
 class TextRenderer;
-class Button;
+class Scene;
+class FrameProfiler;
+class FontAsset;
+class SceneNode;
+class LayoutTree;
+class LayoutNode;
+class Scroller;
+class Animator;
+class ExerciseSearch;
+class WorkoutJournal;
+struct JournalRecovery;
+struct JournalWorkout;
+struct SceneStats;
+struct TextRunCacheStats;
 
 struct Set {
     int reps;
@@ -23,22 +40,76 @@ struct Set {
     Set(int r, float w) : reps(r), weight(w), completed(false) {}
 };
 
+// Sets change only through the calls below, which keep the running totals
+// current so render and input read them without scanning the sets
 struct Exercise {
-    std::string name;
-    std::vector<Set> sets;
+    ExerciseId id; // name and defaults in the exercise catalog
     int defaultReps; // default reps for new sets
     float defaultWeight; // default weight for new sets
     int restTime; // in seconds
     
-    Exercise() : defaultReps(0), defaultWeight(0.0f), restTime(60) {}
+    Exercise() : id(NO_EXERCISE), defaultReps(0), defaultWeight(0.0f), restTime(60), m_completedSets(0),
+                 m_firstIncomplete(0), m_volume(0.0) {}
+    
+    const std::vector<Set>& getSets() const { return m_sets; }
+    int getSetCount() const { return (int)m_sets.size(); }
+    int getCompletedSets() const { return m_completedSets; }
+    // getSetCount() once every set is completed
+    int getFirstIncomplete() const { return m_firstIncomplete; }
+    // The set the reps buttons change: the first incomplete one, or the first
+    // once all are done; -1 without sets
+    int getCurrentSet() const {
+        return m_firstIncomplete < getSetCount() ? m_firstIncomplete : (m_sets.empty() ? -1 : 0);
+    }
+    // Reps x weight of the completed sets
+    double getVolume() const { return m_volume; }
+    float getProgress() const { return m_sets.empty() ? 0.0f : (float)m_completedSets / (float)m_sets.size(); }
+    
+    void addSet(const Set& set);
+    void setReps(int set, int reps);
+    void completeSet(int set);
+    // Recounts the totals from the sets; false when any disagrees
+    bool verifyStats() const;
+    
+private:
+    std::vector<Set> m_sets;
+    int m_completedSets;
+    int m_firstIncomplete;
+    double m_volume;
 };
 
+// Workout totals follow the exercises' the same way
 struct Workout {
     std::string name;
-    std::vector<Exercise> exercises;
     std::chrono::system_clock::time_point startTime;
     std::chrono::system_clock::time_point endTime;
     bool isActive;
+    
+    Workout() : isActive(false), m_totalSets(0), m_completedSets(0), m_volume(0.0) {}
+    
+    const std::vector<Exercise>& getExercises() const { return m_exercises; }
+    int getExerciseCount() const { return (int)m_exercises.size(); }
+    const Exercise& getExercise(int index) const { return m_exercises[index]; }
+    void addExercise(const Exercise& exercise);
+    void clearExercises();
+    void addSet(int exercise, const Set& set);
+    void setReps(int exercise, int set, int reps);
+    void completeSet(int exercise, int set);
+    
+    int getTotalSets() const { return m_totalSets; }
+    int getCompletedSets() const { return m_completedSets; }
+    double getVolume() const { return m_volume; }
+    float getProgress() const { return m_totalSets > 0 ? (float)m_completedSets / (float)m_totalSets : 0.0f; }
+    // Start to end, or to now while the workout is active
+    int getDurationSeconds(std::chrono::system_clock::time_point now) const;
+    // Recounts every exercise and the workout totals; false when any disagrees
+    bool verifyStats() const;
+    
+private:
+    std::vector<Exercise> m_exercises;
+    int m_totalSets;
+    int m_completedSets;
+    double m_volume;
 };
 
 class WorkoutTracker {
@@ -49,6 +120,14 @@ public:
     void update();
     void render(Renderer* renderer);
     
+    // Retained scene state: a clean scene needs no new frame at all
+    bool needsRedraw() const;
+    void requestRedraw();
+    // Drops all cached geometry so the next frame rebuilds every node
+    void invalidateScene();
+    const SceneStats& getSceneStats() const;
+    const TextRunCacheStats& getTextRunStats() const;
+    
     // Input handling
     void onTouchDown(float x, float y);
     void onTouchUp(float x, float y);
@@ -60,19 +139,58 @@ public:
     void startWorkout(const std::string& name);
     void endWorkout();
     void addExercise(const std::string& name, int sets, int reps, float weight);
+    void addExercise(ExerciseId id, int sets, int reps, float weight);
+    // With the catalog's default sets, reps and weight
+    void addExercise(ExerciseId id);
     void completeSet(int exerciseIndex);
     
+    // Catalog of exercise names and defaults, replacing the built-in one
+    // before any exercise is added; nullptr goes back to the built-in one.
+    // The catalog must outlive the tracker.
+    void setExerciseCatalog(ExerciseCatalog* catalog);
+    const ExerciseCatalog& getExerciseCatalog() const { return *m_catalog; }
+    
+    // Takes over the workouts a journal recovered: finished ones join the
+    // history, one still in progress becomes the current workout
+    void restoreWorkouts(const JournalRecovery& recovery);
+    // Every change from now on is appended to the journal; nullptr stops
+    // logging. The journal must outlive the tracker.
+    void setJournal(WorkoutJournal* journal) { m_journal = journal; }
+    
+    // Typed text filters the picker while it is open
+    bool isTextInputActive() const { return m_showingExerciseList; }
+    void onTextInput(char c);
+    void onTextDelete();
+    
     // Getters
     bool isWorkoutActive() const { return m_currentWorkout.isActive; }
     const Workout& getCurrentWorkout() const { return m_currentWorkout; }
     int getElapsedSeconds() const;
     
+    // Milliseconds until update() has visible work to do (clock tick, button
+    // release); -1 when nothing is pending
+    int getMillisUntilNextUpdate() const;
+    
+    // Recounts the workout statistics after every change and logs any
+    // counter that drifted; for debug builds
+    void setVerifyStats(bool enabled) { m_verifyStats = enabled; }
+    
+    // Debug overlay with frame profiler graph
+    void setProfiler(FrameProfiler* profiler);
+    void toggleDebugMode();
+    
+    // Baked distance-field UI font; nullptr keeps the built-in bitmap font
+    void setFontAsset(const FontAsset* asset);
+    
     // Bottom inset setter for navigation bar
-    void setBottomInset(int inset) { m_bottomInset = (float)inset; }
+    void setBottomInset(int inset);
     
 private:
     Workout m_currentWorkout;
     std::vector<Workout> m_workoutHistory;
+    // Finished before m_workoutHistory, kept only in the journal's archive
+    uint32_t m_archivedWorkoutCount;
+    WorkoutJournal* m_journal;
     
     int m_currentExerciseIndex;
     int m_currentSetIndex;
@@ -81,34 +199,130 @@ private:
     float m_screenHeight;
     float m_bottomInset;
     
-    void updateButtonLayouts();
     void renderMainScreen(Renderer* renderer);
     void renderWorkoutScreen(Renderer* renderer);
+    void renderWorkoutTimer(Renderer* renderer);
     void renderExerciseList(Renderer* renderer);
+    void renderExerciseCard(Renderer* renderer, int slotIndex);
     void renderExerciseSelectionList(Renderer* renderer);
     void renderDebugOverlay(Renderer* renderer);
     
+    // Layout tree: rectangles shared by rendering and touch handling
+    struct ExerciseCardLayout {
+        LayoutNode* card;
+        LayoutNode* addSet;
+        LayoutNode* repsIncrement;
+        LayoutNode* repsDecrement;
+        LayoutNode* progress;
+    };
+    void buildLayout();
+    LayoutNode* addButtonLayout(LayoutNode* parent, WidgetHandle button, float height);
+    ExerciseCardLayout addExerciseCardLayout(int slotIndex);
+    void updateLayout();
+    void updateRowHitTargets();
+    
+    // Virtualized exercise list: a pool of card slots, enough to cover the
+    // list viewport plus overscan, each showing row (index % pool size) of the
+    // visible range. Slots that keep their row keep their cached geometry.
+    struct ExerciseRowSlot {
+        SceneNode* node;
+        ExerciseCardLayout layout;
+        WidgetHandle addSetButton;
+        WidgetHandle repsIncrementButton;
+        WidgetHandle repsDecrementButton;
+        int exerciseIndex;  // -1 while unused, -2 until bound again
+    };
+    void syncVisibleRows();
+    void addRowSlot();
+    void resetRowSlots();
+    
+    // Touch handling for the targets found by LayoutTree::hitTest
+    void pressButton(WidgetHandle button);
+    void releaseButton(WidgetHandle button);
+    void changeCurrentReps(int exerciseIndex, int delta);
+    WidgetHandle getListButton(int target) const;
+    void handleListTap(int target);
+    void revealExercise(int exerciseIndex);
+    
+    // Scene graph maintenance
+    void buildScene();
+    void updateSceneVisibility();
+    void invalidateExerciseCard(int exerciseIndex);
+    
+    void resetWorkoutScreen();
+    Workout makeWorkout(const JournalWorkout& recovered);
+    
     void showExerciseSelectionList();
     void hideExerciseSelectionList();
+    void indexCatalog();
+    void setSearchQuery(const std::string& query);
+    void updateSelectionItems();
     
     void addSetToExercise(int exerciseIndex);
     void markSetCompleted(int exerciseIndex, int setIndex);
-    int getCompletedSetsCount(int exerciseIndex) const;
+    void verifyStats() const;
+    
+    void renderProfilerGraph(Renderer* renderer);
     
-    bool isPointInRect(float x, float y, float rectX, float rectY, float rectW, float rectH);
-
     TextRenderer * m_textRenderer;
-    Button * m_startButton, * m_historyButton, * m_endButton, * m_chooseExerciseButton, * m_addSetButton;
-    Button * m_repsIncrementButton, * m_repsDecrementButton;
+    // Every button, the card buttons of each row slot included
+    WidgetStore * m_widgets;
+    WidgetHandle m_startButton, m_historyButton, m_endButton, m_chooseExerciseButton;
     bool m_debugMode;
+    bool m_verifyStats;
     bool m_showingExerciseList;
-    std::vector<std::string> m_availableExercises;
+    // Names of Exercise::id; the built-in catalog until one is loaded
+    ExerciseCatalog* m_builtInCatalog;
+    ExerciseCatalog* m_catalog;
+    // The catalog's stored entries and the current query's matches
+    ExerciseSearch* m_exerciseSearch;
     double m_lastTouchX, m_lastTouchY;
     
-    // Button press state tracking
-    std::chrono::system_clock::time_point m_buttonPressTime;
-    Button* m_lastPressedButton;
-    bool m_buttonPressPending;
+    // Button highlights and list transitions
+    Animator* m_animator;
+    // Lit by the current touch; fades out once the touch lifts
+    WidgetHandle m_touchButton;
+    
+    // Touch that went down on the exercise list: a tap until it moves past
+    // the touch slop, then a drag of the list
+    Scroller* m_listScroller;
+    bool m_listTouchActive;
+    float m_listTouchStartY;
+    int m_listTapTarget;
+    
+    // Retained scene; nodes are owned by the scene
+    Scene* m_scene;
+    SceneNode* m_mainScreenNode;
+    SceneNode* m_mainButtonsNode;
+    SceneNode* m_workoutScreenNode;
+    SceneNode* m_workoutChromeNode;
+    SceneNode* m_timerNode;
+    SceneNode* m_workoutButtonsNode;
+    SceneNode* m_exerciseListNode;
+    SceneNode* m_selectionListNode;
+    SceneNode* m_debugNode;
+    int m_displayedSeconds;
+    
+    // Layout; nodes are owned by the tree
+    LayoutTree* m_layout;
+    LayoutNode* m_mainScreenLayout;
+    LayoutNode* m_workoutScreenLayout;
+    LayoutNode* m_selectionScreenLayout;
+    LayoutNode* m_titleLayout;
+    LayoutNode* m_startLayout;
+    LayoutNode* m_historyLayout;
+    LayoutNode* m_headerLayout;
+    LayoutNode* m_chooseLayout;
+    LayoutNode* m_listLayout;
+    LayoutNode* m_endLayout;
+    LayoutNode* m_modalLayout;
+    LayoutNode* m_searchFieldLayout;
+    LayoutNode* m_profilerPanelLayout;
+    // Item i shows the query's match i
+    std::vector<LayoutNode*> m_selectionItemLayouts;
+    std::vector<ExerciseRowSlot> m_rowSlots;
+    
+    FrameProfiler* m_profiler;
 };
 
 #endif // WORKOUT_TRACKER_H
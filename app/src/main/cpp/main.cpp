@@ -42,8 +42,11 @@ void android_main(struct android_app* app) {
         int events;
         struct android_poll_source* source;
         
+        // Sleep until the next event or the next scheduled frame, whichever comes first
+        int timeoutMs = workoutApp.getPollTimeoutMs();
+        
         // Process all pending events
-        while (ALooper_pollAll(0, nullptr, &events, (void**)&source) >= 0) {
+        while (ALooper_pollAll(timeoutMs, nullptr, &events, (void**)&source) >= 0) {
             if (source != nullptr) {
                 source->process(app, source);
             }
@@ -54,9 +57,12 @@ void android_main(struct android_app* app) {
                 workoutApp.cleanup();
                 return;
             }
+            
+            // Drain whatever else is queued without blocking again
+            timeoutMs = 0;
         }
         
-        // Update and render
+        // Update, then render only if something is invalid or a deadline passed
         workoutApp.update();
         workoutApp.render();
     }